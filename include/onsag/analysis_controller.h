@@ -4,98 +4,136 @@
 #ifndef ONSAG_ANALYSIS_CONTROLLER_H_
 #define ONSAG_ANALYSIS_CONTROLLER_H_
 
+#include <atomic>
 #include <list>
+#include <map>
+#include <memory>
 #include <vector>
 
+#include "appcommon/widgets/timer.h"
+#include "wx/docview.h"
 #include "wx/wx.h"
 
+#include "onsag/result_cache.h"
 #include "onsag/sag_span.h"
 #include "onsag/sagging_analysis_result.h"
-#include "onsag/span_sagger.h"
+#include "onsag/span_analyzer.h"
+#include "onsag/thread_pool.h"
 
 /// \par OVERVIEW
 ///
-/// This struct is an analysis job, which includes the inputs (that change from
-/// job to job) and the result to calculate.
-struct AnalysisJob {
-  /// \var result
-  ///   The sagging result to calculate.
-  SaggingAnalysisResult* result;
-
-  /// \var temperature
-  ///   The analysis temperature.
-  const double* temperature;
+/// This struct is the set of analysis results for a single span.
+struct SpanResultSet {
+  /// \var results
+  ///   The sagging results, one for each temperature. This is empty if the
+  ///   span did not pass validation.
+  std::vector<SaggingAnalysisResult> results;
+
+  /// \var span
+  ///   A copy of the span that was analyzed.
+  SagSpan span;
+
+  /// \var temperatures
+  ///   The analysis temperatures. The results reference these values.
+  std::vector<double> temperatures;
 };
 
 
 /// \par OVERVIEW
 ///
-/// This class is a worker thread for an analysis.
-///
-/// \par JOBS
-///
-/// This thread can accept multiple jobs to run. Once all of the jobs are
-/// completed, this thread will pause and wait to be joined back into the main
-/// application thread.
-///
-/// \par MESSAGES
-///
-/// This thread logs any error messages from the analysis.
-class AnalysisThread : public wxThread {
- public:
-  /// \brief Constructor.
-  AnalysisThread();
-
-  /// \brief Adds an analysis job to the thread.
-  /// \param[in] job
-  ///   The job.
-  /// This must be done before the Run() method.
-  void AddAnalysisJob(AnalysisJob* job);
-
-  /// \brief Gets the span.
-  /// \return The span.
-  const SagSpan* span() const;
-
-  /// \brief Gets the error messages.
-  /// \return The error messages.
-  const std::list<ErrorMessage>* messages() const;
-
-  /// \brief Gets the sagger.
-  /// \return The sagger.
-  const SpanSagger* sagger() const;
-
-  /// \brief Sets the span.
-  /// \param[in] span
-  ///   The sag span.
-  void set_span(const SagSpan* span);
+/// This struct is a span that is being solved in a background analysis run.
+struct AnalysisRunSpan {
+  /// \var num_jobs
+  ///   The number of jobs for the span.
+  int num_jobs;
+
+  /// \var num_jobs_completed
+  ///   The number of span jobs that are completed or skipped.
+  std::atomic<int> num_jobs_completed;
+
+  /// \var set
+  ///   The result set that is populated by the worker threads.
+  SpanResultSet set;
+
+  /// \var span_doc
+  ///   The document span that the result set belongs to. This is only used to
+  ///   identify the span, and is never accessed by the worker threads.
+  const SagSpan* span_doc;
+};
 
- protected:
-  /// \brief Does an analysis job.
-  /// \param[in] index
-  ///   The job index.
-  void DoAnalysisJob(const int& index);
 
-  /// \brief Begins the thread processing.
-  /// \return The thread exit code.
-  /// This function is called directly after Run().
-  virtual ExitCode Entry();
+/// \par OVERVIEW
+///
+/// This struct is an analysis job, which is a contiguous block of temperatures
+/// within a run span. Long temperature sweeps are split into blocks so the
+/// thread pool overhead is paid once per block instead of once per result.
+struct AnalysisJob {
+  /// \var index_begin
+  ///   The index of the first temperature in the block.
+  int index_begin;
 
-  /// \var jobs_
-  ///   The analysis jobs.
-  std::list<AnalysisJob*> jobs_;
+  /// \var index_end
+  ///   The index past the last temperature in the block.
+  int index_end;
 
-  /// \var span_
-  ///   The sag span to analyze.
-  const SagSpan* span_;
+  /// \var span
+  ///   The run span that the job belongs to.
+  AnalysisRunSpan* span;
+};
 
-  /// \var messages_
-  ///   Error messages encountered during the analysis.
-  mutable std::list<ErrorMessage> messages_;
 
-  /// \var sagger_
-  ///   The sagger that is used in the analysis. This is used solve for the
-  ///   sagging results.
-  SpanSagger sagger_;
+/// \par OVERVIEW
+///
+/// This struct is a single background analysis run. It owns a copy of all the
+/// inputs, so the worker threads never access the document while the user
+/// edits it, and holds the results until they are handed off to the
+/// application thread.
+struct AnalysisRun {
+  /// \var is_cancelled
+  ///   An indicator that tells the worker threads to skip any remaining jobs.
+  std::atomic<bool> is_cancelled;
+
+  /// \var messages
+  ///   The error messages encountered during the run, one list for each worker
+  ///   thread.
+  std::vector<std::list<ErrorMessage>> messages;
+
+  /// \var num_jobs
+  ///   The number of jobs in the run.
+  int num_jobs;
+
+  /// \var num_jobs_completed
+  ///   The number of jobs that are completed or skipped.
+  std::atomic<int> num_jobs_completed;
+
+  /// \var num_solves_parabola
+  ///   The number of catenary solves evaluated by the parabola.
+  std::atomic<int> num_solves_parabola;
+
+  /// \var num_solves_parabola_fallback
+  ///   The number of catenary solves that exceeded the parabola tolerance.
+  std::atomic<int> num_solves_parabola_fallback;
+
+  /// \var spans
+  ///   The spans that are being solved. This is a list so that the job
+  ///   references stay valid.
+  std::list<AnalysisRunSpan> spans;
+
+  /// \var sweep
+  ///   The temperature sweep.
+  TemperatureSweep sweep;
+
+  /// \var timer
+  ///   The timer that measures the run duration.
+  Timer timer;
+
+  /// \var tolerance_parabola
+  ///   The parabola tolerance.
+  double tolerance_parabola;
+
+  /// \var units
+  ///   The unit system.
+  units::UnitSystem units;
 };
 
 
@@ -103,77 +141,213 @@ class AnalysisThread : public wxThread {
 ///
 /// This class handles the sagging analysis and generates cached results.
 ///
+/// \par TEMPERATURE SWEEP
+///
+/// The analysis temperatures are generated from the temperature sweep in the
+/// application config. If the sweep or the parabola tolerance is changed, all
+/// of the cached result sets are cleared when the next analysis is run. The
+/// number of parabola solves and fallbacks is logged for each run.
+///
 /// \par CACHED RESULTS
 ///
-/// This class stores all of the analysis results. The results do not update
-/// automatically. Results can only be generated by using the RunAnalysis()
-/// method. This is done because:
-///  - a span is not always selected
-///  - results can be computationally expensive and need to be calculated only
-///    as needed
+/// This class stores a result set for every span in the document. The results
+/// do not update automatically. Results can only be generated by using the
+/// RunAnalysis() method, which solves every document span that does not
+/// already have a cached result set. Once solved, a result set is kept until
+/// it is cleared (ex: the span is modified), so activating a different span
+/// does not require any calculations.
+///
+/// Every solved sagging result is also kept in a memory-bounded result cache
+/// that is keyed by the sagging inputs. When a span is modified back to a
+/// previous state (ex: an undo), the results are pulled from the cache instead
+/// of being solved again.
+///
+/// The results for the activated span are accessed with the Result() and
+/// Results() methods. The results for any other document span can be accessed
+/// with ResultSet().
+///
+/// \par BACKGROUND ANALYSIS
+///
+/// The RunAnalysis() method returns immediately, and the analysis is solved in
+/// the background so the application thread is never blocked. As each span is
+/// completed, its result set is handed off to the application thread and
+/// swapped into the cache. An analysis update hint is posted to the document
+/// views when the activated span is completed, and again when the run is
+/// completed.
+///
+/// If RunAnalysis() is called again while an analysis is still running (ex:
+/// the user edits a span again), the stale run is cancelled and its remaining
+/// results are discarded. Progress is reported in the status bar.
 ///
 /// MULTI-THREADING
 ///
-/// This class uses worker threads to calculate the results. The number of
-/// threads depends on the available CPUs. A list of analysis jobs are generated
-/// and then split evenly among the available threads. This speeds things up so
-/// the calculations are less of a bottleneck to the main application thread.
-class AnalysisController {
+/// This class uses a pool of worker threads to calculate the results. The
+/// number of threads depends on the available CPUs. The pool is created once
+/// with the controller and is reused for every analysis, so editing a span
+/// does not pay the cost of creating and destroying threads. The span
+/// temperatures are split into blocks of analysis jobs and added to the pool,
+/// and each worker thread solves the jobs with its own span analyzer.
+/// Idle workers steal jobs from busy workers, so a slow span does not hold up
+/// the rest. The activated span jobs are added last, which makes them the
+/// first to be solved.
+class AnalysisController : public wxEvtHandler {
  public:
   /// \brief Constructor.
   AnalysisController();
 
   /// \brief Destructor.
+  /// Any running analysis is cancelled and the worker threads are joined.
   ~AnalysisController();
 
-  /// \brief Clears the results.
+  /// \brief Cancels any running analysis.
+  /// The cached results are not modified.
+  void CancelAnalysis();
+
+  /// \brief Clears all of the cached results.
+  /// Any running analysis is cancelled.
   void ClearResults();
 
+  /// \brief Clears the cached results for a span.
+  /// \param[in] span
+  ///   The document span.
+  /// Any running analysis is cancelled.
+  void ClearResults(const SagSpan* span);
+
+  /// \brief Determines if an analysis is running.
+  /// \return If an analysis is running.
+  bool IsRunning() const;
+
   /// \brief Gets the sagging analyis result.
   /// \param[in] index
   ///   The result index.
-  /// \return The sagging analysis result. If the index did not match up to
-  ///   the results list, or the result is not a valid sagging result, a
-  ///   nullptr is returned.
+  /// \return The sagging analysis result for the activated span. If the index
+  ///   did not match up to the results list, or the result is not a valid
+  ///   sagging result, a nullptr is returned.
   const SaggingAnalysisResult* Result(const int& index) const;
 
   /// \brief Gets the analysis results.
-  /// \return The analysis results. This gets access to all results, even
-  ///   invalid ones.
+  /// \return The analysis results for the activated span. This gets access to
+  ///   all results, even invalid ones. If no results are cached, the list is
+  ///   empty.
   const std::vector<SaggingAnalysisResult>* Results() const;
 
-  /// \brief Runs the sagging analysis.
+  /// \brief Gets the cached result set for a span.
+  /// \param[in] span
+  ///   The document span.
+  /// \return The result set. If no results are cached for the span, a nullptr
+  ///   is returned.
+  const SpanResultSet* ResultSet(const SagSpan* span) const;
+
+  /// \brief Starts the sagging analysis in the background.
+  /// All document spans without cached results are analyzed.
   void RunAnalysis();
 
+  /// \brief Sets the document.
+  /// \param[in] doc
+  ///   The document, which is updated when the analysis is completed.
+  void set_document(wxDocument* doc);
+
   /// \brief Sets the activated span.
   /// \param[in] span
   ///   The span.
   void set_span(const SagSpan* span);
 
+  /// \brief Sets the document spans.
+  /// \param[in] spans
+  ///   The document spans.
+  void set_spans(const std::list<SagSpan>* spans);
+
   /// \brief Gets the span.
   /// \return The span. If no span is set, a nullptr is returned.
   const SagSpan* span() const;
 
  private:
-  /// \brief Updates the analysis temperatures.
-  /// \return The success status of the update.
-  bool UpdateTemperatures();
+  /// \brief Does an analysis job.
+  /// \param[in] index_worker
+  ///   The index of the worker thread that is running the job.
+  /// \param[in] run
+  ///   The analysis run.
+  /// \param[in] job
+  ///   The job.
+  /// This is called from a worker thread.
+  void DoAnalysisJob(const int& index_worker, std::shared_ptr<AnalysisRun> run,
+                     const AnalysisJob& job);
+
+  /// \brief Handles a completed analysis run.
+  /// \param[in] run
+  ///   The analysis run.
+  /// This is called on the application thread.
+  void OnAnalysisCompleted(std::shared_ptr<AnalysisRun> run);
+
+  /// \brief Handles analysis run progress.
+  /// \param[in] run
+  ///   The analysis run.
+  /// This is called on the application thread.
+  void OnAnalysisProgress(std::shared_ptr<AnalysisRun> run);
+
+  /// \brief Handles a completed span in an analysis run.
+  /// \param[in] run
+  ///   The analysis run.
+  /// \param[in] span
+  ///   The completed run span.
+  /// This is called on the application thread.
+  void OnAnalysisSpanCompleted(std::shared_ptr<AnalysisRun> run,
+                               AnalysisRunSpan* span);
+
+  /// \brief Removes any cached results for spans that are no longer in the
+  ///   document.
+  void PurgeResults();
+
+  /// \var kNumTemperaturesJob
+  ///   The maximum number of temperatures that are solved in a single job.
+  static const int kNumTemperaturesJob;
 
-  /// \var max_threads_
-  ///   The maximum number of threads that can be used in the analysis.
-  int max_threads_;
+  /// \var analyzers_
+  ///   The span analyzers, one for each worker thread.
+  std::vector<SpanAnalyzer> analyzers_;
+
+  /// \var cache_
+  ///   The result cache, which is shared by all of the worker analyzers. This
+  ///   is declared before the thread pool so it outlives the worker threads.
+  ResultCache cache_;
+
+  /// \var doc_
+  ///   The document.
+  wxDocument* doc_;
+
+  /// \var pool_
+  ///   The worker thread pool.
+  ThreadPool pool_;
 
   /// \var results_
-  ///   The analysis results.
-  mutable std::vector<SaggingAnalysisResult> results_;
+  ///   The cached result sets, keyed by document span.
+  std::map<const SagSpan*, SpanResultSet> results_;
+
+  /// \var results_null_
+  ///   An empty set of results, which is returned when the activated span
+  ///   doesn't have any cached results.
+  const std::vector<SaggingAnalysisResult> results_null_;
+
+  /// \var run_
+  ///   The analysis run that is in progress. This is only accessed on the
+  ///   application thread.
+  std::shared_ptr<AnalysisRun> run_;
+
+  /// \var sweep_
+  ///   The temperature sweep that the cached result sets were solved with.
+  TemperatureSweep sweep_;
 
   /// \var span_
-  ///   The sag span being analyzed.
+  ///   The activated sag span.
   const SagSpan* span_;
 
-  /// \var temperatures_
-  ///   The temperatures to be analyzed.
-  std::list<double> temperatures_;
+  /// \var tolerance_parabola_
+  ///   The parabola tolerance that the cached result sets were solved with.
+  double tolerance_parabola_;
+
+  /// \var spans_
+  ///   The document spans.
+  const std::list<SagSpan>* spans_;
 };
 
 #endif  // ONSAG_ANALYSIS_CONTROLLER_H_
@@ -0,0 +1,361 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#ifndef ONSAG_BATCH_RUNNER_H_
+#define ONSAG_BATCH_RUNNER_H_
+
+#include <istream>
+#include <list>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "models/base/error_message.h"
+#include "models/base/units.h"
+
+#include "onsag/sag_span.h"
+#include "onsag/span_analyzer.h"
+#include "onsag/span_sagger.h"
+
+/// \par OVERVIEW
+///
+/// This struct is a document that has been loaded for a batch analysis.
+struct BatchDocument {
+  /// \var filepath
+  ///   The filepath the document was loaded from.
+  std::string filepath;
+
+  /// \var spans
+  ///   The document spans. These are converted to a consistent unit style.
+  std::list<SagSpan> spans;
+
+  /// \var units
+  ///   The unit system of the document file.
+  units::UnitSystem units;
+};
+
+/// \par OVERVIEW
+///
+/// This struct contains the batch analysis results for a single span.
+struct BatchSpanResult {
+  /// \var document
+  ///   The document that contains the span.
+  const BatchDocument* document;
+
+  /// \var index_table
+  ///   The span index in the result table.
+  int index_table;
+
+  /// \var is_valid
+  ///   An indicator that tells if all of the span results were solved.
+  bool is_valid;
+
+  /// \var messages
+  ///   The error messages encountered during the analysis.
+  std::list<ErrorMessage> messages;
+
+  /// \var results
+  ///   The result table of the job that solved the span, or nullptr if the
+  ///   span was not analyzed. The span values are in the index_table row.
+  const SpanSaggerResultTable* results;
+
+  /// \var span
+  ///   The span that was analyzed.
+  const SagSpan* span;
+
+  /// \var temperatures
+  ///   The analysis temperatures.
+  std::vector<double> temperatures;
+};
+
+/// \par OVERVIEW
+///
+/// This struct is a batch analysis job for a table of spans that share the
+/// same unit system and analysis temperatures.
+struct BatchJob {
+  /// \var inputs
+  ///   The span inputs.
+  SpanSaggerInputTable inputs;
+
+  /// \var results
+  ///   The sagging results.
+  SpanSaggerResultTable results;
+
+  /// \var results_span
+  ///   The span results, in the same order as the span inputs.
+  std::vector<BatchSpanResult*> results_span;
+
+  /// \var temperatures
+  ///   The analysis temperatures, which are shared by all of the spans.
+  const std::vector<double>* temperatures;
+
+  /// \var tolerance_parabola
+  ///   The parabola tolerance.
+  double tolerance_parabola;
+
+  /// \var units
+  ///   The unit system.
+  units::UnitSystem units;
+};
+
+/// \par OVERVIEW
+///
+/// This class runs a sagging analysis on every span in a set of documents,
+/// and writes the results to a stream.
+///
+/// \par DOCUMENTS
+///
+/// Documents are parsed with the same XML handlers as the application. Each
+/// document is analyzed in the unit system of the file.
+///
+/// \par MULTI-THREADING
+///
+/// Spans that have the same unit system and analysis temperatures are solved
+/// together as a table (see SpanSagger::SagTable()). The tables are split
+/// into jobs of roughly equal size that are added to a worker thread pool,
+/// so workers that are idle steal jobs from workers that are stuck on slow
+/// spans (ex: transit spans) until all of the spans are analyzed. Any span
+/// temperatures that could not be solved are analyzed again individually to
+/// get the error messages.
+///
+/// \par TEMPERATURE SWEEP
+///
+/// The analysis temperatures for each span are generated from a temperature
+/// sweep, which defaults to the span base temperature and two intervals above
+/// and below.
+///
+/// \par PARABOLA
+///
+/// A parabola tolerance can be set, which evaluates the sag, length and sag
+/// correction of short spans in closed form (see SpanCatenarySolver). The
+/// number of parabola solves and fallbacks is logged after the analysis.
+///
+/// \par OUTPUT
+///
+/// The results can be written as CSV (one row per span temperature) or JSON
+/// (grouped by document and span).
+///
+/// \par TRANSIT OPTIMIZATION
+///
+/// The transit location of every transit span can be optimized over the
+/// temperature sweep, without running the analysis. The existing transit
+/// location is evaluated too, so spans that need a new setup are flagged.
+///
+/// \par READINGS
+///
+/// Field readings (ex: the dynamometer tensions for a shift) can be solved
+/// for the cable temperature of the loaded spans, without running the
+/// analysis.
+///
+/// \par LOOKUP TABLES
+///
+/// The lookup table of every span (see SpanLookupTable) can be exported as
+/// CSV, without running the analysis. The tables contain the sample values
+/// and slopes, so offline field devices can interpolate the spans without the
+/// sagging engine.
+class BatchRunner {
+ public:
+  /// \par OVERVIEW
+  ///
+  /// This enum contains types of output formats.
+  enum class FormatType {
+    kNull,
+    kCsv,
+    kJson
+  };
+
+  /// \brief Constructor.
+  BatchRunner();
+
+  /// \brief Destructor.
+  ~BatchRunner();
+
+  /// \brief Adds a document that is already loaded.
+  /// \param[in] document
+  ///   The document. The spans must be in the consistent unit style.
+  void AddDocument(const BatchDocument& document);
+
+  /// \brief Adds a path to the batch.
+  /// \param[in] path
+  ///   The path to a document file, or a directory. All document files in a
+  ///   directory (and sub-directories) are loaded.
+  /// \return The success status of loading all documents in the path.
+  /// All errors are logged to the active application log target.
+  bool AddPath(const std::string& path);
+
+  /// \brief Exports the lookup table of every span.
+  /// \param[in] num_samples
+  ///   The number of temperature samples in each table.
+  /// \param[out] stream
+  ///   The output stream, which is written as CSV with a row for each span
+  ///   sample. The rows are prefixed with the file and span.
+  /// \return The number of spans that could not be exported.
+  /// The values are in the units of the document.
+  int ExportTables(const int& num_samples, std::ostream& stream) const;
+
+  /// \brief Loads a document file.
+  /// \param[in] filepath
+  ///   The filepath.
+  /// \return The success status of the load.
+  /// All errors are logged to the active application log target.
+  bool LoadDocument(const std::string& filepath);
+
+  /// \brief Optimizes the transit location of every transit span.
+  /// \param[in] num_threads
+  ///   The number of worker threads. If less than 1, the number of available
+  ///   CPUs is used.
+  /// \param[out] stream
+  ///   The output stream, which is written as CSV with a row for each
+  ///   transit span.
+  /// \return The number of transit spans that could not be optimized, or
+  ///   that do not have a feasible transit location.
+  /// The search region is behind and below the back attachment point, down to
+  /// twice the span sag at the highest sweep temperature (see
+  /// TransitOptimizer).
+  int OptimizeTransits(const int& num_threads, std::ostream& stream) const;
+
+  /// \brief Runs the analysis on all spans.
+  /// \param[in] num_threads
+  ///   The number of worker threads. If less than 1, the number of available
+  ///   CPUs is used.
+  /// \return The number of spans that could not be solved.
+  int RunAnalysis(const int& num_threads);
+
+  /// \brief Solves field readings for the cable temperature.
+  /// \param[in] readings
+  ///   The readings, as CSV with a header row and a row for each reading. The
+  ///   columns are the span description and the measurement, in the units of
+  ///   the document (see SpanInverseSolver).
+  /// \param[out] stream
+  ///   The output stream, which is written as CSV with a row for each
+  ///   reading.
+  /// \return The number of readings that could not be solved.
+  /// Readings are matched to the first loaded span with the same description.
+  int SolveReadings(std::istream& readings, std::ostream& stream) const;
+
+  /// \brief Writes the results.
+  /// \param[in] format
+  ///   The output format.
+  /// \param[out] stream
+  ///   The output stream.
+  void WriteResults(const FormatType& format, std::ostream& stream) const;
+
+  /// \brief Sets the temperature sweep.
+  /// \param[in] sweep
+  ///   The temperature sweep.
+  void set_sweep(const TemperatureSweep& sweep);
+
+  /// \brief Sets the parabola tolerance.
+  /// \param[in] tolerance_parabola
+  ///   The maximum error of the parabolic sag and length. If this is not
+  ///   positive, the parabola is not used.
+  void set_tolerance_parabola(const double& tolerance_parabola);
+
+  /// \brief Gets the temperature sweep.
+  /// \return The temperature sweep.
+  const TemperatureSweep& sweep() const;
+
+  /// \brief Gets the parabola tolerance.
+  /// \return The parabola tolerance.
+  double tolerance_parabola() const;
+
+  /// \brief Gets the documents.
+  /// \return The documents.
+  const std::list<BatchDocument>& documents() const;
+
+  /// \brief Gets the span results.
+  /// \return The span results.
+  const std::vector<BatchSpanResult>& results() const;
+
+ private:
+  /// \brief Analyzes a job.
+  /// \param[in,out] job
+  ///   The job to analyze. The span results are updated with any errors.
+  static void AnalyzeJob(BatchJob& job);
+
+  /// \var kNumSolutionsJob
+  ///   The target number of sagging solutions in a single job.
+  static const int kNumSolutionsJob;
+
+  /// \brief Formats a string for a CSV field.
+  /// \param[in] str
+  ///   The string.
+  /// \return The string, quoted if necessary.
+  static std::string FormatCsvString(const std::string& str);
+
+  /// \brief Formats sensitivities as a JSON object.
+  /// \param[in] sensitivity
+  ///   The sensitivities.
+  /// \return The JSON object, with null for any unsolved values.
+  static std::string FormatJsonSensitivity(
+      const SpanSaggerSensitivity& sensitivity);
+
+  /// \brief Formats a string for a JSON value.
+  /// \param[in] str
+  ///   The string.
+  /// \return The quoted and escaped string.
+  static std::string FormatJsonString(const std::string& str);
+
+  /// \brief Formats a result value.
+  /// \param[in] value
+  ///   The value.
+  /// \param[in] precision
+  ///   The decimal precision.
+  /// \param[in] str_invalid
+  ///   The string to return if the value is invalid.
+  /// \return The formatted value.
+  static std::string FormatValue(const double& value, const int& precision,
+                                 const std::string& str_invalid);
+
+  /// \brief Gets a string describing the method type.
+  /// \param[in] type
+  ///   The method type.
+  /// \return A string describing the method type.
+  static std::string NameMethod(const SagMethod::Type& type);
+
+  /// \brief Gets a string describing the unit system.
+  /// \param[in] units
+  ///   The unit system.
+  /// \return A string describing the unit system.
+  static std::string NameUnits(const units::UnitSystem& units);
+
+  /// \brief Parses a CSV line into fields.
+  /// \param[in] line
+  ///   The line, which may contain quoted fields.
+  /// \return The unquoted fields.
+  static std::vector<std::string> ParseCsvLine(const std::string& line);
+
+  /// \brief Writes the results in CSV format.
+  /// \param[out] stream
+  ///   The output stream.
+  void WriteCsv(std::ostream& stream) const;
+
+  /// \brief Writes the results in JSON format.
+  /// \param[out] stream
+  ///   The output stream.
+  void WriteJson(std::ostream& stream) const;
+
+  /// \var documents_
+  ///   The loaded documents. This is a list so span references stay valid as
+  ///   documents are added.
+  std::list<BatchDocument> documents_;
+
+  /// \var jobs_
+  ///   The analysis jobs, which own the result tables. This is a list so the
+  ///   tables stay valid as jobs are added.
+  std::list<BatchJob> jobs_;
+
+  /// \var results_
+  ///   The span results.
+  std::vector<BatchSpanResult> results_;
+
+  /// \var sweep_
+  ///   The temperature sweep.
+  TemperatureSweep sweep_;
+
+  /// \var tolerance_parabola_
+  ///   The parabola tolerance.
+  double tolerance_parabola_;
+};
+
+#endif  // ONSAG_BATCH_RUNNER_H_
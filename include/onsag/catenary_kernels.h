@@ -0,0 +1,64 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#ifndef ONSAG_CATENARY_KERNELS_H_
+#define ONSAG_CATENARY_KERNELS_H_
+
+#include <string>
+
+/// \par OVERVIEW
+///
+/// This namespace contains kernels that evaluate many catenary coordinates in
+/// a single call.
+///
+/// \par CATENARY
+///
+/// The catenary is planar, and is defined by:
+/// - the catenary constant (horizontal tension divided by unit weight)
+/// - the horizontal spacing between the end points
+/// - the vertical spacing between the end points
+/// Coordinates are relative to the left end point, with the vertical axis
+/// positive up. This matches a Catenary3d that only has vertical unit weight,
+/// which is how the sagging engine builds every catenary.
+///
+/// \par VECTORIZATION
+///
+/// The kernels use SIMD instructions when ONSAG_ENABLE_SIMD is defined. AVX2
+/// (4 values per instruction) is used when the file is compiled for AVX2,
+/// otherwise SSE2 (2 values per instruction) is used on x86 targets. All other
+/// targets use a scalar fallback. The hyperbolic functions are evaluated with
+/// the same exp/log approximations on every path, so the results from each
+/// instruction set agree to within a few units in the last place.
+///
+/// \par ARRAYS
+///
+/// All arrays are contiguous, and do not need to be aligned.
+namespace catenary_kernels {
+
+/// \brief Calculates coordinates along a catenary.
+/// \param[in] constant
+///   The catenary constant.
+/// \param[in] spacing_x
+///   The horizontal spacing between end points.
+/// \param[in] spacing_z
+///   The vertical spacing between end points.
+/// \param[in] num_points
+///   The number of points.
+/// \param[in] positions_fraction
+///   The horizontal positions, as a fraction of the horizontal spacing.
+/// \param[out] coordinates_x
+///   The horizontal coordinates.
+/// \param[out] coordinates_z
+///   The vertical coordinates.
+void Coordinates(const double& constant, const double& spacing_x,
+                 const double& spacing_z, const int& num_points,
+                 const double* positions_fraction, double* coordinates_x,
+                 double* coordinates_z);
+
+/// \brief Gets the instruction set that the kernels are compiled for.
+/// \return The instruction set name.
+std::string InstructionSet();
+
+}  // namespace catenary_kernels
+
+#endif  // ONSAG_CATENARY_KERNELS_H_
@@ -10,6 +10,8 @@
 #include "wx/cmndata.h"
 #include "wx/wx.h"
 
+#include "onsag/span_analyzer.h"
+
 /// \par OVERVIEW
 ///
 /// This class has the options for the ProfilePlotPane.
@@ -72,6 +74,16 @@ struct OnSagConfig {
   ///   The main application frame size.
   wxSize size_frame;
 
+  /// \var sweep
+  ///   The temperature sweep that is analyzed for each span.
+  TemperatureSweep sweep;
+
+  /// \var tolerance_parabola
+  ///   The maximum error of the parabolic sag and length, in the same units as
+  ///   the structure attachment points. If this is not positive, the sags and
+  ///   lengths are always solved with the exact catenary.
+  double tolerance_parabola;
+
   /// \var units
   ///   The measurement unit system.
   units::UnitSystem units;
@@ -20,6 +20,7 @@ class UpdateHint : public wxObject {
   /// This enum class contains types of update hints.
   enum class Type {
     kNull,
+    kAnalysisUpdate,
     kPreferencesEdit,
     kSpansEdit,
     kViewSelect,
@@ -60,19 +61,23 @@ class UpdateHint : public wxObject {
 /// \par ANALYSIS CONTROLLER
 ///
 /// The document uses an analysis controller to handle the sagging calculations
-/// and store the generated results for the selected span. The results can be
-/// accessed via public functions.
+/// and store the generated results for every span. The results for the
+/// activated span can be accessed via public functions, and the results for
+/// any other span can be accessed with ResultSet().
 ///
 /// \par UPDATES
 ///
 /// The document and view need to be updated when the selected analysis sag
-/// span is changed. This class does not post any updates by itself, as the
-/// document and view updates may take a significant amount of time.
+/// span is changed. This class does not post any updates for edits by itself,
+/// as the document and view updates may take a significant amount of time.
 ///
 /// To update the document, use the RunAnalysis() method. View updates are done
 /// with the UpdateAllViews() method. Update hints should be passed along to
 /// help the view update properly.
 ///
+/// The analysis runs in the background. Once the results are available, the
+/// analysis controller posts an analysis update hint to all of the views.
+///
 /// \par wxWIDGETS LIBRARY BUILD NOTE
 ///
 /// This class requires that the wxWidgets library deviate from the standard
@@ -195,11 +200,18 @@ class OnSagDoc : public wxDocument {
   const SaggingAnalysisResult* Result(const int& index) const;
 
   /// \brief Gets the analysis results.
-  /// \return The analysis results. If no results are available, a nullptr is
-  ///   returned.
+  /// \return The analysis results for the activated span. If no results are
+  ///   available, the list is empty.
   /// Invalid results may be in this list if the result cannot be calculated.
   const std::vector<SaggingAnalysisResult>* Results() const;
 
+  /// \brief Gets the cached analysis results for a span.
+  /// \param[in] span
+  ///   The document span.
+  /// \return The span result set. If the span has not been analyzed yet, a
+  ///   nullptr is returned.
+  const SpanResultSet* ResultSet(const SagSpan* span) const;
+
   /// \brief Runs the analysis.
   void RunAnalysis() const;
 
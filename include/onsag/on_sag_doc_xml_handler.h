@@ -4,17 +4,23 @@
 #ifndef ONSAG_ON_SAG_DOC_XML_HANDLER_H_
 #define ONSAG_ON_SAG_DOC_XML_HANDLER_H_
 
+#include <list>
 #include <string>
 
 #include "appcommon/xml/xml_handler.h"
 #include "models/base/units.h"
 
-#include "onsag/on_sag_doc.h"
+#include "onsag/sag_span.h"
 
 /// \par OVERVIEW
 ///
 /// This class parses and generates a OnSagDoc XML node. The data is transferred
-/// between the XML node and the data object.
+/// between the XML node and the list of document spans.
+///
+/// \par DOCUMENT INDEPENDENCE
+///
+/// This class does not reference the document directly, so the document file
+/// can be parsed by applications that do not use the document/view framework.
 ///
 /// \par VERSION
 ///
@@ -28,22 +34,22 @@
 class OnSagDocXmlHandler : public XmlHandler {
  public:
   /// \brief Creates an XML node for a document.
-  /// \param[in] doc
-  ///   The document.
+  /// \param[in] spans
+  ///   The document spans.
   /// \param[in] units
   ///   The unit system, which is used for attributing child XML nodes.
   /// \return An XML node for the document.
-  static wxXmlNode* CreateNode(const OnSagDoc& doc,
+  static wxXmlNode* CreateNode(const std::list<SagSpan>& spans,
                                const units::UnitSystem& units);
 
-  /// \brief Parses an XML node and populates a document.
+  /// \brief Parses an XML node and populates the document spans.
   /// \param[in] root
   ///   The XML root node for the document.
   /// \param[in] filepath
   ///   The filepath that the xml node was loaded from. This is for logging
   ///   purposes only and can be left blank.
-  /// \param[out] doc
-  ///   The document that is populated.
+  /// \param[out] spans
+  ///   The document spans that are populated. Parsed spans are appended.
   /// \return The status of the xml node parse. If any errors are encountered
   ///   false is returned.
   /// All errors are logged to the active application log target. Critical
@@ -51,17 +57,17 @@ class OnSagDocXmlHandler : public XmlHandler {
   /// property to an invalid state (if applicable).
   static bool ParseNode(const wxXmlNode* root,
                         const std::string& filepath,
-                        OnSagDoc& doc);
+                        std::list<SagSpan>& spans);
 
  private:
-  /// \brief Parses a version 1 XML node and populates a document.
+  /// \brief Parses a version 1 XML node and populates the document spans.
   /// \param[in] root
   ///   The XML root node for the document.
   /// \param[in] filepath
   ///   The filepath that the xml node was loaded from. This is for logging
   ///   purposes only and can be left blank.
-  /// \param[out] doc
-  ///   The document that is populated.
+  /// \param[out] spans
+  ///   The document spans that are populated. Parsed spans are appended.
   /// \return The status of the xml node parse. If any errors are encountered
   ///   false is returned.
   /// All errors are logged to the active application log target. Critical
@@ -69,7 +75,7 @@ class OnSagDocXmlHandler : public XmlHandler {
   /// property to an invalid state (if applicable).
   static bool ParseNodeV1(const wxXmlNode* root,
                           const std::string& filepath,
-                          OnSagDoc& doc);
+                          std::list<SagSpan>& spans);
 };
 
 #endif  // ONSAG_ON_SAG_DOC_XML_HANDLER_H_
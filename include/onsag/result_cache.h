@@ -0,0 +1,200 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#ifndef ONSAG_RESULT_CACHE_H_
+#define ONSAG_RESULT_CACHE_H_
+
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "models/base/units.h"
+
+#include "onsag/sag_span.h"
+#include "onsag/sagging_analysis_result.h"
+
+/// \par OVERVIEW
+///
+/// This class is a memory-bounded cache of solved sagging results.
+///
+/// \par KEYS
+///
+/// A result is identified by all of the inputs that affect the sagging
+/// solution: the cable, the structure attachment points, the sagging method,
+/// the analysis temperature, the unit system, and the parabola tolerance
+/// (which selects parabolic or exact sags and lengths). Descriptive text
+/// (names, notes, etc) is not part of the key, so renaming a span does not
+/// require any calculations. The dynamometer end and the stopwatch wave
+/// number are not part of the key either, since each result contains the
+/// values for both ends and the full return time table. The caller selects
+/// these values when a result is found. Wave numbers beyond the return time
+/// table are part of the key.
+///
+/// The inputs are packed into a key string, and a stable 64-bit FNV-1a hash
+/// of the key string is used for the lookup. The full key string is stored
+/// with each entry and compared on every lookup, so a hash collision can never
+/// return the wrong result.
+///
+/// \par MEMORY BUDGET
+///
+/// The cache tracks the approximate memory used by each entry. When the budget
+/// is exceeded, the least recently used entries are removed.
+///
+/// \par TEMPERATURE REFERENCE
+///
+/// The cached results do not keep the temperature reference. It is set by the
+/// caller when a result is found.
+///
+/// \par THREAD SAFETY
+///
+/// All functions are thread-safe, so a single cache can be shared by all of
+/// the analysis worker threads.
+class ResultCache {
+ public:
+  /// \var kSizeMaxDefault
+  ///   The default memory budget, in bytes.
+  static const std::size_t kSizeMaxDefault;
+
+  /// \brief Constructor.
+  /// \param[in] size_max
+  ///   The memory budget, in bytes.
+  explicit ResultCache(const std::size_t& size_max = kSizeMaxDefault);
+
+  /// \brief Destructor.
+  ~ResultCache();
+
+  /// \brief Removes all entries.
+  void Clear();
+
+  /// \brief Searches the cache for a result.
+  /// \param[in] key
+  ///   The key, which is generated with Key().
+  /// \param[out] result
+  ///   The cached result. This is only modified if the result is found.
+  /// \return If the result was found.
+  bool Find(const std::string& key, SaggingAnalysisResult& result);
+
+  /// \brief Adds a result to the cache.
+  /// \param[in] key
+  ///   The key, which is generated with Key().
+  /// \param[in] result
+  ///   The solved result.
+  /// If an entry with the same key exists, it is replaced.
+  void Insert(const std::string& key, const SaggingAnalysisResult& result);
+
+  /// \brief Generates a key for the sagging inputs.
+  /// \param[in] span
+  ///   The span.
+  /// \param[in] temperature
+  ///   The analysis temperature.
+  /// \param[in] units
+  ///   The unit system.
+  /// \param[in] tolerance_parabola
+  ///   The parabola tolerance. Tolerances that are not positive are all
+  ///   solved exactly, so they have the same key.
+  /// \return The key.
+  static std::string Key(const SagSpan& span, const double& temperature,
+                         const units::UnitSystem& units,
+                         const double& tolerance_parabola);
+
+  /// \brief Gets the number of cached results.
+  /// \return The number of cached results.
+  int count() const;
+
+  /// \brief Gets the number of lookups that found a result.
+  /// \return The number of lookups that found a result.
+  int num_hits() const;
+
+  /// \brief Gets the number of lookups that did not find a result.
+  /// \return The number of lookups that did not find a result.
+  int num_misses() const;
+
+  /// \brief Gets the approximate memory used, in bytes.
+  /// \return The approximate memory used, in bytes.
+  std::size_t size() const;
+
+  /// \brief Gets the memory budget.
+  /// \return The memory budget, in bytes.
+  std::size_t size_max() const;
+
+ private:
+  /// \par OVERVIEW
+  ///
+  /// This struct is a cached result.
+  struct Entry {
+    /// \var hash
+    ///   The key hash.
+    uint64_t hash;
+
+    /// \var key
+    ///   The key.
+    std::string key;
+
+    /// \var result
+    ///   The sagging result.
+    SaggingAnalysisResult result;
+  };
+
+  /// \brief Appends the bytes of a value to a key.
+  /// \param[in] value
+  ///   The value.
+  /// \param[in,out] key
+  ///   The key.
+  static void AppendKey(const double& value, std::string& key);
+
+  /// \brief Appends the bytes of a value to a key.
+  /// \param[in] value
+  ///   The value.
+  /// \param[in,out] key
+  ///   The key.
+  static void AppendKey(const int& value, std::string& key);
+
+  /// \brief Removes the least recently used entries until the cache is within
+  ///   the memory budget.
+  /// The mutex must be locked before calling this function.
+  void Evict();
+
+  /// \brief Hashes a key.
+  /// \param[in] key
+  ///   The key.
+  /// \return The 64-bit FNV-1a hash of the key.
+  static uint64_t Hash(const std::string& key);
+
+  /// \brief Gets the approximate memory used by an entry.
+  /// \param[in] entry
+  ///   The entry.
+  /// \return The approximate memory used by the entry, in bytes.
+  static std::size_t SizeEntry(const Entry& entry);
+
+  /// \var entries_
+  ///   The cached entries, sorted from most to least recently used.
+  std::list<Entry> entries_;
+
+  /// \var index_
+  ///   The entries, indexed by key hash.
+  std::unordered_map<uint64_t, std::list<Entry>::iterator> index_;
+
+  /// \var mutex_
+  ///   The mutex that guards all member variables.
+  mutable std::mutex mutex_;
+
+  /// \var num_hits_
+  ///   The number of lookups that found a result.
+  int num_hits_;
+
+  /// \var num_misses_
+  ///   The number of lookups that did not find a result.
+  int num_misses_;
+
+  /// \var size_
+  ///   The approximate memory used, in bytes.
+  std::size_t size_;
+
+  /// \var size_max_
+  ///   The memory budget, in bytes.
+  std::size_t size_max_;
+};
+
+#endif  // ONSAG_RESULT_CACHE_H_
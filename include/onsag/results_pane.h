@@ -5,6 +5,7 @@
 #define ONSAG_RESULTS_PANE_H_
 
 #include <list>
+#include <vector>
 
 #include "appcommon/widgets/report_table.h"
 #include "wx/docview.h"
@@ -64,6 +65,11 @@ class ResultsPane : public wxPanel {
   ///   The report data.
   ReportData data_;
 
+  /// \var indexes_result_
+  ///   The document result index of each report row, in the unsorted row
+  ///   order.
+  std::vector<long> indexes_result_;
+
   /// \var table_
   ///   The report table used to display the results.
   ReportTable* table_;
@@ -4,9 +4,13 @@
 #ifndef ONSAG_SAGGING_ANALYSIS_RESULT_H_
 #define ONSAG_SAGGING_ANALYSIS_RESULT_H_
 
+#include <vector>
+
 #include "models/base/point.h"
 #include "models/transmissionline/catenary.h"
 
+#include "onsag/span_sagger.h"
+
 /// \par OVERVIEW
 ///
 /// This represents a single sagging analysis result.
@@ -43,11 +47,36 @@ struct SaggingAnalysisResult {
   ///   The control factor. Only applicable for the 'kTransit' sagging method.
   double factor_control;
 
+  /// \var length
+  ///   The catenary length, which is parabolic if it is within the parabola
+  ///   tolerance. Applicable for all sagging methods.
+  double length;
+
   /// \var offset_coordinates
   ///   The offset to convert catenary coordinates to span coordinates.
   ///   Applicable for all sagging methods.
   Point2d<double> offset_coordinates;
 
+  /// \var sag
+  ///   The catenary sag, which is parabolic if it is within the parabola
+  ///   tolerance. Applicable for all sagging methods.
+  double sag;
+
+  /// \var sensitivity_creep
+  ///   The derivatives with respect to the cable creep correction. Applicable
+  ///   for all sagging methods.
+  SpanSaggerSensitivity sensitivity_creep;
+
+  /// \var sensitivity_temperature
+  ///   The derivatives with respect to the cable temperature. Applicable for
+  ///   all sagging methods.
+  SpanSaggerSensitivity sensitivity_temperature;
+
+  /// \var sensitivity_weight
+  ///   The derivatives with respect to the cable unit weight. Applicable for
+  ///   all sagging methods.
+  SpanSaggerSensitivity sensitivity_weight;
+
   /// \var speed_wave
   ///   The traveling wave speed. Only applicable for 'kStopwatch' sagging
   ///   method.
@@ -58,13 +87,29 @@ struct SaggingAnalysisResult {
   const double* temperature_cable;
 
   /// \var tension_dyno
-  ///   The dynamometer tension. Only applicable for the 'kDynamometer' sagging
-  ///   method.
+  ///   The dynamometer tension at the span end that is selected by the
+  ///   method. Only applicable for the 'kDynamometer' sagging method.
   double tension_dyno;
 
+  /// \var tension_dyno_ahead
+  ///   The dynamometer tension at the ahead-on-line structure. Only
+  ///   applicable for the 'kDynamometer' sagging method.
+  double tension_dyno_ahead;
+
+  /// \var tension_dyno_back
+  ///   The dynamometer tension at the back-on-line structure. Only applicable
+  ///   for the 'kDynamometer' sagging method.
+  double tension_dyno_back;
+
   /// \var time_stopwatch
   ///   The stopwatch time. Only applicable for the 'kStopwatch' sagging method.
   double time_stopwatch;
+
+  /// \var times_return
+  ///   The stopwatch return times for waves 1 through
+  ///   SpanSaggerResult::kNumWavesReturn, indexed by the wave number minus
+  ///   one. Only applicable for the 'kStopwatch' sagging method.
+  std::vector<double> times_return;
 };
 
 #endif  // ONSAG_SAGGING_ANALYSIS_RESULT_H_
@@ -0,0 +1,274 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#ifndef ONSAG_SPAN_ANALYZER_H_
+#define ONSAG_SPAN_ANALYZER_H_
+
+#include <list>
+#include <vector>
+
+#include "models/base/error_message.h"
+#include "models/base/units.h"
+
+#include "onsag/result_cache.h"
+#include "onsag/sag_span.h"
+#include "onsag/sagging_analysis_result.h"
+#include "onsag/span_sagger.h"
+
+/// \par OVERVIEW
+///
+/// This struct describes the set of temperatures that are analyzed for a span.
+///
+/// \par TYPES
+///
+/// A span sweep starts at the span base temperature and steps up and down by
+/// the span temperature interval. A cable sweep covers the full temperature
+/// range of the cable temperature-tension points (shifted by the creep
+/// correction) at a fixed step, which is used to generate detailed sag tables.
+struct TemperatureSweep {
+ public:
+  /// \par OVERVIEW
+  ///
+  /// This enum contains types of temperature sweeps.
+  enum class Type {
+    kNull,
+    kCable,
+    kSpan
+  };
+
+  /// \brief Constructor.
+  /// The default sweep is the span base temperature and two intervals above
+  /// and below.
+  TemperatureSweep();
+
+  /// \brief Validates member variables.
+  /// \param[in] is_included_warnings
+  ///   A flag that tightens the acceptable value range.
+  /// \param[in,out] messages
+  ///   A list of detailed error messages. If this is provided, any validation
+  ///   errors will be appended to the list.
+  /// \return A boolean value indicating status of member variables.
+  bool Validate(const bool& is_included_warnings = true,
+                std::list<ErrorMessage>* messages = nullptr) const;
+
+  /// \var num_intervals
+  ///   The number of span temperature intervals above and below the base
+  ///   temperature. This is only used for the 'kSpan' type.
+  int num_intervals;
+
+  /// \var step
+  ///   The temperature step. This is only used for the 'kCable' type.
+  double step;
+
+  /// \var type
+  ///   The sweep type.
+  Type type;
+};
+
+
+/// \par OVERVIEW
+///
+/// This class drives the sagging analysis for a single span. It converts the
+/// span and a set of analysis temperatures into sagging results.
+///
+/// \par GUI INDEPENDENCE
+///
+/// This class does not depend on the GUI framework or the application
+/// configuration. The unit system must be provided explicitly, and all errors
+/// are returned as error messages instead of being logged. This allows the
+/// analysis to be run by the application worker threads as well as by
+/// applications that do not have a GUI.
+///
+/// \par CACHE
+///
+/// A result cache can optionally be set. Every solved result is added to the
+/// cache, and the cache is checked before the sagger is used. This skips the
+/// calculations if the same inputs have already been solved (ex: undoing a
+/// span edit).
+///
+/// \par SENSITIVITY
+///
+/// Every result includes the derivatives of the sag, horizontal tension, and
+/// method values with respect to the cable temperature, creep correction, and
+/// unit weight. These are solved from the same catenary as the result, so
+/// field tolerances can be checked without analyzing nearby temperatures.
+///
+/// \par PARABOLA
+///
+/// A parabola tolerance can optionally be set, which evaluates the sag,
+/// length and sag correction of short spans in closed form (see
+/// SpanCatenarySolver). The tolerance is part of the cache key.
+///
+/// \par WARM START
+///
+/// The sag correction solve is warm started by default, so a sweep of
+/// ascending temperatures seeds each solve from the previous temperature. The
+/// solver iterations are totaled for the span, which shows how effective the
+/// warm start is.
+///
+/// \par THREADING
+///
+/// This class is not thread-safe. Each thread should use its own analyzer,
+/// which can share the same (unmodified) span and the same cache.
+class SpanAnalyzer {
+ public:
+  /// \var kNumTemperaturesMax
+  ///   The maximum number of temperatures that are generated for a span.
+  static const int kNumTemperaturesMax;
+
+  /// \brief Constructor.
+  SpanAnalyzer();
+
+  /// \brief Destructor.
+  ~SpanAnalyzer();
+
+  /// \brief Analyzes the span at a single temperature.
+  /// \param[in] temperature
+  ///   The cable temperature. This must remain in scope for the lifetime of
+  ///   the result, as the result references it.
+  /// \param[out] result
+  ///   The result to populate. If the analysis fails, the result is set to an
+  ///   invalid state.
+  /// \param[in,out] messages
+  ///   A list of detailed error messages. If this is provided, any analysis
+  ///   errors will be appended to the list.
+  /// \return The success status of the analysis.
+  bool Analyze(const double* temperature,
+               SaggingAnalysisResult& result,
+               std::list<ErrorMessage>* messages = nullptr);
+
+  /// \brief Analyzes the span at multiple temperatures.
+  /// \param[in] temperatures
+  ///   The cable temperatures. These must remain in scope for the lifetime of
+  ///   the results, as the results reference them.
+  /// \param[out] results
+  ///   The results to populate. This is resized to match the temperatures.
+  /// \param[in,out] messages
+  ///   A list of detailed error messages. If this is provided, any analysis
+  ///   errors will be appended to the list.
+  /// \return The success status of the analysis. If any temperature fails,
+  ///   false is returned.
+  bool Analyze(const std::vector<double>& temperatures,
+               std::vector<SaggingAnalysisResult>& results,
+               std::list<ErrorMessage>* messages = nullptr);
+
+  /// \brief Gets the analysis temperatures for a span.
+  /// \param[in] span
+  ///   The span.
+  /// \return The analysis temperatures. The base temperature is analyzed, as
+  ///   well as two intervals above and below.
+  static std::vector<double> Temperatures(const SagSpan& span);
+
+  /// \brief Gets the analysis temperatures for a span.
+  /// \param[in] span
+  ///   The span.
+  /// \param[in] sweep
+  ///   The temperature sweep.
+  /// \param[in,out] messages
+  ///   A list of detailed error messages. If this is provided, any errors will
+  ///   be appended to the list.
+  /// \return The analysis temperatures, in ascending order. A cable sweep
+  ///   covers the range that the catenary solver accepts (see
+  ///   SpanCatenarySolver::TemperatureRange()). If the sweep is invalid, or
+  ///   it exceeds kNumTemperaturesMax, no temperatures are returned.
+  static std::vector<double> Temperatures(
+      const SagSpan& span,
+      const TemperatureSweep& sweep,
+      std::list<ErrorMessage>* messages = nullptr);
+
+  /// \brief Validates member variables.
+  /// \param[in] is_included_warnings
+  ///   A flag that tightens the acceptable value range.
+  /// \param[in,out] messages
+  ///   A list of detailed error messages. If this is provided, any validation
+  ///   errors will be appended to the list.
+  /// \return A boolean value indicating status of member variables.
+  bool Validate(const bool& is_included_warnings = true,
+                std::list<ErrorMessage>* messages = nullptr) const;
+
+  /// \brief Sets if the sag correction solve is warm started.
+  /// \param[in] is_warm_started
+  ///   An indicator that tells if the solve is warm started.
+  void set_is_warm_started(const bool& is_warm_started);
+
+  /// \brief Sets the result cache.
+  /// \param[in] cache
+  ///   The result cache. If set to nullptr, no cache is used.
+  void set_cache(ResultCache* cache);
+
+  /// \brief Sets the span.
+  /// \param[in] span
+  ///   The span.
+  /// The cable tension curve is fitted once for the span, so the span must be
+  /// set again if it is modified.
+  void set_span(const SagSpan* span);
+
+  /// \brief Sets the parabola tolerance.
+  /// \param[in] tolerance_parabola
+  ///   The maximum error of the parabolic sag and length. If this is not
+  ///   positive, the parabola is not used.
+  void set_tolerance_parabola(const double& tolerance_parabola);
+
+  /// \brief Sets the unit system.
+  /// \param[in] units
+  ///   The unit system.
+  void set_units(const units::UnitSystem& units);
+
+  /// \brief Gets the result cache.
+  /// \return The result cache.
+  ResultCache* cache() const;
+
+  /// \brief Gets if the sag correction solve is warm started.
+  /// \return If the sag correction solve is warm started.
+  bool is_warm_started() const;
+
+  /// \brief Gets the total sag correction solver iterations.
+  /// \return The total solver iterations since the span was set. Cached
+  ///   results do not add any iterations.
+  int iterations_correction() const;
+
+  /// \brief Gets the number of catenary solves evaluated by the parabola.
+  /// \return The number of catenary solves evaluated by the parabola.
+  int num_solves_parabola() const;
+
+  /// \brief Gets the number of catenary solves that exceeded the parabola
+  ///   tolerance.
+  /// \return The number of catenary solves that fell back to the exact
+  ///   catenary.
+  int num_solves_parabola_fallback() const;
+
+  /// \brief Gets the span.
+  /// \return The span.
+  const SagSpan* span() const;
+
+  /// \brief Gets the parabola tolerance.
+  /// \return The parabola tolerance.
+  double tolerance_parabola() const;
+
+  /// \brief Gets the unit system.
+  /// \return The unit system.
+  units::UnitSystem units() const;
+
+ private:
+  /// \var cache_
+  ///   The result cache.
+  ResultCache* cache_;
+
+  /// \var iterations_correction_
+  ///   The total sag correction solver iterations since the span was set.
+  int iterations_correction_;
+
+  /// \var sagger_
+  ///   The sagger that is used to solve for the sagging results.
+  SpanSagger sagger_;
+
+  /// \var span_
+  ///   The span to analyze.
+  const SagSpan* span_;
+
+  /// \var units_
+  ///   The unit system.
+  units::UnitSystem units_;
+};
+
+#endif  // ONSAG_SPAN_ANALYZER_H_
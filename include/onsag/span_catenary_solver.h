@@ -0,0 +1,332 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#ifndef ONSAG_SPAN_CATENARY_SOLVER_H_
+#define ONSAG_SPAN_CATENARY_SOLVER_H_
+
+#include "models/transmissionline/catenary.h"
+
+#include "onsag/sag_cable.h"
+#include "onsag/sag_structure.h"
+#include "onsag/tension_curve.h"
+
+/// \par OVERVIEW
+///
+/// This class solves the catenary for a span at a cable temperature. It does
+/// not depend on the sagging method, so it is shared by all of the span
+/// saggers.
+///
+/// \par CATENARY
+///
+/// The catenary will reflect the cable tension/position, accounting for:
+/// - Creep Correction: the target temperature is reduced by the creep
+///   correction, so the temperatures that can be solved are the tension point
+///   temperatures shifted by the creep correction (see TemperatureRange()).
+/// - Temperature: the horizontal tension can vary with temperature. The
+///   horizontal tension at the target temperature is solved for using a
+///   monotone cubic spline through the cable tension points. The spline is
+///   fitted once when the cable is set, and is reused for every temperature.
+/// - Sag Correction: the sag increase/decrease. The horizontal tension that
+///   matches the corrected sag is solved for with Newton iterations.
+///
+/// \par WARM START
+///
+/// When warm starting is enabled, each sag correction solve is seeded from
+/// the previously solved temperature. The shift in the reciprocal tension
+/// caused by the previous sag correction is applied to the uncorrected
+/// tension, which is very close to the solution for adjacent temperatures in
+/// a sweep, so a single iteration is typically needed. The seed is discarded
+/// when the cable or structures are changed. When warm starting is disabled,
+/// every solve is seeded from the uncorrected tension.
+///
+/// \par PARABOLA
+///
+/// When a parabola tolerance is set, the sag, length and sag correction are
+/// evaluated in closed form with the parabolic approximation of the
+/// catenary. Each parabolic value has an a-priori error bound that is
+/// calculated from the series expansion of the catenary, without evaluating
+/// the catenary. With s = (horizontal spacing) / (2 * catenary constant):
+/// - Sag: the parabolic sag is sqrt(1 + m^2) * w * a^2 / (8 * H), where m is
+///   the chord slope. The error is bounded by
+///   c * cosh(s) * ((sqrt(1 + m^2) * s^4 / 24) + (|m| * s^3 / 6)).
+/// - Length: sinh(s) / s is truncated after the s^2 term, so the error is
+///   bounded by a * cosh(s) * s^4 / 120.
+/// - Sag Correction: the parabolic sag is inversely proportional to the
+///   horizontal tension, so the corrected tension matches the corrected
+///   parabolic sag exactly. The catenary sag error is bounded by the sum of
+///   the sag bounds at the uncorrected and corrected tensions.
+///
+/// cosh(s) is bounded by 2 / (2 - s^2), so the parabola is only used for
+/// s^2 < 2. The parabola is used if every bound is within the tolerance.
+/// Otherwise the sag and length are calculated with the exact catenary, and
+/// the parabolic tension seeds the sag correction iterations (unless there
+/// is a warm start seed), which fall back to the general catenary solver.
+/// The parabola solves and fallbacks are counted for the lifetime of the
+/// class.
+class SpanCatenarySolver {
+ public:
+  /// \brief Constructor.
+  SpanCatenarySolver();
+
+  /// \brief Destructor.
+  ~SpanCatenarySolver();
+
+  /// \brief Gets the catenary.
+  /// \return The solved catenary, or nullptr if it could not be solved. This
+  ///   is valid until an input is modified.
+  const Catenary3d* Catenary() const;
+
+  /// \brief Gets the number of solver iterations used for the sag correction.
+  /// \return The number of iterations. This is zero if the cable does not
+  ///   have a sag correction, and -999999 if the catenary could not be solved.
+  int IterationsCorrection() const;
+
+  /// \brief Determines if the catenary is updated.
+  /// \return A boolean indicating if the catenary is updated.
+  bool IsUpdated() const;
+
+  /// \brief Gets the catenary length.
+  /// \return The length, which is parabolic if it is within the parabola
+  ///   tolerance. This is -999999 if the catenary could not be solved.
+  double Length() const;
+
+  /// \brief Gets the catenary sag.
+  /// \return The sag, which is parabolic if it is within the parabola
+  ///   tolerance. This is -999999 if the catenary could not be solved.
+  double Sag() const;
+
+  /// \brief Gets the range of cable temperatures that can be solved.
+  /// \param[in] cable
+  ///   The cable.
+  /// \param[out] temperature_min
+  ///   The minimum temperature.
+  /// \param[out] temperature_max
+  ///   The maximum temperature.
+  /// \return If the cable has tension points. The range is the temperatures of
+  ///   the first and last tension points, shifted by the creep correction.
+  static bool TemperatureRange(const SagCable& cable, double& temperature_min,
+                               double& temperature_max);
+
+  /// \brief Gets the slopes of the horizontal tension.
+  /// \param[out] slope_temperature
+  ///   The derivative with respect to the cable temperature.
+  /// \param[out] slope_weight
+  ///   The derivative with respect to the cable unit weight.
+  /// \return The success status. The slopes are -999999 if the catenary could
+  ///   not be solved.
+  /// The tension curve slope is analytic. The sag correction holds the sag
+  /// difference constant, so the corrected slopes are found by implicitly
+  /// differentiating the sag at the uncorrected and corrected tensions.
+  bool SlopesTensionHorizontal(double& slope_temperature,
+                               double& slope_weight) const;
+
+  /// \brief Gets the cable.
+  /// \return The cable.
+  const SagCable* cable() const;
+
+  /// \brief Gets if the sag correction solve is warm started.
+  /// \return If the sag correction solve is warm started.
+  bool is_warm_started() const;
+
+  /// \brief Gets the number of catenary solves.
+  /// \return The number of catenary solves.
+  int num_solves() const;
+
+  /// \brief Gets the number of catenary solves evaluated by the parabola.
+  /// \return The number of catenary solves where the sag, length and sag
+  ///   correction were within the parabola tolerance.
+  int num_solves_parabola() const;
+
+  /// \brief Gets the number of catenary solves that fell back to the exact
+  ///   catenary.
+  /// \return The number of catenary solves where a parabola bound exceeded
+  ///   the tolerance. Solves without a parabola tolerance are not counted.
+  int num_solves_parabola_fallback() const;
+
+  /// \brief Sets the cable.
+  /// \param[in] cable
+  ///   The cable.
+  void set_cable(const SagCable* cable);
+
+  /// \brief Sets if the sag correction solve is warm started.
+  /// \param[in] is_warm_started
+  ///   An indicator that tells if the solve is warm started.
+  void set_is_warm_started(const bool& is_warm_started);
+
+  /// \brief Sets the ahead structure.
+  /// \param[in] structure_ahead
+  ///   The ahead structure.
+  void set_structure_ahead(const SagStructure* structure_ahead);
+
+  /// \brief Sets the back structure.
+  /// \param[in] structure_back
+  ///   The back structure.
+  void set_structure_back(const SagStructure* structure_back);
+
+  /// \brief Sets the temperature.
+  /// \param[in] temperature
+  ///   The temperature.
+  void set_temperature(const double* temperature);
+
+  /// \brief Sets the parabola tolerance.
+  /// \param[in] tolerance_parabola
+  ///   The maximum error of the parabolic sag and length, in the same units
+  ///   as the structure attachment points. If this is not positive, the
+  ///   parabola is not used.
+  void set_tolerance_parabola(const double& tolerance_parabola);
+
+  /// \brief Gets the ahead structure.
+  /// \return The ahead structure.
+  const SagStructure* structure_ahead() const;
+
+  /// \brief Gets the back structure.
+  /// \return The back structure.
+  const SagStructure* structure_back() const;
+
+  /// \brief Gets the temperature.
+  /// \return The temperature.
+  const double* temperature() const;
+
+  /// \brief Gets the parabola tolerance.
+  /// \return The parabola tolerance.
+  double tolerance_parabola() const;
+
+ private:
+  /// \brief Calculates the parabolic length.
+  /// \param[in] tension_horizontal
+  ///   The horizontal tension.
+  /// \param[out] length
+  ///   The parabolic length.
+  /// \param[out] bound
+  ///   The bound on the difference from the catenary length.
+  /// \return If the bound could be calculated.
+  bool LengthParabola(const double& tension_horizontal, double& length,
+                      double& bound) const;
+
+  /// \brief Resets the warm start seed.
+  void ResetSeed() const;
+
+  /// \brief Calculates the parabolic sag.
+  /// \param[in] tension_horizontal
+  ///   The horizontal tension.
+  /// \param[out] sag
+  ///   The parabolic sag.
+  /// \param[out] bound
+  ///   The bound on the difference from the catenary sag.
+  /// \return If the bound could be calculated.
+  bool SagParabola(const double& tension_horizontal, double& sag,
+                   double& bound) const;
+
+  /// \brief Gets the slope of the sag with respect to the horizontal tension.
+  /// \param[in] tension_horizontal
+  ///   The horizontal tension.
+  /// \return The slope, calculated with a central difference of the solved
+  ///   catenary.
+  double SlopeSag(const double& tension_horizontal) const;
+
+  /// \brief Solves for the horizontal tension that matches the corrected sag
+  ///   using the parabola.
+  /// \param[in] tension_horizontal
+  ///   The uncorrected horizontal tension.
+  /// \param[out] tension_parabola
+  ///   The parabolic horizontal tension, which is set even if it is not
+  ///   within the tolerance.
+  /// \return If the parabolic tension is within the tolerance. The catenary
+  ///   tension is only modified if this is true.
+  bool SolveCorrectionParabola(const double& tension_horizontal,
+                               double& tension_parabola) const;
+
+  /// \brief Solves for the horizontal tension that matches the target sag.
+  /// \param[in] tension_seed
+  ///   The initial horizontal tension.
+  /// \param[in] sag_target
+  ///   The target sag.
+  /// \return The success status of the solve. The catenary tension is
+  ///   modified, and the iteration count is updated.
+  bool SolveCorrectionSag(const double& tension_seed,
+                          const double& sag_target) const;
+
+  /// \brief Updates cached member variables and modifies control variables if
+  ///   update is required.
+  /// \return A boolean indicating if class updates completed successfully.
+  bool Update() const;
+
+  /// \brief Updates the catenary.
+  /// \return The success status of the update.
+  bool UpdateCatenary() const;
+
+  /// \var cable_
+  ///   The cable.
+  const SagCable* cable_;
+
+  /// \var catenary_
+  ///   The catenary for the specified cable temperature.
+  mutable Catenary3d catenary_;
+
+  /// \var curve_
+  ///   The tension-temperature curve of the cable.
+  TensionCurve curve_;
+
+  /// \var is_updated_catenary_
+  ///   An indicator that tells if the catenary is updated.
+  mutable bool is_updated_catenary_;
+
+  /// \var is_warm_started_
+  ///   An indicator that tells if the sag correction solve is warm started.
+  bool is_warm_started_;
+
+  /// \var iterations_correction_
+  ///   The number of solver iterations used for the sag correction.
+  mutable int iterations_correction_;
+
+  /// \var length_
+  ///   The catenary length.
+  mutable double length_;
+
+  /// \var num_solves_
+  ///   The number of catenary solves.
+  mutable int num_solves_;
+
+  /// \var num_solves_parabola_
+  ///   The number of catenary solves evaluated by the parabola.
+  mutable int num_solves_parabola_;
+
+  /// \var num_solves_parabola_fallback_
+  ///   The number of catenary solves that exceeded the parabola tolerance.
+  mutable int num_solves_parabola_fallback_;
+
+  /// \var sag_
+  ///   The catenary sag.
+  mutable double sag_;
+
+  /// \var seed_tension_corrected_
+  ///   The corrected horizontal tension of the previous solve, which seeds the
+  ///   next warm started solve.
+  mutable double seed_tension_corrected_;
+
+  /// \var seed_tension_uncorrected_
+  ///   The uncorrected horizontal tension of the previous solve.
+  mutable double seed_tension_uncorrected_;
+
+  /// \var structure_ahead_
+  ///   The ahead-on-line structure.
+  const SagStructure* structure_ahead_;
+
+  /// \var structure_back_
+  ///   The back-on-line structure.
+  const SagStructure* structure_back_;
+
+  /// \var temperature_
+  ///   The cable temperature.
+  const double* temperature_;
+
+  /// \var tension_uncorrected_
+  ///   The horizontal tension before the sag correction is applied.
+  mutable double tension_uncorrected_;
+
+  /// \var tolerance_parabola_
+  ///   The maximum error of the parabolic sag and length.
+  double tolerance_parabola_;
+};
+
+#endif  // ONSAG_SPAN_CATENARY_SOLVER_H_
@@ -0,0 +1,168 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#ifndef ONSAG_SPAN_INVERSE_SOLVER_H_
+#define ONSAG_SPAN_INVERSE_SOLVER_H_
+
+#include <list>
+#include <vector>
+
+#include "models/base/error_message.h"
+#include "models/base/units.h"
+
+#include "onsag/sag_span.h"
+#include "onsag/span_lookup_table.h"
+#include "onsag/span_sagger.h"
+
+/// \par OVERVIEW
+///
+/// This struct is the result of an inverse solve for a single measurement.
+struct SpanInverseResult {
+ public:
+  /// \brief Constructor.
+  /// The result is initialized to an unsolved state.
+  SpanInverseResult();
+
+  /// \var is_solved
+  ///   An indicator that tells if a matching temperature was found.
+  bool is_solved;
+
+  /// \var iterations
+  ///   The number of root-finding iterations.
+  int iterations;
+
+  /// \var temperature
+  ///   The cable temperature that matches the measurement.
+  double temperature;
+
+  /// \var tension_horizontal
+  ///   The catenary horizontal tension at the temperature.
+  double tension_horizontal;
+};
+
+/// \par OVERVIEW
+///
+/// This class finds the cable temperature (and tension) that matches a field
+/// measurement of a span. The measurement depends on the span sagging method:
+/// - dynamometer: the dynamometer tension
+/// - stopwatch: the stopwatch return time
+/// - transit: the transit angle
+///
+/// \par BRACKETS
+///
+/// The measurement is bracketed with the samples of a span lookup table (see
+/// SpanLookupTable), which is updated when the solver is first used after the
+/// span is set. The samples are searched for the first change in sign of the
+/// difference, so if a measurement matches several temperatures the lowest
+/// one is returned.
+///
+/// \par ROOT FINDING
+///
+/// Within the bracket, Newton iterations are used with a finite difference
+/// slope. The iteration starts from the linear interpolation of the bracket
+/// samples. Any step that leaves the bracket is replaced with a bisection, and
+/// the bracket is narrowed after every iteration, so the solve always
+/// converges. The sagger reuses the cable tension curve that is fitted when
+/// the span is set, so each iteration is a single catenary and sagger solve.
+///
+/// \par BATCH
+///
+/// The table is shared by every measurement, so solving many measurements
+/// for the same span (ex: all of the readings for a shift) only needs a few
+/// iterations per measurement. The table can also be used to query or export
+/// the span values.
+///
+/// \par THREADING
+///
+/// This class is not thread-safe. Each thread should use its own solver.
+class SpanInverseSolver {
+ public:
+  /// \brief Constructor.
+  SpanInverseSolver();
+
+  /// \brief Destructor.
+  ~SpanInverseSolver();
+
+  /// \brief Solves for the temperature that matches a measurement.
+  /// \param[in] measurement
+  ///   The measured value, which depends on the span sagging method.
+  /// \param[out] result
+  ///   The result.
+  /// \return The success status of the solve.
+  bool Solve(const double& measurement, SpanInverseResult& result) const;
+
+  /// \brief Solves for the temperatures that match many measurements.
+  /// \param[in] measurements
+  ///   The measured values, which depend on the span sagging method.
+  /// \param[out] results
+  ///   The results, which are resized to match the measurements.
+  /// \return The number of measurements that could not be solved.
+  int Solve(const std::vector<double>& measurements,
+            std::vector<SpanInverseResult>& results) const;
+
+  /// \brief Validates member variables.
+  /// \param[in] is_included_warnings
+  ///   A flag that tightens the acceptable value range.
+  /// \param[in,out] messages
+  ///   A list of detailed error messages. If this is provided, any validation
+  ///   errors will be appended to the list.
+  /// \return A boolean value indicating status of member variables.
+  bool Validate(const bool& is_included_warnings = true,
+                std::list<ErrorMessage>* messages = nullptr) const;
+
+  /// \brief Sets the span.
+  /// \param[in] span
+  ///   The span.
+  /// The table is recalculated for the span, so the span must be set again
+  /// if it is modified.
+  void set_span(const SagSpan* span);
+
+  /// \brief Sets the unit system.
+  /// \param[in] units
+  ///   The unit system.
+  void set_units(const units::UnitSystem& units);
+
+  /// \brief Gets the span.
+  /// \return The span.
+  const SagSpan* span() const;
+
+  /// \brief Gets the lookup table that brackets the measurements.
+  /// \return The lookup table.
+  const SpanLookupTable& table() const;
+
+  /// \brief Gets the unit system.
+  /// \return The unit system.
+  units::UnitSystem units() const;
+
+ private:
+  /// \brief Calculates the measurement at a temperature.
+  /// \param[in] temperature
+  ///   The cable temperature.
+  /// \param[out] tension_horizontal
+  ///   The catenary horizontal tension.
+  /// \return The measurement, or -999999 if the span could not be solved.
+  double Measurement(const double& temperature,
+                     double& tension_horizontal) const;
+
+  /// \var sagger_
+  ///   The sagger that is used to calculate measurements.
+  mutable SpanSagger sagger_;
+
+  /// \var span_
+  ///   The span.
+  const SagSpan* span_;
+
+  /// \var table_
+  ///   The lookup table that is sampled to bracket measurements.
+  SpanLookupTable table_;
+
+  /// \var temperature_
+  ///   The temperature that the sagger references.
+  mutable double temperature_;
+
+  /// \var units_
+  ///   The unit system.
+  units::UnitSystem units_;
+};
+
+#endif  // ONSAG_SPAN_INVERSE_SOLVER_H_
@@ -0,0 +1,226 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#ifndef ONSAG_SPAN_LOOKUP_TABLE_H_
+#define ONSAG_SPAN_LOOKUP_TABLE_H_
+
+#include <list>
+#include <ostream>
+#include <vector>
+
+#include "models/base/error_message.h"
+#include "models/base/units.h"
+
+#include "onsag/sag_span.h"
+#include "onsag/span_sagger.h"
+
+/// \par OVERVIEW
+///
+/// This class is a precomputed table of the sagging values for a span, which
+/// answers queries at any cable temperature without solving the span. The
+/// table contains:
+/// - horizontal tension
+/// - sag
+/// - transit angle (transit method only)
+/// - dynamometer tension (dynamometer method only)
+/// - stopwatch time (stopwatch method only)
+///
+/// \par SAMPLES
+///
+/// The span is solved at uniformly spaced temperatures across the cable
+/// tension points (shifted by the creep correction) when the table is first
+/// used after the span is set. Each sample stores the values and their
+/// temperature sensitivities, which are solved with the sample (see
+/// SpanSagger).
+///
+/// \par INTERPOLATION
+///
+/// The samples are uniformly spaced, so a query indexes the bracketing
+/// samples directly and interpolates with a cubic Hermite polynomial using the
+/// sample values and slopes. This matches the slope of the span at every
+/// sample, so far fewer samples are needed than for linear interpolation.
+/// Values outside of the table range, or in a segment with an unsolved
+/// sample, are not interpolated.
+///
+/// \par EXPORT
+///
+/// The table can be written as CSV, with one row per sample. The rows contain
+/// each value followed by its slope, so another device can interpolate the
+/// table the same way without the sagging engine.
+///
+/// \par THREADING
+///
+/// This class is not thread-safe until the table is updated. After that,
+/// queries only read the table.
+class SpanLookupTable {
+ public:
+  /// \par OVERVIEW
+  ///
+  /// This enum contains types of table values.
+  enum class ValueType {
+    kAngleTransit,
+    kSag,
+    kTensionDyno,
+    kTensionHorizontal,
+    kTimeStopwatch
+  };
+
+  /// \brief Constructor.
+  SpanLookupTable();
+
+  /// \brief Destructor.
+  ~SpanLookupTable();
+
+  /// \brief Gets the maximum temperature of the table.
+  /// \return The maximum temperature, or -999999 if the table could not be
+  ///   updated.
+  double TemperatureMax() const;
+
+  /// \brief Gets the minimum temperature of the table.
+  /// \return The minimum temperature, or -999999 if the table could not be
+  ///   updated.
+  double TemperatureMin() const;
+
+  /// \brief Gets the temperature of a sample.
+  /// \param[in] index
+  ///   The sample index.
+  /// \return The sample temperature, or -999999 if the table could not be
+  ///   updated or the index is outside of the table.
+  double TemperatureSample(const int& index) const;
+
+  /// \brief Validates member variables.
+  /// \param[in] is_included_warnings
+  ///   A flag that tightens the acceptable value range.
+  /// \param[in,out] messages
+  ///   A list of detailed error messages. If this is provided, any validation
+  ///   errors will be appended to the list.
+  /// \return A boolean value indicating status of member variables.
+  bool Validate(const bool& is_included_warnings = true,
+                std::list<ErrorMessage>* messages = nullptr) const;
+
+  /// \brief Interpolates a value at a temperature.
+  /// \param[in] type
+  ///   The value type.
+  /// \param[in] temperature
+  ///   The cable temperature.
+  /// \return The interpolated value, or -999999 if the temperature is outside
+  ///   of the table, or the value does not apply to the span sagging method.
+  double Value(const ValueType& type, const double& temperature) const;
+
+  /// \brief Gets the value of a sample.
+  /// \param[in] type
+  ///   The value type.
+  /// \param[in] index
+  ///   The sample index.
+  /// \return The sample value, or -999999 if the index is outside of the
+  ///   table, the sample could not be solved, or the value does not apply to
+  ///   the span sagging method.
+  double ValueSample(const ValueType& type, const int& index) const;
+
+  /// \brief Writes the table as CSV.
+  /// \param[out] stream
+  ///   The output stream.
+  /// Values that are not solved are left empty.
+  void Write(std::ostream& stream) const;
+
+  /// \brief Gets the number of temperature samples.
+  /// \return The number of temperature samples.
+  int num_samples() const;
+
+  /// \brief Sets the number of temperature samples.
+  /// \param[in] num_samples
+  ///   The number of temperature samples.
+  void set_num_samples(const int& num_samples);
+
+  /// \brief Sets the span.
+  /// \param[in] span
+  ///   The span.
+  /// The table is recalculated for the span, so the span must be set again if
+  /// it is modified.
+  void set_span(const SagSpan* span);
+
+  /// \brief Sets the unit system.
+  /// \param[in] units
+  ///   The unit system.
+  void set_units(const units::UnitSystem& units);
+
+  /// \brief Gets the span.
+  /// \return The span.
+  const SagSpan* span() const;
+
+  /// \brief Gets the unit system.
+  /// \return The unit system.
+  units::UnitSystem units() const;
+
+ private:
+  /// \var kNumValues
+  ///   The number of values that are stored for each sample.
+  static const int kNumValues;
+
+  /// \brief Determines if class is updated.
+  /// \return A boolean indicating if class is updated.
+  bool IsUpdated() const;
+
+  /// \brief Gets the temperature of a sample.
+  /// \param[in] index
+  ///   The sample index.
+  /// \return The sample temperature.
+  double Temperature(const int& index) const;
+
+  /// \brief Updates cached member variables and modifies control variables if
+  ///   update is required.
+  /// \return A boolean indicating if class updates completed successfully.
+  bool Update() const;
+
+  /// \brief Updates the table samples.
+  /// \return The success status of the update.
+  bool UpdateTable() const;
+
+  /// \var is_updated_table_
+  ///   An indicator that tells if the table is updated.
+  mutable bool is_updated_table_;
+
+  /// \var num_samples_
+  ///   The number of temperature samples.
+  int num_samples_;
+
+  /// \var sagger_
+  ///   The sagger that is used to solve the samples.
+  mutable SpanSagger sagger_;
+
+  /// \var slopes_
+  ///   The temperature slopes of the sample values, with kNumValues for each
+  ///   sample. Slopes that could not be solved are -999999.
+  mutable std::vector<double> slopes_;
+
+  /// \var spacing_temperature_
+  ///   The temperature spacing between samples.
+  mutable double spacing_temperature_;
+
+  /// \var span_
+  ///   The span.
+  const SagSpan* span_;
+
+  /// \var temperature_
+  ///   The temperature that the sagger references.
+  mutable double temperature_;
+
+  /// \var temperature_max_
+  ///   The maximum temperature of the table.
+  mutable double temperature_max_;
+
+  /// \var temperature_min_
+  ///   The minimum temperature of the table.
+  mutable double temperature_min_;
+
+  /// \var units_
+  ///   The unit system.
+  units::UnitSystem units_;
+
+  /// \var values_
+  ///   The sample values, with kNumValues for each sample. Values that do not
+  ///   apply to the method, or that could not be solved, are -999999.
+  mutable std::vector<double> values_;
+};
+
+#endif  // ONSAG_SPAN_LOOKUP_TABLE_H_
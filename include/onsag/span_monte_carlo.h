@@ -0,0 +1,430 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#ifndef ONSAG_SPAN_MONTE_CARLO_H_
+#define ONSAG_SPAN_MONTE_CARLO_H_
+
+#include <cstdint>
+#include <list>
+#include <random>
+#include <vector>
+
+#include "models/base/error_message.h"
+#include "models/base/units.h"
+
+#include "onsag/sag_span.h"
+#include "onsag/span_analyzer.h"
+#include "onsag/span_sagger.h"
+
+/// \par OVERVIEW
+///
+/// This struct contains the standard deviations of the span inputs that are
+/// sampled in an uncertainty analysis. Each input is sampled from an
+/// independent normal distribution centered on the span value.
+struct SpanUncertainty {
+ public:
+  /// \brief Constructor.
+  /// All of the deviations are initialized to zero.
+  SpanUncertainty();
+
+  /// \brief Validates member variables.
+  /// \param[in] is_included_warnings
+  ///   A flag that tightens the acceptable value range.
+  /// \param[in,out] messages
+  ///   A list of detailed error messages. If this is provided, any validation
+  ///   errors will be appended to the list.
+  /// \return A boolean value indicating status of member variables.
+  bool Validate(const bool& is_included_warnings = true,
+                std::list<ErrorMessage>* messages = nullptr) const;
+
+  /// \var deviation_coordinates
+  ///   The standard deviation of the structure attachment survey coordinates.
+  ///   Each coordinate of each attachment is sampled separately.
+  double deviation_coordinates;
+
+  /// \var deviation_creep
+  ///   The standard deviation of the cable creep correction.
+  double deviation_creep;
+
+  /// \var deviation_scale
+  ///   The standard deviation of the cable tension scale factor.
+  double deviation_scale;
+
+  /// \var deviation_tension
+  ///   The standard deviation of the cable tension points, as a fraction of
+  ///   the tension. Each tension point is sampled separately.
+  double deviation_tension;
+
+  /// \var deviation_weight
+  ///   The standard deviation of the cable unit weight, as a fraction of the
+  ///   weight.
+  double deviation_weight;
+};
+
+/// \par OVERVIEW
+///
+/// This struct is the sampled distribution of a single sagging value.
+///
+/// \par HISTOGRAM
+///
+/// The histogram bins are uniformly spaced. Samples that are outside of the
+/// bins are counted separately.
+struct SampleDistribution {
+ public:
+  /// \brief Constructor.
+  /// The distribution is initialized without any samples.
+  SampleDistribution();
+
+  /// \var counts
+  ///   The number of samples in each histogram bin.
+  std::vector<int> counts;
+
+  /// \var deviation
+  ///   The sample standard deviation.
+  double deviation;
+
+  /// \var max
+  ///   The maximum sample.
+  double max;
+
+  /// \var mean
+  ///   The sample mean.
+  double mean;
+
+  /// \var min
+  ///   The minimum sample.
+  double min;
+
+  /// \var num_above
+  ///   The number of samples above the last histogram bin.
+  int num_above;
+
+  /// \var num_below
+  ///   The number of samples below the first histogram bin.
+  int num_below;
+
+  /// \var num_samples
+  ///   The number of samples. This is zero if the value does not apply to the
+  ///   span sagging method.
+  int num_samples;
+
+  /// \var value_begin
+  ///   The lower bound of the first histogram bin.
+  double value_begin;
+
+  /// \var width_bin
+  ///   The width of each histogram bin.
+  double width_bin;
+};
+
+/// \par OVERVIEW
+///
+/// This struct is the uncertainty analysis result at a single temperature.
+struct SpanMonteCarloResult {
+ public:
+  /// \brief Constructor.
+  SpanMonteCarloResult();
+
+  /// \var angle_transit
+  ///   The transit angle distribution. Only applicable for the 'kTransit'
+  ///   sagging method.
+  SampleDistribution angle_transit;
+
+  /// \var num_failures
+  ///   The number of samples that were rejected or could not be solved.
+  int num_failures;
+
+  /// \var sag
+  ///   The catenary sag distribution.
+  SampleDistribution sag;
+
+  /// \var temperature
+  ///   The cable temperature.
+  double temperature;
+
+  /// \var time_stopwatch
+  ///   The stopwatch return time distribution. Only applicable for the
+  ///   'kStopWatch' sagging method.
+  SampleDistribution time_stopwatch;
+};
+
+/// \par OVERVIEW
+///
+/// This class propagates uncertainty in the span inputs through the span
+/// sagger using Monte Carlo sampling. The result is a distribution of the
+/// sag, transit angle, and stopwatch time at each temperature in a sweep.
+///
+/// \par SAMPLES
+///
+/// Each sample perturbs the cable unit weight, tension points, creep
+/// correction, scale factor, and attachment coordinates (see
+/// SpanUncertainty), and then solves every temperature in the sweep. The
+/// tension curve is fitted for every sample, and the temperatures within a
+/// sample are warm started. Samples with an invalid cable (ex: a negative
+/// creep correction or scale factor) are rejected and counted as failures at
+/// every temperature.
+///
+/// \par RANDOM STREAMS
+///
+/// The samples are divided into fixed-size blocks, and each block draws from
+/// its own random number stream that is seeded from the analysis seed and
+/// the block index. The samples therefore do not depend on the number of
+/// threads or the order that the blocks are run in, and the same seed always
+/// reproduces the same results.
+///
+/// \par ACCUMULATION
+///
+/// Each block accumulates its samples into its own histograms and running
+/// moments, so the worker threads never share any mutable state and no
+/// locking is needed. The block accumulators are merged in block order after
+/// all of the blocks are solved, which keeps the floating point results
+/// identical for any number of threads.
+///
+/// \par HISTOGRAM RANGE
+///
+/// The first block is solved before the others are scheduled, and the range
+/// of its samples (widened by half of the range on each side) sets the
+/// histogram bins for the analysis.
+class SpanMonteCarlo {
+ public:
+  /// \brief Constructor.
+  SpanMonteCarlo();
+
+  /// \brief Destructor.
+  ~SpanMonteCarlo();
+
+  /// \brief Runs the analysis.
+  /// \param[in] num_threads
+  ///   The number of worker threads. If less than 1, the number of available
+  ///   CPUs is used.
+  /// \return The success status of the analysis. This is false if the inputs
+  ///   are invalid.
+  bool Run(const int& num_threads = 0);
+
+  /// \brief Validates member variables.
+  /// \param[in] is_included_warnings
+  ///   A flag that tightens the acceptable value range.
+  /// \param[in,out] messages
+  ///   A list of detailed error messages. If this is provided, any validation
+  ///   errors will be appended to the list.
+  /// \return A boolean value indicating status of member variables.
+  bool Validate(const bool& is_included_warnings = true,
+                std::list<ErrorMessage>* messages = nullptr) const;
+
+  /// \brief Gets the number of histogram bins.
+  /// \return The number of histogram bins.
+  int num_bins() const;
+
+  /// \brief Gets the number of samples.
+  /// \return The number of samples.
+  int num_samples() const;
+
+  /// \brief Gets the results.
+  /// \return The results, one for every temperature in the sweep.
+  const std::vector<SpanMonteCarloResult>& results() const;
+
+  /// \brief Gets the random seed.
+  /// \return The random seed.
+  uint64_t seed() const;
+
+  /// \brief Sets the number of histogram bins.
+  /// \param[in] num_bins
+  ///   The number of histogram bins.
+  void set_num_bins(const int& num_bins);
+
+  /// \brief Sets the number of samples.
+  /// \param[in] num_samples
+  ///   The number of samples.
+  void set_num_samples(const int& num_samples);
+
+  /// \brief Sets the random seed.
+  /// \param[in] seed
+  ///   The random seed.
+  void set_seed(const uint64_t& seed);
+
+  /// \brief Sets the span.
+  /// \param[in] span
+  ///   The span.
+  void set_span(const SagSpan* span);
+
+  /// \brief Sets the temperature sweep.
+  /// \param[in] sweep
+  ///   The temperature sweep.
+  void set_sweep(const TemperatureSweep& sweep);
+
+  /// \brief Sets the input uncertainty.
+  /// \param[in] uncertainty
+  ///   The input uncertainty.
+  void set_uncertainty(const SpanUncertainty& uncertainty);
+
+  /// \brief Sets the unit system.
+  /// \param[in] units
+  ///   The unit system.
+  void set_units(const units::UnitSystem& units);
+
+  /// \brief Gets the span.
+  /// \return The span.
+  const SagSpan* span() const;
+
+  /// \brief Gets the temperature sweep.
+  /// \return The temperature sweep.
+  const TemperatureSweep& sweep() const;
+
+  /// \brief Gets the input uncertainty.
+  /// \return The input uncertainty.
+  const SpanUncertainty& uncertainty() const;
+
+  /// \brief Gets the unit system.
+  /// \return The unit system.
+  units::UnitSystem units() const;
+
+ private:
+  /// \par OVERVIEW
+  ///
+  /// This struct accumulates the samples of a single value.
+  struct Accumulator {
+    /// \var counts
+    ///   The number of samples in each histogram bin.
+    std::vector<int> counts;
+
+    /// \var m2
+    ///   The sum of squared differences from the mean.
+    double m2;
+
+    /// \var max
+    ///   The maximum sample.
+    double max;
+
+    /// \var mean
+    ///   The running mean.
+    double mean;
+
+    /// \var min
+    ///   The minimum sample.
+    double min;
+
+    /// \var num_above
+    ///   The number of samples above the last histogram bin.
+    int num_above;
+
+    /// \var num_below
+    ///   The number of samples below the first histogram bin.
+    int num_below;
+
+    /// \var num_samples
+    ///   The number of samples.
+    int num_samples;
+  };
+
+  /// \par OVERVIEW
+  ///
+  /// This struct accumulates all of the samples of a block.
+  struct Block {
+    /// \var accumulators
+    ///   The accumulators, with kNumValues for each temperature.
+    std::vector<Accumulator> accumulators;
+
+    /// \var num_failures
+    ///   The number of failed samples for each temperature.
+    std::vector<int> num_failures;
+  };
+
+  /// \var kNumSamplesBlock
+  ///   The number of samples in each block.
+  static const int kNumSamplesBlock;
+
+  /// \var kNumValues
+  ///   The number of values that are accumulated for each temperature.
+  static const int kNumValues;
+
+  /// \brief Adds a sample to an accumulator.
+  /// \param[in] value
+  ///   The sample value.
+  /// \param[in] value_begin
+  ///   The lower bound of the first histogram bin.
+  /// \param[in] width_bin
+  ///   The width of each histogram bin.
+  /// \param[in,out] accumulator
+  ///   The accumulator.
+  static void Accumulate(const double& value, const double& value_begin,
+                         const double& width_bin, Accumulator& accumulator);
+
+  /// \brief Merges an accumulator into another.
+  /// \param[in] source
+  ///   The accumulator to merge.
+  /// \param[in,out] target
+  ///   The accumulator that is merged into.
+  static void Merge(const Accumulator& source, Accumulator& target);
+
+  /// \brief Samples the span inputs.
+  /// \param[in] span
+  ///   The nominal span.
+  /// \param[in] uncertainty
+  ///   The input uncertainty.
+  /// \param[in,out] generator
+  ///   The random number generator.
+  /// \param[out] sample
+  ///   The sampled span, which must be a copy of the nominal span.
+  static void SampleSpan(const SagSpan& span,
+                         const SpanUncertainty& uncertainty,
+                         std::mt19937_64& generator, SagSpan& sample);
+
+  /// \brief Solves the samples of a block.
+  /// \param[in] index_block
+  ///   The block index.
+  void RunBlock(const int& index_block);
+
+  /// \brief Sets the histogram range from the first block.
+  void UpdateBins();
+
+  /// \var blocks_
+  ///   The block accumulators.
+  std::vector<Block> blocks_;
+
+  /// \var num_bins_
+  ///   The number of histogram bins.
+  int num_bins_;
+
+  /// \var num_samples_
+  ///   The number of samples.
+  int num_samples_;
+
+  /// \var results_
+  ///   The results, one for every temperature.
+  std::vector<SpanMonteCarloResult> results_;
+
+  /// \var seed_
+  ///   The random seed.
+  uint64_t seed_;
+
+  /// \var span_
+  ///   The span.
+  const SagSpan* span_;
+
+  /// \var sweep_
+  ///   The temperature sweep.
+  TemperatureSweep sweep_;
+
+  /// \var temperatures_
+  ///   The temperatures that are analyzed.
+  std::vector<double> temperatures_;
+
+  /// \var uncertainty_
+  ///   The input uncertainty.
+  SpanUncertainty uncertainty_;
+
+  /// \var units_
+  ///   The unit system.
+  units::UnitSystem units_;
+
+  /// \var values_begin_
+  ///   The lower bound of the first histogram bin, with kNumValues for each
+  ///   temperature.
+  std::vector<double> values_begin_;
+
+  /// \var widths_bin_
+  ///   The histogram bin width, with kNumValues for each temperature.
+  std::vector<double> widths_bin_;
+};
+
+#endif  // ONSAG_SPAN_MONTE_CARLO_H_
@@ -10,16 +10,308 @@
 
 #include "models/base/error_message.h"
 #include "models/base/units.h"
-#include "models/sagging/dyno_sagger.h"
-#include "models/sagging/stopwatch_sagger.h"
-#include "models/sagging/transit_sagger.h"
 #include "models/transmissionline/catenary.h"
 
 #include "onsag/sag_cable.h"
 #include "onsag/sag_method.h"
 #include "onsag/sag_structure.h"
+#include "onsag/span_catenary_solver.h"
 
-/// \todo add control factor checks
+/// \par OVERVIEW
+///
+/// This struct is a columnar table of span inputs for batch sagging. Each
+/// column has one entry per span, and the columns must all be the same size.
+struct SpanSaggerInputTable {
+ public:
+  /// \brief Gets the number of spans.
+  /// \return The number of spans, or -1 if the columns are not the same size.
+  int Size() const;
+
+  /// \var cables
+  ///   The cables.
+  std::vector<const SagCable*> cables;
+
+  /// \var methods
+  ///   The sagging methods.
+  std::vector<const SagMethod*> methods;
+
+  /// \var structures_ahead
+  ///   The ahead-on-line structures.
+  std::vector<const SagStructure*> structures_ahead;
+
+  /// \var structures_back
+  ///   The back-on-line structures.
+  std::vector<const SagStructure*> structures_back;
+};
+
+/// \par OVERVIEW
+///
+/// This struct contains the derivatives of the span sagger results with
+/// respect to a single input. Values that do not apply to the sagging method,
+/// or that could not be solved, are -999999.
+struct SpanSaggerSensitivity {
+ public:
+  /// \brief Constructor.
+  /// The derivatives are initialized to an unsolved state.
+  SpanSaggerSensitivity();
+
+  /// \var angle_transit
+  ///   The derivative of the transit angle.
+  double angle_transit;
+
+  /// \var sag
+  ///   The derivative of the catenary sag.
+  double sag;
+
+  /// \var tension_dyno
+  ///   The derivative of the dynamometer tension.
+  double tension_dyno;
+
+  /// \var tension_horizontal
+  ///   The derivative of the catenary horizontal tension.
+  double tension_horizontal;
+
+  /// \var time_stopwatch
+  ///   The derivative of the stopwatch return time.
+  double time_stopwatch;
+};
+
+/// \par OVERVIEW
+///
+/// This struct is the result of a single span sagger solve. All of the values
+/// are filled in one pass when the result is created, and only the values for
+/// the tagged sagging method are valid. Values that do not apply are -999999.
+struct SpanSaggerResult {
+ public:
+  /// \par OVERVIEW
+  ///
+  /// This enum contains types of solve status.
+  enum class StatusType {
+    kNull,
+    kErrorCatenary,
+    kErrorInput,
+    kErrorSagger,
+    kSuccess
+  };
+
+  /// \brief Constructor.
+  /// The result is initialized to an unsolved state.
+  SpanSaggerResult();
+
+  /// \var kNumWavesReturn
+  ///   The number of waves in the stopwatch return time table.
+  static const int kNumWavesReturn;
+
+  /// \var angle_transit
+  ///   The transit angle. Only applicable for the 'kTransit' sagging method.
+  double angle_transit;
+
+  /// \var catenary
+  ///   The catenary. Applicable for all sagging methods.
+  Catenary3d catenary;
+
+  /// \var direction_transit
+  ///   The transit direction along the x-axis. Only applicable for the
+  ///   'kTransit' sagging method.
+  AxisDirectionType direction_transit;
+
+  /// \var distance_target
+  ///   The vertical distance from the attachment to the target. Only
+  ///   applicable for the 'kTransit' sagging method.
+  double distance_target;
+
+  /// \var factor_control
+  ///   The control factor. Only applicable for the 'kTransit' sagging method.
+  double factor_control;
+
+  /// \var iterations_correction
+  ///   The number of solver iterations used for the sag correction.
+  int iterations_correction;
+
+  /// \var length
+  ///   The catenary length, which is parabolic if it is within the parabola
+  ///   tolerance. Applicable for all sagging methods.
+  double length;
+
+  /// \var point_target
+  ///   The target point. Only applicable for the 'kTransit' sagging method.
+  Point2d<double> point_target;
+
+  /// \var sag
+  ///   The catenary sag, which is parabolic if it is within the parabola
+  ///   tolerance. Applicable for all sagging methods.
+  double sag;
+
+  /// \var sensitivity_creep
+  ///   The derivatives with respect to the cable creep correction. These are
+  ///   only solved if sensitivities are enabled in the sagger.
+  SpanSaggerSensitivity sensitivity_creep;
+
+  /// \var sensitivity_temperature
+  ///   The derivatives with respect to the cable temperature. These are only
+  ///   solved if sensitivities are enabled in the sagger.
+  SpanSaggerSensitivity sensitivity_temperature;
+
+  /// \var sensitivity_weight
+  ///   The derivatives with respect to the cable unit weight. These are only
+  ///   solved if sensitivities are enabled in the sagger.
+  SpanSaggerSensitivity sensitivity_weight;
+
+  /// \var speed_wave
+  ///   The traveling wave speed. Only applicable for the 'kStopWatch' sagging
+  ///   method.
+  double speed_wave;
+
+  /// \var status
+  ///   The solve status. The values are only valid if this is 'kSuccess'.
+  StatusType status;
+
+  /// \var tension_dyno
+  ///   The dynamometer tension at the span end that is selected by the
+  ///   method. Only applicable for the 'kDynamometer' sagging method.
+  double tension_dyno;
+
+  /// \var tension_dyno_ahead
+  ///   The dynamometer tension at the ahead-on-line structure. Only
+  ///   applicable for the 'kDynamometer' sagging method.
+  double tension_dyno_ahead;
+
+  /// \var tension_dyno_back
+  ///   The dynamometer tension at the back-on-line structure. Only applicable
+  ///   for the 'kDynamometer' sagging method.
+  double tension_dyno_back;
+
+  /// \var time_stopwatch
+  ///   The stopwatch return time. Only applicable for the 'kStopWatch' sagging
+  ///   method.
+  double time_stopwatch;
+
+  /// \var times_return
+  ///   The stopwatch return times for waves 1 through kNumWavesReturn,
+  ///   indexed by the wave number minus one. Only applicable for the
+  ///   'kStopWatch' sagging method, and empty otherwise.
+  std::vector<double> times_return;
+
+  /// \var type_method
+  ///   The sagging method that was solved.
+  SagMethod::Type type_method;
+};
+
+/// \par OVERVIEW
+///
+/// This struct is a columnar table of batch sagging results. Each column is a
+/// contiguous array with one value per span temperature, stored span-major
+/// (i.e. all of the temperatures for the first span, then the second span).
+/// Values that do not apply to the span sagging method, or that could not be
+/// solved, are -999999.
+struct SpanSaggerResultTable {
+ public:
+  /// \brief Gets the column index of a span temperature.
+  /// \param[in] index_span
+  ///   The span index.
+  /// \param[in] index_temperature
+  ///   The temperature index.
+  /// \return The column index.
+  int Index(const int& index_span, const int& index_temperature) const;
+
+  /// \brief Resizes all columns and resets the values.
+  /// \param[in] num_spans
+  ///   The number of spans.
+  /// \param[in] num_temperatures
+  ///   The number of temperatures.
+  void Resize(const int& num_spans, const int& num_temperatures);
+
+  /// \var angles_transit
+  ///   The transit angles.
+  std::vector<double> angles_transit;
+
+  /// \var distances_target
+  ///   The vertical distances from the attachment to the target.
+  std::vector<double> distances_target;
+
+  /// \var factors_control
+  ///   The transit control factors.
+  std::vector<double> factors_control;
+
+  /// \var is_solved
+  ///   An indicator that tells if the span temperature was solved. This is
+  ///   stored as a char instead of a bool so the column is contiguous.
+  std::vector<char> is_solved;
+
+  /// \var iterations_correction
+  ///   The number of solver iterations used for the sag correction.
+  std::vector<int> iterations_correction;
+
+  /// \var lengths
+  ///   The catenary lengths.
+  std::vector<double> lengths;
+
+  /// \var num_solves_parabola
+  ///   The number of catenary solves evaluated by the parabola.
+  int num_solves_parabola;
+
+  /// \var num_solves_parabola_fallback
+  ///   The number of catenary solves that exceeded the parabola tolerance.
+  int num_solves_parabola_fallback;
+
+  /// \var num_spans
+  ///   The number of spans.
+  int num_spans;
+
+  /// \var num_temperatures
+  ///   The number of temperatures.
+  int num_temperatures;
+
+  /// \var sags
+  ///   The catenary sags.
+  std::vector<double> sags;
+
+  /// \var sensitivities_creep
+  ///   The derivatives with respect to the cable creep correction. These are
+  ///   only solved if sensitivities are enabled for the table.
+  std::vector<SpanSaggerSensitivity> sensitivities_creep;
+
+  /// \var sensitivities_temperature
+  ///   The derivatives with respect to the cable temperature. These are only
+  ///   solved if sensitivities are enabled for the table.
+  std::vector<SpanSaggerSensitivity> sensitivities_temperature;
+
+  /// \var sensitivities_weight
+  ///   The derivatives with respect to the cable unit weight. These are only
+  ///   solved if sensitivities are enabled for the table.
+  std::vector<SpanSaggerSensitivity> sensitivities_weight;
+
+  /// \var speeds_wave
+  ///   The stopwatch traveling wave speeds.
+  std::vector<double> speeds_wave;
+
+  /// \var tensions_dyno
+  ///   The dynamometer tensions.
+  std::vector<double> tensions_dyno;
+
+  /// \var tensions_dyno_ahead
+  ///   The dynamometer tensions at the ahead-on-line structure.
+  std::vector<double> tensions_dyno_ahead;
+
+  /// \var tensions_dyno_back
+  ///   The dynamometer tensions at the back-on-line structure.
+  std::vector<double> tensions_dyno_back;
+
+  /// \var tensions_horizontal
+  ///   The catenary horizontal tensions.
+  std::vector<double> tensions_horizontal;
+
+  /// \var times_return
+  ///   The stopwatch return times for every wave in the return time table.
+  ///   Each span temperature has a contiguous block of
+  ///   SpanSaggerResult::kNumWavesReturn values, starting at the column index
+  ///   multiplied by the number of waves.
+  std::vector<double> times_return;
+
+  /// \var times_stopwatch
+  ///   The stopwatch return times.
+  std::vector<double> times_stopwatch;
+};
 
 /// \par OVERVIEW
 ///
@@ -28,15 +320,9 @@
 ///
 /// \par CATENARY
 ///
-/// A catenary is solved for based on the provided information. The catenary
-/// will reflect the cable tension/position, accounting for:
-/// - Creep Correction: the target temperature is reduced by the creep
-///   correction.
-/// - Temperature: the horizontal tension can vary with temperature. The
-///   horizontal tension at the target tension is solved for using linear
-///   interpolation. Future methods may use polynomial fitting for determining
-///   the horizontal tension.
-/// - Sag Correction: the sag increase/decrease.
+/// The catenary is solved by a SpanCatenarySolver, which accounts for the
+/// creep correction, the cable tension-temperature curve, and the sag
+/// correction. The sag correction solve can be warm started for sweeps.
 ///
 /// \par METHOD SAGGER
 ///
@@ -47,7 +333,51 @@
 ///
 /// Only one sagging method can be selected at a time. The results provided by
 /// this class can be tied to a specific sagging method. Check the method
-/// description to see any restrictions.
+/// description to see any restrictions. The method is selected at run time,
+/// and only the sagger for the selected method is constructed during an
+/// update. If the method is known ahead of time, SpanSaggerT can be used
+/// instead.
+///
+/// \par INVALIDATION
+///
+/// The catenary and the method sagger are updated separately. The cable,
+/// structures, and temperature invalidate both, while the method and units
+/// only invalidate the sagger. Changing the transit location or dynamometer
+/// end (by setting the method again) therefore reuses the solved catenary.
+/// The number of catenary solves, and the number of sagger updates that
+/// reused the catenary, are counted for the lifetime of the class.
+///
+/// \par PARABOLA
+///
+/// Short spans are solved nearly exactly by a parabola. When a parabola
+/// tolerance is set, the sag, length and sag correction are solved in closed
+/// form, and only fall back to the exact catenary if the a-priori error bound
+/// exceeds the tolerance (see SpanCatenarySolver). The number of parabola
+/// solves and fallbacks give the hit rate.
+///
+/// \par RESULT
+///
+/// The Result() method solves and returns all of the values in a single
+/// record, along with a status code. This is preferred over calling several
+/// of the individual getters, which each check if the class is updated.
+///
+/// \par SENSITIVITY
+///
+/// When enabled, the result also contains the derivatives of the sag,
+/// horizontal tension, and method values with respect to the cable
+/// temperature, creep correction, and unit weight. These are solved from the
+/// same catenary without solving any other temperatures (see SpanSaggerT).
+///
+/// \par BATCH SAGGING
+///
+/// The SagTable() method solves many spans for many temperatures in one call,
+/// using a columnar input table and filling a columnar result table. The span
+/// inputs (and the cable tension curve) are set once per span, and each
+/// temperature only updates the catenary and sagger, so the per-call pointer
+/// setup and update checks of the single span interface are skipped. The
+/// temperatures for each span are warm started, and are solved by a
+/// SpanSaggerT that is selected once for the span method. The batch runner
+/// solves its spans this way (see BatchRunner).
 class SpanSagger {
  public:
   /// \brief Constructor.
@@ -80,12 +410,77 @@ class SpanSagger {
   /// method is used.
   double FactorControl() const;
 
+  /// \brief Gets the minimum allowable control factor.
+  /// \param[in] factor_elevation
+  ///   The elevation factor, which is the vertical spacing divided by the
+  ///   horizontal spacing. The sign is ignored.
+  /// \return The minimum allowable control factor. If the elevation factor is
+  ///   outside of the table, -999999 is returned.
+  static double FactorControlMin(const double& factor_elevation);
+
+  /// \brief Gets the minimum allowable control factors for many elevation
+  ///   factors.
+  /// \param[in] num_factors
+  ///   The number of elevation factors.
+  /// \param[in] factors_elevation
+  ///   The elevation factors. The sign is ignored.
+  /// \param[out] factors_control_min
+  ///   The minimum allowable control factors. Elevation factors that are
+  ///   outside of the table are set to -999999.
+  /// This is intended for searching many transit locations at once.
+  static void FactorsControlMin(const int& num_factors,
+                                const double* factors_elevation,
+                                double* factors_control_min);
+
+  /// \brief Gets the number of solver iterations used for the sag correction.
+  /// \return The number of iterations. This is zero if the cable does not
+  ///   have a sag correction, and -999999 if the catenary could not be solved.
+  int IterationsCorrection() const;
+
+  /// \brief Gets the catenary length.
+  /// \return The catenary length, which is parabolic if it is within the
+  ///   parabola tolerance.
+  double Length() const;
+
   /// \brief Gets the target point.
   /// \return The target point.
   /// This method will only return a valid answer if the transit sagging
   /// method is used.
   Point2d<double> PointTarget() const;
 
+  /// \brief Solves and gets the result.
+  /// \return The result. If the inputs are not set, or the catenary or
+  ///   sagger cannot be solved, the status describes the failure.
+  SpanSaggerResult Result() const;
+
+  /// \brief Gets the catenary sag.
+  /// \return The catenary sag, which is parabolic if it is within the
+  ///   parabola tolerance.
+  double Sag() const;
+
+  /// \brief Solves a table of spans for a set of temperatures.
+  /// \param[in] spans
+  ///   The span inputs.
+  /// \param[in] temperatures
+  ///   The temperatures, which are solved for every span.
+  /// \param[in] units
+  ///   The unit system.
+  /// \param[in] is_sensitivity_solved
+  ///   An indicator that tells if the sensitivities are solved.
+  /// \param[in] tolerance_parabola
+  ///   The parabola tolerance. If this is not positive, the parabola is not
+  ///   used.
+  /// \param[out] results
+  ///   The results, which are resized to fit all of the span temperatures.
+  /// \return The number of span temperatures that could not be solved, or -1
+  ///   if the input table columns are not the same size.
+  static int SagTable(const SpanSaggerInputTable& spans,
+                      const std::vector<double>& temperatures,
+                      const units::UnitSystem& units,
+                      const bool& is_sensitivity_solved,
+                      const double& tolerance_parabola,
+                      SpanSaggerResultTable& results);
+
   /// \brief Gets the traveling wave speed.
   /// \return The traveling wave speed.
   double SpeedWave() const;
@@ -96,12 +491,32 @@ class SpanSagger {
   /// method is used.
   double TensionDyno() const;
 
+  /// \brief Gets the dynamometer tension at the ahead-on-line structure.
+  /// \return The dynamometer tension at the ahead-on-line structure.
+  /// This method will only return a valid answer if the dynamometer sagging
+  /// method is used.
+  double TensionDynoAhead() const;
+
+  /// \brief Gets the dynamometer tension at the back-on-line structure.
+  /// \return The dynamometer tension at the back-on-line structure.
+  /// This method will only return a valid answer if the dynamometer sagging
+  /// method is used.
+  double TensionDynoBack() const;
+
   /// \brief Gets the stopwatch time.
   /// \return The stopwatch time.
   /// This method will only return a valid answer if the stopwatch sagging
   /// method is used.
   double TimeStopwatch() const;
 
+  /// \brief Gets the stopwatch return time table.
+  /// \return The stopwatch return times for waves 1 through
+  ///   SpanSaggerResult::kNumWavesReturn, indexed by the wave number minus
+  ///   one. This is empty if the table could not be solved.
+  /// This method will only return a valid answer if the stopwatch sagging
+  /// method is used.
+  std::vector<double> TimesReturn() const;
+
   /// \brief Validates member variables.
   /// \param[in] is_included_warnings
   ///   A flag that tightens the acceptable value range.
@@ -116,18 +531,56 @@ class SpanSagger {
   /// \return The cable.
   const SagCable* cable() const;
 
+  /// \brief Gets if the sensitivities are solved.
+  /// \return If the sensitivities are solved.
+  bool is_sensitivity_solved() const;
+
+  /// \brief Gets if the sag correction solve is warm started.
+  /// \return If the sag correction solve is warm started.
+  bool is_warm_started() const;
+
   /// \brief Gets the method.
   /// \return The method.
   const SagMethod* method() const;
 
+  /// \brief Gets the number of catenary solves.
+  /// \return The number of catenary solves.
+  int num_solves_catenary() const;
+
+  /// \brief Gets the number of catenary solves that were avoided.
+  /// \return The number of sagger updates that reused the solved catenary.
+  int num_solves_catenary_avoided() const;
+
+  /// \brief Gets the number of catenary solves evaluated by the parabola.
+  /// \return The number of catenary solves evaluated by the parabola.
+  int num_solves_parabola() const;
+
+  /// \brief Gets the number of catenary solves that exceeded the parabola
+  ///   tolerance.
+  /// \return The number of catenary solves that fell back to the exact
+  ///   catenary after the parabola was tried.
+  int num_solves_parabola_fallback() const;
+
   /// \brief Sets the cable.
   /// \param[in] cable
   ///   The cable.
   void set_cable(const SagCable* cable);
 
+  /// \brief Sets if the sensitivities are solved.
+  /// \param[in] is_sensitivity_solved
+  ///   An indicator that tells if the sensitivities are solved.
+  void set_is_sensitivity_solved(const bool& is_sensitivity_solved);
+
+  /// \brief Sets if the sag correction solve is warm started.
+  /// \param[in] is_warm_started
+  ///   An indicator that tells if the solve is warm started.
+  void set_is_warm_started(const bool& is_warm_started);
+
   /// \brief Sets the method.
   /// \param[in] method
   ///   The method.
+  /// The solved catenary is reused, so this must also be called if the
+  /// method is modified.
   void set_method(const SagMethod* method);
 
   /// \brief Sets the ahead structure.
@@ -145,6 +598,12 @@ class SpanSagger {
   ///   The temperature.
   void set_temperature(const double* temperature);
 
+  /// \brief Sets the parabola tolerance.
+  /// \param[in] tolerance_parabola
+  ///   The maximum error of the parabolic sag and length. If this is not
+  ///   positive, the parabola is not used.
+  void set_tolerance_parabola(const double& tolerance_parabola);
+
   /// \brief Sets the units.
   /// \param[in] units
   ///   The unit system.
@@ -162,59 +621,81 @@ class SpanSagger {
   /// \return The temperature.
   const double* temperature() const;
 
+  /// \brief Gets the parabola tolerance.
+  /// \return The parabola tolerance.
+  double tolerance_parabola() const;
+
   /// \brief Gets the units.
   /// \return The units.
   units::UnitSystem units() const;
 
  private:
+  /// \var kFactorsControlMin
+  ///   The minimum allowable control factors (i.e. sag at tangency point
+  ///   divided by the maximum sag). The table starts at an elevation factor of
+  ///   zero, and is uniformly spaced so segments are indexed directly.
+  static constexpr double kFactorsControlMin[16] = {
+      0.750, 0.750, 0.850, 0.910, 0.940, 0.960, 0.970, 0.980,
+      0.985, 0.990, 0.992, 0.994, 0.996, 0.997, 0.998, 0.999};
+
+  /// \var kNumFactorsControlMin
+  ///   The number of minimum allowable control factors in the table.
+  static constexpr int kNumFactorsControlMin = 16;
+
+  /// \var kSpacingFactorElevation
+  ///   The elevation factor spacing of the minimum control factor table.
+  static constexpr double kSpacingFactorElevation = 0.05;
+
   /// \brief Determines if class is updated.
   /// \return A boolean indicating if class is updated.
   bool IsUpdated() const;
 
-  /// \brief Determines if the control factor is valid.
-  /// \param[in] factor_control
-  ///   The control factor.
-  /// \return If the control factor is valid.
-  bool IsValidControlFactor(const double& factor_control) const;
-
-  /// \brief Gets the polynomial fitted horizontal tension.
-  /// \param[in] points
-  ///   The points to use for the polynomial fit.
-  /// \param[in] temperature
-  ///   The target temperature.
-  /// \return The polynomial fitted horizontal tension.
-  double TensionHorizontalPolynomialFitted(
-      const std::list<const SagCable::TensionPoint*>& points,
-      const double& temperature) const;
+  /// \brief Solves a span of the table for a set of temperatures.
+  /// \param[in] spans
+  ///   The span inputs.
+  /// \param[in] index_span
+  ///   The span index.
+  /// \param[in] temperatures
+  ///   The temperatures.
+  /// \param[in] units
+  ///   The unit system.
+  /// \param[in] is_sensitivity_solved
+  ///   An indicator that tells if the sensitivities are solved.
+  /// \param[in] tolerance_parabola
+  ///   The parabola tolerance.
+  /// \param[in,out] results
+  ///   The results, which must already be sized for the table.
+  /// \return The number of temperatures that could not be solved.
+  /// The template parameter is the method sagger, which must match the span
+  /// method.
+  template <class Method>
+  static int SagTableSpan(const SpanSaggerInputTable& spans,
+                          const int& index_span,
+                          const std::vector<double>& temperatures,
+                          const units::UnitSystem& units,
+                          const bool& is_sensitivity_solved,
+                          const double& tolerance_parabola,
+                          SpanSaggerResultTable& results);
 
   /// \brief Updates cached member variables and modifies control variables if
   ///   update is required.
   /// \return A boolean indicating if class updates completed successfully.
   bool Update() const;
 
-  /// \brief Updates the catenary.
-  /// \return The success status of the update.
-  bool UpdateCatenary() const;
-
-  /// \brief Updates the target position.
-  /// \return The success status of the update.
-  bool UpdatePointTarget() const;
-
   /// \brief Updates the sagger that is specified for use.
   /// \return The success status of the update.
   bool UpdateSagger() const;
 
-  /// \var cable_
-  ///   The cable.
-  const SagCable* cable_;
-
-  /// \var catenary_
-  ///   The catenary for the specified cable temperature.
-  mutable Catenary3d catenary_;
+  /// \brief Updates a method sagger and fills the cached result.
+  /// \return The success status of the update.
+  /// The template parameter is the method sagger, which must match the
+  /// method type.
+  template <class Method>
+  bool UpdateSaggerMethod() const;
 
-  /// \var is_updated_catenary_
-  ///   An indicator that tells if the class is updated.
-  mutable bool is_updated_catenary_;
+  /// \var is_sensitivity_solved_
+  ///   An indicator that tells if the sensitivities are solved.
+  bool is_sensitivity_solved_;
 
   /// \var is_updated_sagger_
   ///   An indicator that tells if the specific sagger is updated.
@@ -224,43 +705,17 @@ class SpanSagger {
   ///   The sag method.
   const SagMethod* method_;
 
-  /// \var point_target_
-  ///   The target point.
-  mutable Point2d<double> point_target_;
-
-  /// \var points_control_min_
-  ///   The minimum control factor points. The x coordinate is the elevation
-  ///   factor (i.e. vertical spacing divided by the horizontal spacing). The y
-  ///   coordinate is the minimum allowable control factor (i.e. sag at tangency
-  ///   point divided by the maximum sag).
-  std::vector<Point2d<double>> points_control_min_;
-
-  /// \var sagger_dyno_
-  ///   The dyno sagger. This is only updated when the dynamometer sagging
-  ///   method is specified.
-  mutable DynoSagger sagger_dyno_;
-
-  /// \var sagger_stopwatch_
-  ///   The stopwatch sagger. This is only updated when the stopwatch sagging
-  ///   method is specified.
-  mutable StopwatchSagger sagger_stopwatch_;
-
-  /// \var sagger_transit_
-  ///   The transit sagger. This is only updated when the transit sagging
-  ///   method is specified.
-  mutable TransitSagger sagger_transit_;
-
-  /// \var structure_ahead_
-  ///   The ahead-on-line structure.
-  const SagStructure* structure_ahead_;
-
-  /// \var structure_back_
-  ///   The back-on-line structure.
-  const SagStructure* structure_back_;
-
-  /// \var temperature_
-  ///   The cable temperature.
-  const double* temperature_;
+  /// \var num_solves_catenary_avoided_
+  ///   The number of sagger updates that reused the solved catenary.
+  mutable int num_solves_catenary_avoided_;
+
+  /// \var result_
+  ///   The cached result, which is filled when the sagger is updated.
+  mutable SpanSaggerResult result_;
+
+  /// \var solver_catenary_
+  ///   The catenary solver.
+  SpanCatenarySolver solver_catenary_;
 
   /// \var units_
   ///   The unit system.
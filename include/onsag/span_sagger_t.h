@@ -0,0 +1,547 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#ifndef ONSAG_SPAN_SAGGER_T_H_
+#define ONSAG_SPAN_SAGGER_T_H_
+
+#include "models/base/units.h"
+#include "models/sagging/dyno_sagger.h"
+#include "models/sagging/stopwatch_sagger.h"
+#include "models/sagging/transit_sagger.h"
+#include "models/transmissionline/catenary.h"
+
+#include "onsag/sag_cable.h"
+#include "onsag/sag_method.h"
+#include "onsag/sag_structure.h"
+#include "onsag/span_catenary_solver.h"
+#include "onsag/span_sagger.h"
+
+/// \par OVERVIEW
+///
+/// This struct updates and reads a DynoSagger for the 'kDynamometer' sagging
+/// method. It is used as the method parameter of SpanSaggerT.
+struct SaggerDynamometer {
+  /// \var Sagger
+  ///   The sagger type.
+  typedef DynoSagger Sagger;
+
+  /// \var kType
+  ///   The sagging method type.
+  static const SagMethod::Type kType;
+
+  /// \brief Fills the method values of a result.
+  /// \param[in] sagger
+  ///   The updated sagger.
+  /// \param[in] method
+  ///   The sagging method.
+  /// \param[in] structure_ahead
+  ///   The ahead-on-line structure.
+  /// \param[in] structure_back
+  ///   The back-on-line structure.
+  /// \param[in,out] result
+  ///   The result.
+  static void Fill(const Sagger& sagger, const SagMethod& method,
+                   const SagStructure& structure_ahead,
+                   const SagStructure& structure_back,
+                   SpanSaggerResult& result);
+
+  /// \brief Updates the sagger.
+  /// \param[in] catenary
+  ///   The catenary.
+  /// \param[in] method
+  ///   The sagging method.
+  /// \param[in] structure_back
+  ///   The back-on-line structure.
+  /// \param[in] units
+  ///   The unit system.
+  /// \param[out] sagger
+  ///   The sagger.
+  /// \return The success status of the update.
+  static bool Update(const Catenary3d& catenary, const SagMethod& method,
+                     const SagStructure& structure_back,
+                     const units::UnitSystem& units, Sagger& sagger);
+};
+
+/// \par OVERVIEW
+///
+/// This struct updates and reads a StopwatchSagger for the 'kStopWatch'
+/// sagging method. It is used as the method parameter of SpanSaggerT.
+struct SaggerStopWatch {
+  /// \var Sagger
+  ///   The sagger type.
+  typedef StopwatchSagger Sagger;
+
+  /// \var kType
+  ///   The sagging method type.
+  static const SagMethod::Type kType;
+
+  /// \brief Fills the method values of a result.
+  /// \param[in] sagger
+  ///   The updated sagger.
+  /// \param[in] method
+  ///   The sagging method.
+  /// \param[in] structure_ahead
+  ///   The ahead-on-line structure.
+  /// \param[in] structure_back
+  ///   The back-on-line structure.
+  /// \param[in,out] result
+  ///   The result.
+  static void Fill(const Sagger& sagger, const SagMethod& method,
+                   const SagStructure& structure_ahead,
+                   const SagStructure& structure_back,
+                   SpanSaggerResult& result);
+
+  /// \brief Updates the sagger.
+  /// \param[in] catenary
+  ///   The catenary.
+  /// \param[in] method
+  ///   The sagging method.
+  /// \param[in] structure_back
+  ///   The back-on-line structure.
+  /// \param[in] units
+  ///   The unit system.
+  /// \param[out] sagger
+  ///   The sagger.
+  /// \return The success status of the update.
+  static bool Update(const Catenary3d& catenary, const SagMethod& method,
+                     const SagStructure& structure_back,
+                     const units::UnitSystem& units, Sagger& sagger);
+};
+
+/// \par OVERVIEW
+///
+/// This struct updates and reads a TransitSagger for the 'kTransit' sagging
+/// method. It is used as the method parameter of SpanSaggerT.
+///
+/// \par CONTROL FACTOR
+///
+/// The update fails if the control factor is less than the minimum allowable
+/// control factor for the span elevation factor.
+struct SaggerTransit {
+  /// \var Sagger
+  ///   The sagger type.
+  typedef TransitSagger Sagger;
+
+  /// \var kType
+  ///   The sagging method type.
+  static const SagMethod::Type kType;
+
+  /// \brief Fills the method values of a result.
+  /// \param[in] sagger
+  ///   The updated sagger.
+  /// \param[in] method
+  ///   The sagging method.
+  /// \param[in] structure_ahead
+  ///   The ahead-on-line structure.
+  /// \param[in] structure_back
+  ///   The back-on-line structure.
+  /// \param[in,out] result
+  ///   The result.
+  static void Fill(const Sagger& sagger, const SagMethod& method,
+                   const SagStructure& structure_ahead,
+                   const SagStructure& structure_back,
+                   SpanSaggerResult& result);
+
+  /// \brief Updates the sagger.
+  /// \param[in] catenary
+  ///   The catenary.
+  /// \param[in] method
+  ///   The sagging method.
+  /// \param[in] structure_back
+  ///   The back-on-line structure.
+  /// \param[in] units
+  ///   The unit system.
+  /// \param[out] sagger
+  ///   The sagger.
+  /// \return The success status of the update.
+  static bool Update(const Catenary3d& catenary, const SagMethod& method,
+                     const SagStructure& structure_back,
+                     const units::UnitSystem& units, Sagger& sagger);
+};
+
+/// \par OVERVIEW
+///
+/// This class is a span sagger that is specialized for a single sagging
+/// method at compile time (ex: SpanSaggerT<SaggerTransit>).
+///
+/// \par METHOD
+///
+/// The method parameter provides the sagger type, and the functions that
+/// update and read it. Only the sagger for the method is constructed, and the
+/// results are filled without branching on the method type. The method that
+/// is set must match the method parameter, otherwise the result has an input
+/// error status.
+///
+/// \par CATENARY
+///
+/// The catenary is solved by a SpanCatenarySolver, the same as SpanSagger.
+/// The method and units only invalidate the sagger, so the solved catenary is
+/// reused if only those are changed.
+///
+/// \par SELECTION
+///
+/// The method is known when a span is loaded, so batch loops select the
+/// specialized sagger once per span and then solve every temperature without
+/// any method dispatch.
+///
+/// \par SENSITIVITY
+///
+/// The sag and method values only depend on the catenary constant (the ratio
+/// of horizontal tension to unit weight) for a fixed span geometry, and the
+/// dynamometer tension is also proportional to the weight. The slopes with
+/// respect to the horizontal tension are calculated once by updating a
+/// second sagger with a slightly perturbed catenary, and are combined with
+/// the analytic tension slopes from the catenary solver to get the
+/// derivatives for every input. No other temperatures or sag corrections are
+/// solved. The creep correction shifts the temperature, so its derivatives
+/// are the negative of the temperature derivatives.
+template <class Method>
+class SpanSaggerT {
+ public:
+  /// \brief Constructor.
+  SpanSaggerT();
+
+  /// \brief Destructor.
+  ~SpanSaggerT();
+
+  /// \brief Solves and gets the result.
+  /// \return The result. If the inputs are not set, or the catenary or
+  ///   sagger cannot be solved, the status describes the failure.
+  SpanSaggerResult Result() const;
+
+  /// \brief Solves the sensitivities of a result.
+  /// \param[in] solver
+  ///   The catenary solver that solved the result catenary.
+  /// \param[in] method
+  ///   The sagging method.
+  /// \param[in] units
+  ///   The unit system.
+  /// \param[in,out] result
+  ///   The successfully solved result, which has the sensitivities filled.
+  /// \return The success status of the solve.
+  static bool UpdateSensitivities(const SpanCatenarySolver& solver,
+                                  const SagMethod& method,
+                                  const units::UnitSystem& units,
+                                  SpanSaggerResult& result);
+
+  /// \brief Gets if the sensitivities are solved.
+  /// \return If the sensitivities are solved.
+  bool is_sensitivity_solved() const;
+
+  /// \brief Gets the method.
+  /// \return The method.
+  const SagMethod* method() const;
+
+  /// \brief Sets the cable.
+  /// \param[in] cable
+  ///   The cable.
+  void set_cable(const SagCable* cable);
+
+  /// \brief Sets if the sensitivities are solved.
+  /// \param[in] is_sensitivity_solved
+  ///   An indicator that tells if the sensitivities are solved.
+  void set_is_sensitivity_solved(const bool& is_sensitivity_solved);
+
+  /// \brief Sets if the sag correction solve is warm started.
+  /// \param[in] is_warm_started
+  ///   An indicator that tells if the solve is warm started.
+  void set_is_warm_started(const bool& is_warm_started);
+
+  /// \brief Sets the method.
+  /// \param[in] method
+  ///   The method.
+  void set_method(const SagMethod* method);
+
+  /// \brief Sets the ahead structure.
+  /// \param[in] structure_ahead
+  ///   The ahead structure.
+  void set_structure_ahead(const SagStructure* structure_ahead);
+
+  /// \brief Sets the back structure.
+  /// \param[in] structure_back
+  ///   The back structure.
+  void set_structure_back(const SagStructure* structure_back);
+
+  /// \brief Sets the temperature.
+  /// \param[in] temperature
+  ///   The temperature.
+  void set_temperature(const double* temperature);
+
+  /// \brief Sets the parabola tolerance.
+  /// \param[in] tolerance_parabola
+  ///   The maximum error of the parabolic sag and length. If this is not
+  ///   positive, the parabola is not used.
+  void set_tolerance_parabola(const double& tolerance_parabola);
+
+  /// \brief Sets the units.
+  /// \param[in] units
+  ///   The unit system.
+  void set_units(const units::UnitSystem& units);
+
+  /// \brief Gets the catenary solver.
+  /// \return The catenary solver.
+  const SpanCatenarySolver& solver_catenary() const;
+
+  /// \brief Gets the units.
+  /// \return The units.
+  units::UnitSystem units() const;
+
+ private:
+  /// \var is_sensitivity_solved_
+  ///   An indicator that tells if the sensitivities are solved.
+  bool is_sensitivity_solved_;
+
+  /// \var is_updated_sagger_
+  ///   An indicator that tells if the sagger is updated.
+  mutable bool is_updated_sagger_;
+
+  /// \var method_
+  ///   The sag method.
+  const SagMethod* method_;
+
+  /// \var sagger_
+  ///   The method sagger.
+  mutable typename Method::Sagger sagger_;
+
+  /// \var solver_catenary_
+  ///   The catenary solver.
+  SpanCatenarySolver solver_catenary_;
+
+  /// \var units_
+  ///   The unit system.
+  units::UnitSystem units_;
+};
+
+template <class Method>
+SpanSaggerT<Method>::SpanSaggerT() {
+  is_sensitivity_solved_ = false;
+  method_ = nullptr;
+  units_ = units::UnitSystem::kNull;
+
+  is_updated_sagger_ = false;
+}
+
+template <class Method>
+SpanSaggerT<Method>::~SpanSaggerT() {
+}
+
+template <class Method>
+SpanSaggerResult SpanSaggerT<Method>::Result() const {
+  SpanSaggerResult result;
+
+  // checks the method
+  if ((method_ == nullptr) || (method_->type != Method::kType)) {
+    result.status = SpanSaggerResult::StatusType::kErrorInput;
+    return result;
+  }
+
+  result.type_method = Method::kType;
+
+  // updates the catenary if necessary
+  const Catenary3d* catenary = solver_catenary_.Catenary();
+  if (catenary == nullptr) {
+    result.status = SpanSaggerResult::StatusType::kErrorCatenary;
+    return result;
+  }
+
+  // updates the sagger if necessary
+  const SagStructure& structure_ahead = *solver_catenary_.structure_ahead();
+  const SagStructure& structure_back = *solver_catenary_.structure_back();
+  if (is_updated_sagger_ == false) {
+    sagger_ = typename Method::Sagger();
+    is_updated_sagger_ = Method::Update(*catenary, *method_, structure_back,
+                                        units_, sagger_);
+    if (is_updated_sagger_ == false) {
+      result.status = SpanSaggerResult::StatusType::kErrorSagger;
+      return result;
+    }
+  }
+
+  // fills the result
+  result.catenary = *catenary;
+  result.iterations_correction = solver_catenary_.IterationsCorrection();
+  result.length = solver_catenary_.Length();
+  result.sag = solver_catenary_.Sag();
+  Method::Fill(sagger_, *method_, structure_ahead, structure_back, result);
+
+  result.status = SpanSaggerResult::StatusType::kSuccess;
+
+  // solves the sensitivities, which are left unsolved if the slopes can't be
+  // calculated
+  if (is_sensitivity_solved_ == true) {
+    UpdateSensitivities(solver_catenary_, *method_, units_, result);
+  }
+
+  return result;
+}
+
+template <class Method>
+bool SpanSaggerT<Method>::UpdateSensitivities(
+    const SpanCatenarySolver& solver,
+    const SagMethod& method,
+    const units::UnitSystem& units,
+    SpanSaggerResult& result) {
+  const double kStepDerivative = 1e-6;
+
+  // gets the horizontal tension slopes
+  double slope_temperature = -999999;
+  double slope_weight = -999999;
+  if (solver.SlopesTensionHorizontal(slope_temperature, slope_weight)
+      == false) {
+    return false;
+  }
+
+  // updates a sagger with a perturbed horizontal tension
+  const SagStructure& structure_ahead = *solver.structure_ahead();
+  const SagStructure& structure_back = *solver.structure_back();
+  const double tension = result.catenary.tension_horizontal();
+  const double weight = result.catenary.weight_unit().z();
+  const double step = tension * kStepDerivative;
+
+  SpanSaggerResult result_step;
+  result_step.catenary = result.catenary;
+  result_step.catenary.set_tension_horizontal(tension + step);
+
+  typename Method::Sagger sagger;
+  if (Method::Update(result_step.catenary, method, structure_back, units,
+                     sagger) == false) {
+    return false;
+  }
+  Method::Fill(sagger, method, structure_ahead, structure_back, result_step);
+
+  // gets the slopes of the values with respect to the horizontal tension
+  // the sag is an extra value that is solved for every method
+  const int kNumValues = 4;
+  const double values[kNumValues] = {
+      result.angle_transit, result.catenary.Sag(), result.tension_dyno,
+      result.time_stopwatch};
+  const double values_step[kNumValues] = {
+      result_step.angle_transit, result_step.catenary.Sag(),
+      result_step.tension_dyno, result_step.time_stopwatch};
+
+  // gets the exponent of the weight that scales each value at a constant
+  // catenary constant, which is only non-zero for the dynamometer tension
+  const double exponents_weight[kNumValues] = {0, 0, 1, 0};
+
+  double slopes_creep[kNumValues];
+  double slopes_temperature[kNumValues];
+  double slopes_weight[kNumValues];
+  for (int i = 0; i < kNumValues; i++) {
+    if ((values[i] == -999999) || (values_step[i] == -999999)) {
+      slopes_creep[i] = -999999;
+      slopes_temperature[i] = -999999;
+      slopes_weight[i] = -999999;
+      continue;
+    }
+
+    // the partial slope with respect to weight holds the tension constant,
+    // so the catenary constant decreases as the weight increases
+    const double slope_tension = (values_step[i] - values[i]) / step;
+    const double slope_weight_partial =
+        (exponents_weight[i] * values[i] / weight)
+        - (tension / weight * slope_tension);
+
+    slopes_temperature[i] = slope_tension * slope_temperature;
+    slopes_creep[i] = -slopes_temperature[i];
+    slopes_weight[i] = (slope_tension * slope_weight) + slope_weight_partial;
+  }
+
+  // fills the sensitivities
+  result.sensitivity_creep.angle_transit = slopes_creep[0];
+  result.sensitivity_creep.sag = slopes_creep[1];
+  result.sensitivity_creep.tension_dyno = slopes_creep[2];
+  result.sensitivity_creep.tension_horizontal = -slope_temperature;
+  result.sensitivity_creep.time_stopwatch = slopes_creep[3];
+
+  result.sensitivity_temperature.angle_transit = slopes_temperature[0];
+  result.sensitivity_temperature.sag = slopes_temperature[1];
+  result.sensitivity_temperature.tension_dyno = slopes_temperature[2];
+  result.sensitivity_temperature.tension_horizontal = slope_temperature;
+  result.sensitivity_temperature.time_stopwatch = slopes_temperature[3];
+
+  result.sensitivity_weight.angle_transit = slopes_weight[0];
+  result.sensitivity_weight.sag = slopes_weight[1];
+  result.sensitivity_weight.tension_dyno = slopes_weight[2];
+  result.sensitivity_weight.tension_horizontal = slope_weight;
+  result.sensitivity_weight.time_stopwatch = slopes_weight[3];
+
+  return true;
+}
+
+template <class Method>
+bool SpanSaggerT<Method>::is_sensitivity_solved() const {
+  return is_sensitivity_solved_;
+}
+
+template <class Method>
+const SagMethod* SpanSaggerT<Method>::method() const {
+  return method_;
+}
+
+template <class Method>
+void SpanSaggerT<Method>::set_cable(const SagCable* cable) {
+  solver_catenary_.set_cable(cable);
+  is_updated_sagger_ = false;
+}
+
+template <class Method>
+void SpanSaggerT<Method>::set_is_sensitivity_solved(
+    const bool& is_sensitivity_solved) {
+  is_sensitivity_solved_ = is_sensitivity_solved;
+}
+
+template <class Method>
+void SpanSaggerT<Method>::set_is_warm_started(const bool& is_warm_started) {
+  solver_catenary_.set_is_warm_started(is_warm_started);
+}
+
+template <class Method>
+void SpanSaggerT<Method>::set_method(const SagMethod* method) {
+  method_ = method;
+  is_updated_sagger_ = false;
+}
+
+template <class Method>
+void SpanSaggerT<Method>::set_structure_ahead(
+    const SagStructure* structure_ahead) {
+  solver_catenary_.set_structure_ahead(structure_ahead);
+  is_updated_sagger_ = false;
+}
+
+template <class Method>
+void SpanSaggerT<Method>::set_structure_back(
+    const SagStructure* structure_back) {
+  solver_catenary_.set_structure_back(structure_back);
+  is_updated_sagger_ = false;
+}
+
+template <class Method>
+void SpanSaggerT<Method>::set_temperature(const double* temperature) {
+  solver_catenary_.set_temperature(temperature);
+  is_updated_sagger_ = false;
+}
+
+template <class Method>
+void SpanSaggerT<Method>::set_tolerance_parabola(
+    const double& tolerance_parabola) {
+  solver_catenary_.set_tolerance_parabola(tolerance_parabola);
+  is_updated_sagger_ = false;
+}
+
+template <class Method>
+void SpanSaggerT<Method>::set_units(const units::UnitSystem& units) {
+  units_ = units;
+  is_updated_sagger_ = false;
+}
+
+template <class Method>
+const SpanCatenarySolver& SpanSaggerT<Method>::solver_catenary() const {
+  return solver_catenary_;
+}
+
+template <class Method>
+units::UnitSystem SpanSaggerT<Method>::units() const {
+  return units_;
+}
+
+#endif  // ONSAG_SPAN_SAGGER_T_H_
@@ -0,0 +1,130 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#ifndef ONSAG_TENSION_CURVE_H_
+#define ONSAG_TENSION_CURVE_H_
+
+#include <list>
+#include <vector>
+
+#include "models/base/error_message.h"
+
+#include "onsag/sag_cable.h"
+
+/// \par OVERVIEW
+///
+/// This class is the horizontal tension-temperature curve of a sag cable.
+///
+/// \par INTERPOLATION
+///
+/// The curve is a monotone piecewise cubic Hermite spline (Fritsch-Carlson)
+/// through all of the cable tension points. The slopes at the tension points
+/// are a weighted harmonic mean of the neighboring secants, so the curve:
+/// - passes through every tension point
+/// - has a continuous slope, including at the median tension point
+/// - never overshoots the tension points, so the tension never increases as
+///   the temperature increases
+///
+/// \par CACHING
+///
+/// The segment coefficients are calculated when the curve is first evaluated
+/// after the cable is set, and are reused for every temperature after that.
+/// Evaluating a temperature is a binary search of the tension points followed
+/// by a cubic polynomial, and does not allocate any memory. The cable must not
+/// be modified while the curve references it.
+class TensionCurve {
+ public:
+  /// \brief Constructor.
+  TensionCurve();
+
+  /// \brief Destructor.
+  ~TensionCurve();
+
+  /// \brief Gets the slope of the horizontal tension with respect to
+  ///   temperature.
+  /// \param[in] temperature
+  ///   The target temperature. This should already be adjusted for any creep
+  ///   correction.
+  /// \return The analytic derivative of the spline. If the temperature is
+  ///   outside of the tension points, -999999 is returned. The cable scale
+  ///   factor is not applied.
+  double SlopeTensionHorizontal(const double& temperature) const;
+
+  /// \brief Gets the horizontal tension.
+  /// \param[in] temperature
+  ///   The target temperature. This should already be adjusted for any creep
+  ///   correction.
+  /// \return The horizontal tension. If the temperature is outside of the
+  ///   tension points, -999999 is returned. The cable scale factor is not
+  ///   applied.
+  double TensionHorizontal(const double& temperature) const;
+
+  /// \brief Validates member variables.
+  /// \param[in] is_included_warnings
+  ///   A flag that tightens the acceptable value range.
+  /// \param[in,out] messages
+  ///   A list of detailed error messages. If this is provided, any validation
+  ///   errors will be appended to the list.
+  /// \return A boolean value indicating status of member variables.
+  bool Validate(const bool& is_included_warnings = true,
+                std::list<ErrorMessage>* messages = nullptr) const;
+
+  /// \brief Gets the cable.
+  /// \return The cable.
+  const SagCable* cable() const;
+
+  /// \brief Sets the cable.
+  /// \param[in] cable
+  ///   The cable.
+  void set_cable(const SagCable* cable);
+
+ private:
+  /// \par OVERVIEW
+  ///
+  /// This struct is a cubic segment of the curve between two tension points.
+  struct Segment {
+    /// \var coefficients
+    ///   The polynomial coefficients, in ascending order. The polynomial
+    ///   variable is the temperature difference from the segment start.
+    double coefficients[4];
+  };
+
+  /// \brief Gets the segment that contains a temperature.
+  /// \param[in] temperature
+  ///   The target temperature.
+  /// \return The segment index, or -1 if the temperature is outside of the
+  ///   tension points.
+  int IndexSegment(const double& temperature) const;
+
+  /// \brief Determines if class is updated.
+  /// \return A boolean indicating if class is updated.
+  bool IsUpdated() const;
+
+  /// \brief Updates cached member variables and modifies control variables if
+  ///   update is required.
+  /// \return A boolean indicating if class updates completed successfully.
+  bool Update() const;
+
+  /// \brief Updates the spline segments.
+  /// \return The success status of the update.
+  bool UpdateSegments() const;
+
+  /// \var cable_
+  ///   The cable.
+  const SagCable* cable_;
+
+  /// \var is_updated_segments_
+  ///   An indicator that tells if the segments are updated.
+  mutable bool is_updated_segments_;
+
+  /// \var segments_
+  ///   The spline segments, one less than the number of tension points.
+  mutable std::vector<Segment> segments_;
+
+  /// \var temperatures_
+  ///   The tension point temperatures, which bound the segments. This is
+  ///   stored contiguously for searching.
+  mutable std::vector<double> temperatures_;
+};
+
+#endif  // ONSAG_TENSION_CURVE_H_
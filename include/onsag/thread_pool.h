@@ -0,0 +1,145 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#ifndef ONSAG_THREAD_POOL_H_
+#define ONSAG_THREAD_POOL_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/// \par OVERVIEW
+///
+/// This class is a pool of long-lived worker threads that execute tasks.
+///
+/// \par TASKS
+///
+/// A task is a function that accepts the index of the worker thread that is
+/// running it. The worker index is always less than size(), so callers can
+/// keep per-worker state (ex: a span analyzer for each worker) in a vector and
+/// avoid any locking inside the task.
+///
+/// \par SCHEDULING
+///
+/// Each worker thread has its own task queue. Tasks that are added from
+/// outside the pool are distributed among the queues round robin style, and
+/// tasks that are added from within a task go to the queue of the worker that
+/// is running it. A worker runs tasks from the back of its own queue, and when
+/// its queue is empty it steals tasks from the front of the other queues. This
+/// keeps the load balanced when the tasks have very different run times (ex:
+/// a transit span that iterates for a long time mixed in with stopwatch
+/// spans), since a slow task only delays the tasks that no other worker has
+/// taken yet.
+///
+/// \par LIFETIME
+///
+/// The worker threads are created when the pool is constructed and are reused
+/// for every task. They sleep while there is no work, and are joined when the
+/// pool is destroyed.
+///
+/// \par THREAD SAFETY
+///
+/// Tasks can be added from any thread, including from within another task.
+/// The Wait() function must not be called from within a task.
+class ThreadPool {
+ public:
+  /// \var Task
+  ///   The function signature of a task. The parameter is the worker index.
+  typedef std::function<void(const int&)> Task;
+
+  /// \brief Constructor.
+  /// \param[in] num_threads
+  ///   The number of worker threads. If less than 1, the number of available
+  ///   CPUs is used.
+  explicit ThreadPool(const int& num_threads = 0);
+
+  /// \brief Destructor.
+  /// Any tasks that are still queued are completed before the worker threads
+  /// are joined.
+  ~ThreadPool();
+
+  /// \brief Adds a task to the pool.
+  /// \param[in] task
+  ///   The task.
+  void AddTask(const Task& task);
+
+  /// \brief Waits until all tasks have completed.
+  void Wait();
+
+  /// \brief Gets the number of worker threads.
+  /// \return The number of worker threads.
+  int size() const;
+
+ private:
+  /// \par OVERVIEW
+  ///
+  /// This struct is the task queue for a single worker thread.
+  struct WorkerQueue {
+    /// \var mutex
+    ///   The mutex that guards the tasks.
+    std::mutex mutex;
+
+    /// \var tasks
+    ///   The queued tasks.
+    std::deque<Task> tasks;
+  };
+
+  /// \brief Gets a task to run.
+  /// \param[in] index
+  ///   The worker index.
+  /// \param[out] task
+  ///   The task.
+  /// \return If a task was found. The worker queue is searched first, and then
+  ///   the other queues are searched for a task to steal.
+  bool PopTask(const int& index, Task& task);
+
+  /// \brief Runs tasks until the pool is stopped.
+  /// \param[in] index
+  ///   The worker index.
+  void RunWorker(const int index);
+
+  /// \var condition_done_
+  ///   The condition that is signaled when all tasks are completed.
+  std::condition_variable condition_done_;
+
+  /// \var condition_tasks_
+  ///   The condition that is signaled when tasks are added or the pool is
+  ///   stopped.
+  std::condition_variable condition_tasks_;
+
+  /// \var is_stopped_
+  ///   An indicator that tells the worker threads to exit.
+  bool is_stopped_;
+
+  /// \var index_queue_next_
+  ///   The index of the queue that the next task added from outside the pool
+  ///   is assigned to.
+  std::atomic<unsigned int> index_queue_next_;
+
+  /// \var mutex_
+  ///   The mutex that guards the counters and stop indicator.
+  std::mutex mutex_;
+
+  /// \var num_tasks_
+  ///   The number of tasks that are queued or running.
+  int num_tasks_;
+
+  /// \var num_tasks_queued_
+  ///   The number of tasks that are queued and not yet taken by a worker.
+  int num_tasks_queued_;
+
+  /// \var queues_
+  ///   The worker task queues, one for each worker thread.
+  std::vector<std::unique_ptr<WorkerQueue>> queues_;
+
+  /// \var threads_
+  ///   The worker threads.
+  std::vector<std::thread> threads_;
+};
+
+#endif  // ONSAG_THREAD_POOL_H_
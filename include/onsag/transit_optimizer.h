@@ -0,0 +1,224 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#ifndef ONSAG_TRANSIT_OPTIMIZER_H_
+#define ONSAG_TRANSIT_OPTIMIZER_H_
+
+#include <list>
+#include <vector>
+
+#include "models/base/error_message.h"
+#include "models/base/point.h"
+#include "models/transmissionline/catenary.h"
+
+#include "onsag/sag_span.h"
+#include "onsag/span_analyzer.h"
+
+/// \par OVERVIEW
+///
+/// This struct is a candidate transit location that has been evaluated over
+/// every temperature in a sweep.
+struct TransitCandidate {
+ public:
+  /// \brief Constructor.
+  /// The candidate is initialized to an unevaluated state.
+  TransitCandidate();
+
+  /// \var angle_max
+  ///   The maximum transit angle across the sweep.
+  double angle_max;
+
+  /// \var angle_min
+  ///   The minimum transit angle across the sweep.
+  double angle_min;
+
+  /// \var is_feasible
+  ///   An indicator that tells if the control factor is acceptable at every
+  ///   temperature in the sweep.
+  bool is_feasible;
+
+  /// \var margin_control
+  ///   The minimum difference between the control factor and the minimum
+  ///   allowable control factor across the sweep. This is negative if the
+  ///   control factor is not acceptable at some temperature, and -999999 if
+  ///   the transit sagger could not be solved at some temperature.
+  double margin_control;
+
+  /// \var point_transit
+  ///   The transit location.
+  Point2d<double> point_transit;
+};
+
+/// \par OVERVIEW
+///
+/// This class searches a rectangular grid of candidate transit locations for
+/// the location that best satisfies the control factor requirement across a
+/// temperature sweep.
+///
+/// \par GRID
+///
+/// The grid spans the region between two corner points, using the same
+/// coordinate system as the span attachment points. The candidates are stored
+/// row by row, with the horizontal position changing fastest, so the full set
+/// of candidates serves as a feasibility map of the region.
+///
+/// \par EVALUATION
+///
+/// The span catenary does not depend on the transit location, so it is solved
+/// once for each temperature before the search. Each candidate then only
+/// requires a transit sagger solve for every temperature. A candidate is
+/// feasible if its control factor meets the minimum allowable control factor
+/// at every temperature.
+///
+/// \par SELECTION
+///
+/// The best candidate is the feasible candidate with the largest control
+/// factor margin, which keeps the most tolerance for the transit setup in the
+/// field. Ties are resolved to the first candidate in the grid.
+///
+/// \par THREADING
+///
+/// Each grid row is evaluated as a separate task in a worker pool. The tasks
+/// only read the solved catenaries and write to their own candidates, so no
+/// locking is required.
+class TransitOptimizer {
+ public:
+  /// \brief Constructor.
+  TransitOptimizer();
+
+  /// \brief Destructor.
+  ~TransitOptimizer();
+
+  /// \brief Gets the best candidate.
+  /// \return The best candidate, or nullptr if there are no feasible
+  ///   candidates. This is valid until the next optimization.
+  const TransitCandidate* CandidateBest() const;
+
+  /// \brief Evaluates every candidate in the grid.
+  /// \param[in] num_threads
+  ///   The number of worker threads. If less than 1, the number of available
+  ///   CPUs is used.
+  /// \return The success status of the optimization. This is false if the
+  ///   inputs are invalid, and is true even if no candidates are feasible.
+  bool Optimize(const int& num_threads = 0);
+
+  /// \brief Validates member variables.
+  /// \param[in] is_included_warnings
+  ///   A flag that tightens the acceptable value range.
+  /// \param[in,out] messages
+  ///   A list of detailed error messages. If this is provided, any validation
+  ///   errors will be appended to the list.
+  /// \return A boolean value indicating status of member variables.
+  bool Validate(const bool& is_included_warnings = true,
+                std::list<ErrorMessage>* messages = nullptr) const;
+
+  /// \brief Gets the evaluated candidates.
+  /// \return The candidates, row by row.
+  const std::vector<TransitCandidate>& candidates() const;
+
+  /// \brief Gets the number of grid points in the horizontal direction.
+  /// \return The number of grid points in the horizontal direction.
+  int num_points_x() const;
+
+  /// \brief Gets the number of grid points in the vertical direction.
+  /// \return The number of grid points in the vertical direction.
+  int num_points_y() const;
+
+  /// \brief Gets the grid corner with the maximum coordinates.
+  /// \return The grid corner with the maximum coordinates.
+  const Point2d<double>& point_max() const;
+
+  /// \brief Gets the grid corner with the minimum coordinates.
+  /// \return The grid corner with the minimum coordinates.
+  const Point2d<double>& point_min() const;
+
+  /// \brief Sets the number of grid points in the horizontal direction.
+  /// \param[in] num_points_x
+  ///   The number of grid points in the horizontal direction.
+  void set_num_points_x(const int& num_points_x);
+
+  /// \brief Sets the number of grid points in the vertical direction.
+  /// \param[in] num_points_y
+  ///   The number of grid points in the vertical direction.
+  void set_num_points_y(const int& num_points_y);
+
+  /// \brief Sets the grid corner with the maximum coordinates.
+  /// \param[in] point_max
+  ///   The grid corner with the maximum coordinates.
+  void set_point_max(const Point2d<double>& point_max);
+
+  /// \brief Sets the grid corner with the minimum coordinates.
+  /// \param[in] point_min
+  ///   The grid corner with the minimum coordinates.
+  void set_point_min(const Point2d<double>& point_min);
+
+  /// \brief Sets the span.
+  /// \param[in] span
+  ///   The span.
+  void set_span(const SagSpan* span);
+
+  /// \brief Sets the temperature sweep.
+  /// \param[in] sweep
+  ///   The temperature sweep.
+  void set_sweep(const TemperatureSweep& sweep);
+
+  /// \brief Gets the span.
+  /// \return The span.
+  const SagSpan* span() const;
+
+  /// \brief Gets the temperature sweep.
+  /// \return The temperature sweep.
+  const TemperatureSweep& sweep() const;
+
+ private:
+  /// \brief Evaluates a row of candidates.
+  /// \param[in] index_row
+  ///   The grid row index.
+  void EvaluateRow(const int& index_row);
+
+  /// \brief Solves the span catenary at every temperature in the sweep.
+  /// \return The success status of the solve.
+  bool UpdateCatenaries();
+
+  /// \var candidates_
+  ///   The candidates, row by row.
+  std::vector<TransitCandidate> candidates_;
+
+  /// \var catenaries_
+  ///   The span catenaries, one for every temperature in the sweep.
+  std::vector<Catenary3d> catenaries_;
+
+  /// \var factor_control_min_
+  ///   The minimum allowable control factor for the span.
+  double factor_control_min_;
+
+  /// \var index_best_
+  ///   The index of the best candidate, or -1 if no candidates are feasible.
+  int index_best_;
+
+  /// \var num_points_x_
+  ///   The number of grid points in the horizontal direction.
+  int num_points_x_;
+
+  /// \var num_points_y_
+  ///   The number of grid points in the vertical direction.
+  int num_points_y_;
+
+  /// \var point_max_
+  ///   The grid corner with the maximum coordinates.
+  Point2d<double> point_max_;
+
+  /// \var point_min_
+  ///   The grid corner with the minimum coordinates.
+  Point2d<double> point_min_;
+
+  /// \var span_
+  ///   The span.
+  const SagSpan* span_;
+
+  /// \var sweep_
+  ///   The temperature sweep.
+  TemperatureSweep sweep_;
+};
+
+#endif  // ONSAG_TRANSIT_OPTIMIZER_H_
@@ -3,269 +3,364 @@
 
 #include "onsag/analysis_controller.h"
 
+#include <algorithm>
+#include <set>
+
 #include "appcommon/widgets/status_bar_log.h"
 #include "appcommon/widgets/timer.h"
 #include "models/base/helper.h"
 #include "wx/wx.h"
 
 #include "onsag/on_sag_app.h"
+#include "onsag/on_sag_doc.h"
 
-AnalysisThread::AnalysisThread() : wxThread(wxTHREAD_JOINABLE) {
-  span_ = nullptr;
-}
-
-void AnalysisThread::AddAnalysisJob(AnalysisJob* job) {
-  jobs_.push_back(job);
-}
+const int AnalysisController::kNumTemperaturesJob = 16;
 
-const SagSpan* AnalysisThread::span() const {
-  return span_;
-}
-
-const std::list<ErrorMessage>* AnalysisThread::messages() const {
-  return &messages_;
-}
-
-const SpanSagger* AnalysisThread::sagger() const {
-  return &sagger_;
-}
-
-void AnalysisThread::set_span(const SagSpan* span) {
-  span_ = span;
-}
-
-void AnalysisThread::DoAnalysisJob(const int& index) {
-  std::string message;
-  AnalysisJob* job = *std::next(jobs_.begin(), index);
-
-  // sets up sagger for job
-  sagger_.set_temperature(job->temperature);
-
-  // validates sagger and logs any errors
-  std::list<ErrorMessage> messages;
-  const bool status_sagger = sagger_.Validate(false, &messages);
-  if (status_sagger == false) {
-    // errors were present
-    // adds analysis controller error message to give context
-    ErrorMessage message;
-    message.title = "ANALYSIS THREAD";
-    message.description = "No sagging solution for "
-                          + helper::DoubleToFormattedString(*job->temperature,
-                                                            0)
-                          + " degrees";
-    messages_.push_back(message);
-
-    // adds sagger error messages
-    messages_.splice(messages_.cend(), messages);
+AnalysisController::AnalysisController() {
+  doc_ = nullptr;
+  span_ = nullptr;
+  spans_ = nullptr;
+  tolerance_parabola_ = 0;
+
+  // creates the per-worker analysis state for the thread pool
+  analyzers_.resize(pool_.size());
+  for (auto iter = analyzers_.begin(); iter != analyzers_.end(); iter++) {
+    SpanAnalyzer& analyzer = *iter;
+    analyzer.set_cache(&cache_);
   }
+}
 
-  // populates result
-  SaggingAnalysisResult& result = *job->result;
-
-  result.angle_transit = -999999;
-  result.catenary = Catenary3d();
-  result.direction_transit = AxisDirectionType::kNull;
-  result.distance_target = -999999;
-  result.factor_control = -999999;
-  result.offset_coordinates = Point2d<double>();
-  result.point_target = Point2d<double>();
-  result.speed_wave = -999999;
-  result.temperature_cable = nullptr;
-  result.tension_dyno = -999999;
-  result.time_stopwatch = -999999;
-
-  // caches result if no errors were present
-  if (status_sagger == true) {
-    result.catenary = sagger_.Catenary();
-    result.offset_coordinates = span_->structure_back.point_attachment;
-    result.temperature_cable = job->temperature;
-
-    // selects result based on method type
-    if (sagger_.method()->type == SagMethod::Type::kDynamometer) {
-      result.tension_dyno = sagger_.TensionDyno();
-    } else if (sagger_.method()->type == SagMethod::Type::kStopWatch) {
-      result.speed_wave = sagger_.SpeedWave();
-      result.time_stopwatch = sagger_.TimeStopwatch();
-    } else if (sagger_.method()->type == SagMethod::Type::kTransit) {
-      result.factor_control = sagger_.FactorControl();
-      result.angle_transit = sagger_.AngleTransit();
-      result.direction_transit = sagger_.DirectionTransit();
-      result.point_target = sagger_.PointTarget();
-      result.distance_target = sagger_.DistanceAttachmentToTarget();
-    }
+AnalysisController::~AnalysisController() {
+  // cancels and waits for the workers so no more runs are handed off
+  if (run_ != nullptr) {
+    run_->is_cancelled = true;
   }
+  pool_.Wait();
 }
 
-wxThread::ExitCode AnalysisThread::Entry() {
-  // initializes sagger
-  sagger_.set_cable(&span_->cable);
-  sagger_.set_method(&span_->method);
-  sagger_.set_structure_ahead(&span_->structure_ahead);
-  sagger_.set_structure_back(&span_->structure_back);
-  sagger_.set_units(wxGetApp().config()->units);
-
-  // does all jobs in the list
-  const int kSizeJobs = jobs_.size();
-  for (int i = 0; i < kSizeJobs; i++) {
-    DoAnalysisJob(i);
+void AnalysisController::CancelAnalysis() {
+  if (run_ == nullptr) {
+    return;
   }
 
-  // exits
-  return (wxThread::ExitCode)0;
+  // flags the run so the workers skip the remaining jobs
+  // the run is released by the workers once the queued jobs are drained
+  run_->is_cancelled = true;
+  run_.reset();
+
+  wxLogVerbose("Cancelled running analysis.");
+  status_bar_log::PopText(0);
 }
 
+void AnalysisController::ClearResults() {
+  CancelAnalysis();
 
-AnalysisController::AnalysisController() {
-  span_ = nullptr;
+  results_.clear();
 
-  max_threads_ = wxThread::GetCPUCount();
-  if (max_threads_ == -1) {
-    max_threads_ = 1;
-  }
+  status_bar_log::SetText("Ready", 0);
 }
 
-AnalysisController::~AnalysisController() {
-}
+void AnalysisController::ClearResults(const SagSpan* span) {
+  CancelAnalysis();
 
-void AnalysisController::ClearResults() {
-  results_.clear();
+  results_.erase(span);
+}
 
-  status_bar_log::SetText("Ready", 0);
+bool AnalysisController::IsRunning() const {
+  return run_ != nullptr;
 }
 
 const SaggingAnalysisResult* AnalysisController::Result(
     const int& index) const {
+  const std::vector<SaggingAnalysisResult>& results = *Results();
+
   // checks index
-  const int kSizeResults = results_.size();
+  const int kSizeResults = results.size();
   if ((index < 0) || (kSizeResults <= index)) {
     return nullptr;
   }
 
   // checks if result is valid before returning pointer
-  if (results_.at(index).temperature_cable == nullptr) {
+  if (results.at(index).temperature_cable == nullptr) {
     return nullptr;
   } else {
-    return &results_.at(index);
+    return &results.at(index);
   }
 }
 
 const std::vector<SaggingAnalysisResult>* AnalysisController::Results() const {
-  return &results_;
+  const SpanResultSet* set = ResultSet(span_);
+  if (set == nullptr) {
+    return &results_null_;
+  } else {
+    return &set->results;
+  }
+}
+
+const SpanResultSet* AnalysisController::ResultSet(
+    const SagSpan* span) const {
+  auto iter = results_.find(span);
+  if (iter == results_.cend()) {
+    return nullptr;
+  } else {
+    return &iter->second;
+  }
 }
 
 void AnalysisController::RunAnalysis() {
   std::string message;
 
-  // clears cached results
-  ClearResults();
+  // cancels any stale analysis
+  CancelAnalysis();
 
-  // checks if span has been selected
-  if (span_ == nullptr) {
-    wxLogVerbose("No span is selected. Aborting analysis.");
+  // checks if document spans have been set
+  if (spans_ == nullptr) {
+    wxLogVerbose("No document spans are set. Aborting analysis.");
     return;
   }
 
-  // validates span
-  std::list <ErrorMessage> errors;
-  if (span_->Validate(false, &errors) == false) {
-    // logs errors
-    for (auto iter = errors.cbegin(); iter != errors.cend(); iter++) {
-      const ErrorMessage& error = *iter;
-      std::string message = "Span: " + span_->description + "  --  "
-                + error.description;
-      wxLogError(message.c_str());
-    }
-
-    wxLogError("Span validation errors are present. Aborting analysis.");
-    status_bar_log::SetText("Span validation error(s) present, see logs", 0);
+  // removes results for spans that were deleted
+  PurgeResults();
+
+  // removes all results if the temperature sweep changed
+  const TemperatureSweep& sweep = wxGetApp().config()->sweep;
+  if ((sweep.type != sweep_.type)
+      || (sweep.num_intervals != sweep_.num_intervals)
+      || (sweep.step != sweep_.step)) {
+    wxLogVerbose("Temperature sweep changed. Clearing cached results.");
+    results_.clear();
+    sweep_ = sweep;
+  }
 
-    return;
+  // removes all results if the parabola tolerance changed
+  const double tolerance_parabola = wxGetApp().config()->tolerance_parabola;
+  if (tolerance_parabola != tolerance_parabola_) {
+    wxLogVerbose("Parabola tolerance changed. Clearing cached results.");
+    results_.clear();
+    tolerance_parabola_ = tolerance_parabola;
   }
 
-  // starts analysis timer
-  Timer timer;
-  timer.Start();
+  // gets all spans that don't have cached results
+  // the activated span is added last so its jobs are solved first
+  std::list<const SagSpan*> spans_solve;
+  for (auto iter = spans_->cbegin(); iter != spans_->cend(); iter++) {
+    const SagSpan* span = &(*iter);
+    if ((span != span_) && (ResultSet(span) == nullptr)) {
+      spans_solve.push_back(span);
+    }
+  }
 
-  // updates analysis temperatures
-  UpdateTemperatures();
+  if ((span_ != nullptr) && (ResultSet(span_) == nullptr)) {
+    spans_solve.push_back(span_);
+  }
 
-  // creates empty set of results that will be populated by worker threads
-  results_.resize(temperatures_.size(), SaggingAnalysisResult());
+  // creates a new run with a copy of the inputs
+  // the unit system is passed to the run so the analysis doesn't access the
+  // app
+  std::shared_ptr<AnalysisRun> run = std::make_shared<AnalysisRun>();
+  run->is_cancelled = false;
+  run->messages.resize(pool_.size());
+  run->num_jobs_completed = 0;
+  run->num_solves_parabola = 0;
+  run->num_solves_parabola_fallback = 0;
+  run->sweep = sweep_;
+  run->tolerance_parabola = tolerance_parabola_;
+  run->units = wxGetApp().config()->units;
 
   // creates a job list
+  int num_temperatures = 0;
   std::list<AnalysisJob> jobs;
-  for (auto iter = temperatures_.cbegin(); iter != temperatures_.cend();
-       iter++) {
-    const int index = std::distance(temperatures_.cbegin(), iter);
-
-    AnalysisJob job;
-    job.temperature = &(*iter);
-    job.result = &results_[index];
-    jobs.push_back(job);
-  }
+  for (auto iter = spans_solve.cbegin(); iter != spans_solve.cend(); iter++) {
+    const SagSpan* span = *iter;
+
+    // validates span
+    std::list <ErrorMessage> errors;
+    if (span->Validate(false, &errors) == false) {
+      // logs errors
+      for (auto it = errors.cbegin(); it != errors.cend(); it++) {
+        const ErrorMessage& error = *it;
+        std::string message = "Span: " + span->description + "  --  "
+                  + error.description;
+        wxLogError(message.c_str());
+      }
 
-  // determines the number of analysis threads to use
-  int num_threads = -1;
-  const int num_jobs = jobs.size();
+      // caches an empty result set so the errors are only logged once
+      SpanResultSet& set = results_[span];
+      set.span = *span;
 
-  if (num_jobs < max_threads_) {
-    num_threads = num_jobs;
-  } else {
-    num_threads = max_threads_;
-  }
+      if (span == span_) {
+        status_bar_log::SetText("Span validation error(s) present, see logs",
+                                0);
+      }
 
-  // creates analysis threads
-  std::list<AnalysisThread*> threads;
-  for (int i = 0; i < num_threads; i++) {
-    AnalysisThread* thread = new AnalysisThread();
-    thread->set_span(span_);
-    threads.push_back(thread);
-  }
+      continue;
+    }
 
-  // adds jobs to threads round robin style
-  auto iter_jobs = jobs.begin();
-  while (iter_jobs != jobs.end()) {
-    for (auto iter = threads.begin(); iter != threads.end(); iter++) {
-      AnalysisThread* thread = *iter;
+    // creates empty set of results that will be populated by worker threads
+    run->spans.emplace_back();
+    AnalysisRunSpan& span_run = run->spans.back();
+    span_run.num_jobs_completed = 0;
+    span_run.span_doc = span;
+    span_run.set.span = *span;
+    span_run.set.temperatures = SpanAnalyzer::Temperatures(span_run.set.span,
+                                                           run->sweep,
+                                                           &errors);
+    span_run.set.results.resize(span_run.set.temperatures.size(),
+                                SaggingAnalysisResult());
+
+    // splits the temperatures into blocks
+    const int kSizeTemperatures = span_run.set.temperatures.size();
+    span_run.num_jobs = 0;
+    for (int index = 0; index < kSizeTemperatures;
+         index += kNumTemperaturesJob) {
+      AnalysisJob job;
+      job.index_begin = index;
+      job.index_end = std::min(index + kNumTemperaturesJob, kSizeTemperatures);
+      job.span = &span_run;
+      jobs.push_back(job);
+
+      span_run.num_jobs++;
+    }
 
-      if (iter_jobs == jobs.cend()) {
-        break;
-      } else {
-        AnalysisJob* job = &(*iter_jobs);
-        thread->AddAnalysisJob(job);
+    num_temperatures += kSizeTemperatures;
 
-        iter_jobs++;
+    // a sweep without temperatures leaves an empty result set, and logs
+    // the reason
+    if (span_run.num_jobs == 0) {
+      for (auto it = errors.cbegin(); it != errors.cend(); it++) {
+        const ErrorMessage& error = *it;
+        std::string message = "Span: " + span->description + "  --  "
+                  + error.description;
+        wxLogError(message.c_str());
       }
+
+      results_[span] = std::move(span_run.set);
+      run->spans.pop_back();
     }
   }
 
+  run->num_jobs = jobs.size();
+
+  // exits if all results are cached
+  if (run->num_jobs == 0) {
+    return;
+  }
+
   // logs analysis start
-  message = "Calculating " + std::to_string(num_jobs)
-            + " sagging solutions using "
-            + std::to_string(num_threads) + " threads.";
+  message = "Calculating " + std::to_string(num_temperatures)
+            + " sagging solutions for " + std::to_string(run->spans.size())
+            + " spans using " + std::to_string(pool_.size()) + " threads.";
   wxLogVerbose(message.c_str());
   status_bar_log::PushText("Running sagging analysis...", 0);
 
-  // starts threads
-  for (auto iter = threads.begin(); iter != threads.end(); iter++) {
-    AnalysisThread* thread = *iter;
-    wxThreadError status = thread->Run();
-    if (status != wxTHREAD_NO_ERROR) {
-      wxLogError("Couldn't start analysis thread");
+  // starts analysis timer
+  run->timer.Start();
+  run_ = run;
+
+  // adds jobs to the thread pool and returns without waiting
+  // each worker uses its own analyzer and message list, so no locking is
+  // needed inside the job
+  for (auto iter = jobs.cbegin(); iter != jobs.cend(); iter++) {
+    const AnalysisJob job = *iter;
+    pool_.AddTask([this, run, job](const int& index_worker) {
+      DoAnalysisJob(index_worker, run, job);
+    });
+  }
+}
+
+void AnalysisController::set_document(wxDocument* doc) {
+  doc_ = doc;
+}
+
+void AnalysisController::set_span(const SagSpan* span) {
+  span_ = span;
+}
+
+void AnalysisController::set_spans(const std::list<SagSpan>* spans) {
+  spans_ = spans;
+}
+
+const SagSpan* AnalysisController::span() const {
+  return span_;
+}
+
+void AnalysisController::DoAnalysisJob(const int& index_worker,
+                                       std::shared_ptr<AnalysisRun> run,
+                                       const AnalysisJob& job) {
+  // solves the block of temperatures, unless the run is stale
+  // the run is checked between temperatures so a long block is abandoned
+  // quickly
+  SpanResultSet& set = job.span->set;
+  SpanAnalyzer& analyzer = analyzers_[index_worker];
+  analyzer.set_span(&set.span);
+  analyzer.set_tolerance_parabola(run->tolerance_parabola);
+  analyzer.set_units(run->units);
+
+  // the analyzer counters are totaled for its lifetime, so the job adds the
+  // difference to the run
+  const int num_solves_parabola = analyzer.num_solves_parabola();
+  const int num_solves_parabola_fallback =
+      analyzer.num_solves_parabola_fallback();
+  for (int i = job.index_begin; i < job.index_end; i++) {
+    if (run->is_cancelled == true) {
+      break;
     }
+
+    analyzer.Analyze(&set.temperatures[i], set.results[i],
+                     &run->messages[index_worker]);
+  }
+  run->num_solves_parabola += analyzer.num_solves_parabola()
+                              - num_solves_parabola;
+  run->num_solves_parabola_fallback += analyzer.num_solves_parabola_fallback()
+                                       - num_solves_parabola_fallback;
+
+  // hands off the span result set to the application thread
+  // this is queued before the run counter is updated, so all spans are
+  // always handed off before the run is completed
+  const int num_jobs_span = ++job.span->num_jobs_completed;
+  if ((run->is_cancelled == false) && (num_jobs_span == job.span->num_jobs)) {
+    CallAfter(&AnalysisController::OnAnalysisSpanCompleted, run, job.span);
+  }
+
+  // updates job counter
+  const int num_jobs_completed = ++run->num_jobs_completed;
+  if (run->is_cancelled == true) {
+    return;
+  }
+
+  // hands off the run to the application thread
+  // the event queue is thread-safe, and the results are not accessed by the
+  // workers after the last job is completed
+  if (num_jobs_completed == run->num_jobs) {
+    CallAfter(&AnalysisController::OnAnalysisCompleted, run);
+    return;
+  }
+
+  // reports progress in 10% steps so the event queue isn't flooded
+  const int step = (10 * num_jobs_completed) / run->num_jobs;
+  const int step_prev = (10 * (num_jobs_completed - 1)) / run->num_jobs;
+  if (step != step_prev) {
+    CallAfter(&AnalysisController::OnAnalysisProgress, run);
+  }
+}
+
+void AnalysisController::OnAnalysisCompleted(
+    std::shared_ptr<AnalysisRun> run) {
+  std::string message;
+
+  // checks if the run was replaced after it was handed off
+  if (run != run_) {
+    return;
   }
+  run_.reset();
 
-  // waits for threads to complete (i.e. joins worker threads back into main)
+  // collects any worker errors and logs
   bool is_errors = false;
-  for (auto iter_thread = threads.begin(); iter_thread != threads.end();
-       iter_thread++) {
-    AnalysisThread* thread = *iter_thread;
-    thread->Wait();
-
-    // collects any thread errors and logs
-    const std::list<ErrorMessage>* messages = thread->messages();
-    for (auto iter_message = messages->cbegin();
-         iter_message != messages->cend(); iter_message++) {
+  for (auto iter = run->messages.cbegin(); iter != run->messages.cend();
+       iter++) {
+    const std::list<ErrorMessage>& messages = *iter;
+    for (auto iter_message = messages.cbegin();
+         iter_message != messages.cend(); iter_message++) {
       is_errors = true;
       const ErrorMessage& message_error = *iter_message;
       std::string str = message_error.title + " - " + message_error.description;
@@ -273,51 +368,92 @@ void AnalysisController::RunAnalysis() {
     }
   }
 
-  // deletes threads
-  for (auto iter = threads.begin(); iter != threads.end(); iter++) {
-    AnalysisThread* thread = *iter;
-    delete thread;
-  }
-
   // stops timer and logs
-  timer.Stop();
+  run->timer.Stop();
   message = "Analysis time = "
-            + helper::DoubleToFormattedString(timer.Duration(), 3) + "s.";
+            + helper::DoubleToFormattedString(run->timer.Duration(), 3) + "s.";
+  wxLogVerbose(message.c_str());
+
+  message = "Result cache: " + std::to_string(cache_.count()) + " results, "
+            + std::to_string(cache_.num_hits()) + " hits, "
+            + std::to_string(cache_.num_misses()) + " misses.";
   wxLogVerbose(message.c_str());
 
+  if (0 < run->tolerance_parabola) {
+    message = "Parabola: " + std::to_string(run->num_solves_parabola)
+              + " solves, " + std::to_string(run->num_solves_parabola_fallback)
+              + " fallbacks.";
+    wxLogVerbose(message.c_str());
+  }
+
+  // clears status bar
+  status_bar_log::PopText(0);
+  status_bar_log::SetText("Ready", 0);
+
+  // posts a view update
+  if (doc_ != nullptr) {
+    UpdateHint hint(UpdateHint::Type::kAnalysisUpdate);
+    doc_->UpdateAllViews(nullptr, &hint);
+  }
+
   // notifies user of any errors
   if (is_errors == true) {
     // notifies user of error
     message = "Analysis encountered error(s). Check logs.";
     wxMessageBox(message);
   }
-
-  // clears status bar
-  status_bar_log::PopText(0);
-  status_bar_log::SetText("Ready", 0);
 }
 
-void AnalysisController::set_span(const SagSpan* span) {
-  span_ = span;
-}
+void AnalysisController::OnAnalysisProgress(
+    std::shared_ptr<AnalysisRun> run) {
+  // checks if the run is stale
+  if (run != run_) {
+    return;
+  }
 
-const SagSpan* AnalysisController::span() const {
-  return span_;
+  const int percent = (100 * run->num_jobs_completed) / run->num_jobs;
+  const std::string message = "Running sagging analysis... "
+                              + std::to_string(percent) + "%";
+  status_bar_log::SetText(message, 0);
 }
 
-bool AnalysisController::UpdateTemperatures() {
-  temperatures_.clear();
+void AnalysisController::OnAnalysisSpanCompleted(
+    std::shared_ptr<AnalysisRun> run,
+    AnalysisRunSpan* span) {
+  // checks if the run is stale
+  // any document edit cancels the run, so the document span is still valid
+  if (run != run_) {
+    return;
+  }
 
-  // gets the lowest temperature
-  const double temperature_low = span_->temperature_base
-                                 - (2 * span_->temperature_interval);
+  // swaps in the new result set
+  // moving the temperature vector keeps its buffer, so the result references
+  // stay valid
+  results_[span->span_doc] = std::move(span->set);
+
+  // posts a view update if the activated span was solved before the rest of
+  // the run
+  if ((span->span_doc == span_) && (run->num_jobs_completed != run->num_jobs)
+      && (doc_ != nullptr)) {
+    UpdateHint hint(UpdateHint::Type::kAnalysisUpdate);
+    doc_->UpdateAllViews(nullptr, &hint);
+  }
+}
 
-  // calculates 5 target temperatures
-  for (int i = 0; i <= 4; i++) {
-    const double temperature = temperature_low
-                               + (i * span_->temperature_interval);
-    temperatures_.push_back(temperature);
+void AnalysisController::PurgeResults() {
+  // gets all of the document spans
+  std::set<const SagSpan*> spans;
+  for (auto iter = spans_->cbegin(); iter != spans_->cend(); iter++) {
+    spans.insert(&(*iter));
   }
 
-  return true;
+  // removes the results for any span that wasn't found
+  auto iter = results_.begin();
+  while (iter != results_.end()) {
+    if (spans.count(iter->first) == 0) {
+      iter = results_.erase(iter);
+    } else {
+      iter++;
+    }
+  }
 }
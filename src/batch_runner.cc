@@ -0,0 +1,950 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#include "onsag/batch_runner.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <sstream>
+#include <thread>
+#include <tuple>
+#include <utility>
+
+#include "models/base/helper.h"
+#include "wx/dir.h"
+#include "wx/filename.h"
+#include "wx/xml/xml.h"
+
+#include "onsag/on_sag_doc_xml_handler.h"
+#include "onsag/sag_span_unit_converter.h"
+#include "onsag/span_inverse_solver.h"
+#include "onsag/span_lookup_table.h"
+#include "onsag/thread_pool.h"
+#include "onsag/transit_optimizer.h"
+
+const int BatchRunner::kNumSolutionsJob = 64;
+
+BatchRunner::BatchRunner() {
+  tolerance_parabola_ = 0;
+}
+
+BatchRunner::~BatchRunner() {
+}
+
+void BatchRunner::AddDocument(const BatchDocument& document) {
+  documents_.push_back(document);
+}
+
+bool BatchRunner::AddPath(const std::string& path) {
+  std::string message;
+
+  // loads a single file
+  if (wxFileName::FileExists(path) == true) {
+    return LoadDocument(path);
+  }
+
+  // checks for a directory
+  if (wxFileName::DirExists(path) == false) {
+    message = path + "  --  Path does not exist. Skipping.";
+    wxLogError(message.c_str());
+    return false;
+  }
+
+  // gets all document files in directory and sorts so the output order is
+  // repeatable
+  wxArrayString filepaths;
+  wxDir::GetAllFiles(path, &filepaths, "*.onsag");
+  filepaths.Sort();
+
+  // loads each document
+  bool status = true;
+  for (unsigned int i = 0; i < filepaths.GetCount(); i++) {
+    const std::string filepath = filepaths[i].ToStdString();
+    if (LoadDocument(filepath) == false) {
+      status = false;
+    }
+  }
+
+  return status;
+}
+
+int BatchRunner::ExportTables(const int& num_samples,
+                              std::ostream& stream) const {
+  std::string message;
+
+  // writes header
+  // a table without a span only writes the header
+  stream << "file,span,";
+  SpanLookupTable().Write(stream);
+
+  int num_errors = 0;
+  for (auto iter = documents_.cbegin(); iter != documents_.cend(); iter++) {
+    const BatchDocument& document = *iter;
+    for (auto it = document.spans.cbegin(); it != document.spans.cend();
+         it++) {
+      const SagSpan& span = *it;
+
+      SpanLookupTable table;
+      table.set_num_samples(num_samples);
+      table.set_span(&span);
+      table.set_units(document.units);
+
+      std::list<ErrorMessage> messages;
+      if (table.Validate(false, &messages) == false) {
+        num_errors++;
+        for (auto it_message = messages.cbegin();
+             it_message != messages.cend(); it_message++) {
+          const ErrorMessage& error = *it_message;
+          message = document.filepath + "  --  Span: " + span.description
+                    + "  --  " + error.title + " - " + error.description;
+          wxLogError(message.c_str());
+        }
+        continue;
+      }
+
+      // writes the table rows, skipping the table header
+      const std::string prefix = FormatCsvString(document.filepath) + ","
+                                 + FormatCsvString(span.description) + ",";
+      std::stringstream stream_table;
+      table.Write(stream_table);
+
+      std::string line;
+      std::getline(stream_table, line);
+      while (std::getline(stream_table, line)) {
+        stream << prefix << line << "\n";
+      }
+    }
+  }
+
+  return num_errors;
+}
+
+bool BatchRunner::LoadDocument(const std::string& filepath) {
+  std::string message;
+
+  message = "Loading document file: " + filepath;
+  wxLogVerbose(message.c_str());
+
+  // attempts to load an xml document
+  wxXmlDocument doc_xml;
+  if (doc_xml.Load(filepath) == false) {
+    message = filepath + "  --  "
+              "Document file contains an invalid xml structure. Skipping.";
+    wxLogError(message.c_str());
+    return false;
+  }
+
+  // checks for valid xml root
+  const wxXmlNode* root = doc_xml.GetRoot();
+  if (root->GetName() != "on_sag_doc") {
+    message = filepath + "  --  "
+              "Document file contains an invalid xml root. Skipping.";
+    wxLogError(message.c_str());
+    return false;
+  }
+
+  // gets unit system attribute from file
+  BatchDocument document;
+  document.filepath = filepath;
+
+  wxString str_units;
+  if (root->GetAttribute("units", &str_units) == false) {
+    message = filepath + "  --  "
+              "Document file is missing units attribute. Skipping.";
+    wxLogError(message.c_str());
+    return false;
+  } else if (str_units == "Imperial") {
+    document.units = units::UnitSystem::kImperial;
+  } else if (str_units == "Metric") {
+    document.units = units::UnitSystem::kMetric;
+  } else {
+    message = filepath + "  --  "
+              "Document file contains an invalid units attribute. Skipping.";
+    wxLogError(message.c_str());
+    return false;
+  }
+
+  // parses the XML node
+  // any parsing errors are logged, but the valid spans are still analyzed
+  const bool status_node = OnSagDocXmlHandler::ParseNode(root, filepath,
+                                                         document.spans);
+
+  // converts units to consistent style
+  for (auto iter = document.spans.begin(); iter != document.spans.end();
+       iter++) {
+    SagSpan& span = *iter;
+    SagSpanUnitConverter::ConvertUnitStyle(document.units,
+                                           units::UnitStyle::kDifferent,
+                                           units::UnitStyle::kConsistent,
+                                           span);
+  }
+
+  AddDocument(document);
+
+  return status_node;
+}
+
+int BatchRunner::OptimizeTransits(const int& num_threads,
+                                  std::ostream& stream) const {
+  std::string message;
+
+  // writes header
+  stream << "file,span,status,transit_x,transit_y,margin_control,angle_min,"
+            "angle_max,feasible_current,margin_control_current\n";
+
+  int num_errors = 0;
+  for (auto iter = documents_.cbegin(); iter != documents_.cend(); iter++) {
+    const BatchDocument& document = *iter;
+    for (auto it = document.spans.cbegin(); it != document.spans.cend();
+         it++) {
+      const SagSpan& span = *it;
+      if (span.method.type != SagMethod::Type::kTransit) {
+        continue;
+      }
+
+      stream << FormatCsvString(document.filepath) << ","
+             << FormatCsvString(span.description) << ",";
+
+      // gets the span sag at the highest sweep temperature, which sets the
+      // depth of the search region
+      std::list<ErrorMessage> messages;
+      const std::vector<double> temperatures =
+          SpanAnalyzer::Temperatures(span, sweep_, &messages);
+
+      SpanAnalyzer analyzer;
+      analyzer.set_span(&span);
+      analyzer.set_tolerance_parabola(tolerance_parabola_);
+      analyzer.set_units(document.units);
+
+      SaggingAnalysisResult result;
+      bool is_solved = false;
+      if ((temperatures.empty() == false)
+          && (analyzer.Validate(false, &messages) == true)) {
+        is_solved = analyzer.Analyze(&temperatures.back(), result,
+                                     &messages);
+      }
+
+      // searches the region behind and below the back attachment
+      TransitOptimizer optimizer;
+      optimizer.set_span(&span);
+      optimizer.set_sweep(sweep_);
+      if (is_solved == true) {
+        const Point2d<double>& point_back =
+            span.structure_back.point_attachment;
+        const double spacing_x = span.structure_ahead.point_attachment.x
+                                 - point_back.x;
+        const double sag = result.sag;
+        optimizer.set_point_min(Point2d<double>(
+            point_back.x - (spacing_x / 4), point_back.y - (2 * sag)));
+        optimizer.set_point_max(point_back);
+        is_solved = optimizer.Optimize(num_threads);
+        if (is_solved == false) {
+          optimizer.Validate(false, &messages);
+        }
+      }
+
+      if (is_solved == false) {
+        num_errors++;
+        for (auto it_message = messages.cbegin();
+             it_message != messages.cend(); it_message++) {
+          const ErrorMessage& error = *it_message;
+          message = document.filepath + "  --  Span: " + span.description
+                    + "  --  " + error.title + " - " + error.description;
+          wxLogError(message.c_str());
+        }
+        stream << "error,,,,,,,\n";
+        continue;
+      }
+
+      // writes the best location, or flags the span if none are feasible
+      const TransitCandidate* candidate = optimizer.CandidateBest();
+      if (candidate == nullptr) {
+        num_errors++;
+        message = document.filepath + "  --  Span: " + span.description
+                  + "  --  No feasible transit location.";
+        wxLogWarning(message.c_str());
+        stream << "infeasible,,,,,,";
+      } else {
+        stream << "ok,"
+               << helper::DoubleToFormattedString(
+                      candidate->point_transit.x, 2) << ","
+               << helper::DoubleToFormattedString(
+                      candidate->point_transit.y, 2) << ","
+               << helper::DoubleToFormattedString(
+                      candidate->margin_control, 4) << ","
+               << helper::DoubleToFormattedString(candidate->angle_min, 4)
+               << ","
+               << helper::DoubleToFormattedString(candidate->angle_max, 4)
+               << ",";
+      }
+
+      // evaluates the existing transit location as a single candidate
+      optimizer.set_num_points_x(1);
+      optimizer.set_num_points_y(1);
+      optimizer.set_point_min(span.method.point_transit);
+      optimizer.set_point_max(span.method.point_transit);
+      if (optimizer.Optimize(num_threads) == false) {
+        stream << ",\n";
+        continue;
+      }
+
+      const TransitCandidate& candidate_current =
+          optimizer.candidates().front();
+      stream << (candidate_current.is_feasible ? "true" : "false") << ","
+             << FormatValue(candidate_current.margin_control, 4, "") << "\n";
+    }
+  }
+
+  return num_errors;
+}
+
+int BatchRunner::RunAnalysis(const int& num_threads) {
+  std::string message;
+
+  // creates a result for every span in every document
+  jobs_.clear();
+  results_.clear();
+  for (auto iter = documents_.cbegin(); iter != documents_.cend(); iter++) {
+    const BatchDocument& document = *iter;
+    for (auto it = document.spans.cbegin(); it != document.spans.cend();
+         it++) {
+      BatchSpanResult result;
+      result.document = &document;
+      result.index_table = -1;
+      result.is_valid = false;
+      result.results = nullptr;
+      result.span = &(*it);
+      results_.push_back(result);
+    }
+  }
+
+  // validates spans and groups them by unit system and temperatures
+  // validation is cheap, so it is done before any jobs are scheduled
+  typedef std::pair<int, std::vector<double>> GroupKey;
+  std::map<GroupKey, std::vector<BatchSpanResult*>> groups;
+  SpanAnalyzer analyzer;
+  int num_temperatures = 0;
+  for (auto iter = results_.begin(); iter != results_.end(); iter++) {
+    BatchSpanResult& result = *iter;
+
+    analyzer.set_span(result.span);
+    analyzer.set_units(result.document->units);
+    if (analyzer.Validate(false, &result.messages) == false) {
+      continue;
+    }
+
+    result.temperatures = SpanAnalyzer::Temperatures(*result.span, sweep_,
+                                                     &result.messages);
+    if (result.temperatures.empty() == true) {
+      continue;
+    }
+
+    result.is_valid = true;
+    groups[GroupKey(static_cast<int>(result.document->units),
+                    result.temperatures)].push_back(&result);
+
+    num_temperatures += result.temperatures.size();
+  }
+
+  // splits each group into jobs with a similar number of solutions
+  for (auto iter = groups.cbegin(); iter != groups.cend(); iter++) {
+    const std::vector<BatchSpanResult*>& results_group = iter->second;
+    const std::vector<double>& temperatures =
+        results_group.front()->temperatures;
+
+    const int kSizeGroup = results_group.size();
+    const int kSizeTemperatures = temperatures.size();
+    const int kNumSpansJob = std::max(1, kNumSolutionsJob / kSizeTemperatures);
+    for (int index = 0; index < kSizeGroup; index += kNumSpansJob) {
+      jobs_.emplace_back();
+      BatchJob& job = jobs_.back();
+      job.temperatures = &temperatures;
+      job.tolerance_parabola = tolerance_parabola_;
+      job.units = results_group.front()->document->units;
+
+      const int kIndexEnd = std::min(index + kNumSpansJob, kSizeGroup);
+      for (int i = index; i < kIndexEnd; i++) {
+        BatchSpanResult* result = results_group[i];
+        result->index_table = job.results_span.size();
+        result->results = &job.results;
+
+        const SagSpan& span = *result->span;
+        job.inputs.cables.push_back(&span.cable);
+        job.inputs.methods.push_back(&span.method);
+        job.inputs.structures_ahead.push_back(&span.structure_ahead);
+        job.inputs.structures_back.push_back(&span.structure_back);
+        job.results_span.push_back(result);
+      }
+    }
+  }
+
+  // determines the number of threads to use
+  int num_threads_used = num_threads;
+  if (num_threads_used < 1) {
+    num_threads_used = std::thread::hardware_concurrency();
+  }
+  if (num_threads_used < 1) {
+    num_threads_used = 1;
+  }
+
+  const int kSizeJobs = jobs_.size();
+  num_threads_used = std::max(1, std::min(num_threads_used, kSizeJobs));
+
+  message = "Analyzing " + std::to_string(results_.size()) + " spans ("
+            + std::to_string(num_temperatures) + " sagging solutions in "
+            + std::to_string(kSizeJobs) + " tables) using "
+            + std::to_string(num_threads_used) + " threads.";
+  wxLogVerbose(message.c_str());
+
+  // adds a task for every job to a worker pool and waits for completion
+  // each job only modifies its own table and span results, so the tasks do
+  // not share any state
+  ThreadPool pool(num_threads_used);
+  for (auto iter = jobs_.begin(); iter != jobs_.end(); iter++) {
+    BatchJob* job = &(*iter);
+    pool.AddTask([job](const int& /**index_worker**/) {
+      BatchRunner::AnalyzeJob(*job);
+    });
+  }
+  pool.Wait();
+
+  // logs the parabola hit rate
+  if (0 < tolerance_parabola_) {
+    int num_solves_parabola = 0;
+    int num_solves_parabola_fallback = 0;
+    for (auto iter = jobs_.cbegin(); iter != jobs_.cend(); iter++) {
+      const BatchJob& job = *iter;
+      num_solves_parabola += job.results.num_solves_parabola;
+      num_solves_parabola_fallback += job.results.num_solves_parabola_fallback;
+    }
+
+    message = "Parabola: " + std::to_string(num_solves_parabola)
+              + " solves, " + std::to_string(num_solves_parabola_fallback)
+              + " fallbacks.";
+    wxLogVerbose(message.c_str());
+  }
+
+  // logs any errors and counts the failed spans
+  int num_errors = 0;
+  for (auto iter = results_.cbegin(); iter != results_.cend(); iter++) {
+    const BatchSpanResult& result = *iter;
+    if (result.is_valid == true) {
+      continue;
+    }
+
+    num_errors++;
+    for (auto it = result.messages.cbegin(); it != result.messages.cend();
+         it++) {
+      const ErrorMessage& error = *it;
+      message = result.document->filepath + "  --  Span: "
+                + result.span->description + "  --  " + error.title + " - "
+                + error.description;
+      wxLogError(message.c_str());
+    }
+  }
+
+  return num_errors;
+}
+
+int BatchRunner::SolveReadings(std::istream& readings,
+                               std::ostream& stream) const {
+  std::string message;
+
+  // indexes the spans by description, keeping the first match
+  typedef std::pair<const BatchDocument*, const SagSpan*> SpanEntry;
+  std::map<std::string, SpanEntry> spans;
+  for (auto iter = documents_.cbegin(); iter != documents_.cend(); iter++) {
+    const BatchDocument& document = *iter;
+    for (auto it = document.spans.cbegin(); it != document.spans.cend();
+         it++) {
+      spans.insert(std::make_pair(it->description,
+                                  SpanEntry(&document, &(*it))));
+    }
+  }
+
+  // writes header
+  stream << "file,span,measurement,status,temperature,tension_horizontal\n";
+
+  // solves each reading, sharing a solver for each span so the lookup table
+  // is only updated once
+  std::map<const SagSpan*, SpanInverseSolver> solvers;
+  int num_errors = 0;
+  int num_line = 0;
+  std::string line;
+  while (std::getline(readings, line)) {
+    num_line++;
+    if (num_line == 1) {
+      continue;
+    }
+
+    // strips any carriage return and skips blank lines
+    if ((line.empty() == false) && (line.back() == '\r')) {
+      line.pop_back();
+    }
+    if (line.empty() == true) {
+      continue;
+    }
+
+    // parses the span and measurement
+    const std::vector<std::string> fields = ParseCsvLine(line);
+    double measurement = -999999;
+    bool is_parsed = false;
+    if (fields.size() == 2) {
+      const char* str_measurement = fields[1].c_str();
+      char* end = nullptr;
+      measurement = std::strtod(str_measurement, &end);
+      is_parsed = (end != str_measurement) && (*end == '\0');
+    }
+
+    if (is_parsed == false) {
+      num_errors++;
+      message = "Readings line " + std::to_string(num_line)
+                + "  --  Invalid reading. Skipping.";
+      wxLogError(message.c_str());
+      continue;
+    }
+
+    const std::string& description = fields[0];
+    auto iter = spans.find(description);
+    if (iter == spans.end()) {
+      num_errors++;
+      message = "Readings line " + std::to_string(num_line)
+                + "  --  Span: " + description
+                + "  --  Span does not exist. Skipping.";
+      wxLogError(message.c_str());
+      stream << "," << FormatCsvString(description) << "," << fields[1]
+             << ",error,,\n";
+      continue;
+    }
+
+    const BatchDocument& document = *iter->second.first;
+    const SagSpan* span = iter->second.second;
+
+    // sets up the solver the first time the span is used
+    auto iter_solver = solvers.find(span);
+    if (iter_solver == solvers.end()) {
+      iter_solver = solvers.emplace(std::piecewise_construct,
+                                    std::forward_as_tuple(span),
+                                    std::forward_as_tuple()).first;
+      iter_solver->second.set_span(span);
+      iter_solver->second.set_units(document.units);
+    }
+    const SpanInverseSolver& solver = iter_solver->second;
+
+    // solves and writes the reading
+    stream << FormatCsvString(document.filepath) << ","
+           << FormatCsvString(description) << "," << fields[1] << ",";
+
+    SpanInverseResult result;
+    if (solver.Solve(measurement, result) == false) {
+      num_errors++;
+      message = document.filepath + "  --  Span: " + description
+                + "  --  No cable temperature matches the reading on line "
+                + std::to_string(num_line) + ".";
+      wxLogError(message.c_str());
+      stream << "error,,\n";
+      continue;
+    }
+
+    stream << "ok,"
+           << helper::DoubleToFormattedString(result.temperature, 2) << ","
+           << helper::DoubleToFormattedString(result.tension_horizontal, 1)
+           << "\n";
+  }
+
+  return num_errors;
+}
+
+void BatchRunner::WriteResults(const FormatType& format,
+                               std::ostream& stream) const {
+  if (format == FormatType::kCsv) {
+    WriteCsv(stream);
+  } else if (format == FormatType::kJson) {
+    WriteJson(stream);
+  }
+}
+
+const std::list<BatchDocument>& BatchRunner::documents() const {
+  return documents_;
+}
+
+const std::vector<BatchSpanResult>& BatchRunner::results() const {
+  return results_;
+}
+
+void BatchRunner::set_sweep(const TemperatureSweep& sweep) {
+  sweep_ = sweep;
+}
+
+void BatchRunner::set_tolerance_parabola(const double& tolerance_parabola) {
+  tolerance_parabola_ = tolerance_parabola;
+}
+
+const TemperatureSweep& BatchRunner::sweep() const {
+  return sweep_;
+}
+
+double BatchRunner::tolerance_parabola() const {
+  return tolerance_parabola_;
+}
+
+void BatchRunner::AnalyzeJob(BatchJob& job) {
+  // solves every span temperature in a single table
+  const int num_errors = SpanSagger::SagTable(job.inputs, *job.temperatures,
+                                              job.units, true,
+                                              job.tolerance_parabola,
+                                              job.results);
+  if (num_errors == 0) {
+    return;
+  }
+
+  // analyzes the failed span temperatures individually to get the error
+  // messages
+  SpanAnalyzer analyzer;
+  analyzer.set_tolerance_parabola(job.tolerance_parabola);
+  analyzer.set_units(job.units);
+
+  const int kSizeSpans = job.results_span.size();
+  const int kSizeTemperatures = job.temperatures->size();
+  for (int i = 0; i < kSizeSpans; i++) {
+    BatchSpanResult& result_span = *job.results_span[i];
+    analyzer.set_span(result_span.span);
+
+    for (int j = 0; j < kSizeTemperatures; j++) {
+      if (job.results.is_solved[job.results.Index(i, j)] == true) {
+        continue;
+      }
+
+      result_span.is_valid = false;
+
+      SaggingAnalysisResult result;
+      analyzer.Analyze(&result_span.temperatures[j], result,
+                       &result_span.messages);
+    }
+  }
+}
+
+std::string BatchRunner::FormatCsvString(const std::string& str) {
+  // checks if quotes are required
+  if (str.find_first_of(",\"\r\n") == std::string::npos) {
+    return str;
+  }
+
+  // quotes and escapes any existing quotes
+  std::string str_formatted = "\"";
+  for (auto iter = str.cbegin(); iter != str.cend(); iter++) {
+    const char& c = *iter;
+    if (c == '"') {
+      str_formatted += "\"\"";
+    } else {
+      str_formatted += c;
+    }
+  }
+  str_formatted += "\"";
+
+  return str_formatted;
+}
+
+std::string BatchRunner::FormatJsonSensitivity(
+    const SpanSaggerSensitivity& sensitivity) {
+  return "{\"sag\": " + FormatValue(sensitivity.sag, 6, "null")
+         + ", \"tension_horizontal\": "
+         + FormatValue(sensitivity.tension_horizontal, 6, "null")
+         + ", \"angle_transit\": "
+         + FormatValue(sensitivity.angle_transit, 6, "null")
+         + ", \"tension_dyno\": "
+         + FormatValue(sensitivity.tension_dyno, 6, "null")
+         + ", \"time_stopwatch\": "
+         + FormatValue(sensitivity.time_stopwatch, 6, "null") + "}";
+}
+
+std::string BatchRunner::FormatJsonString(const std::string& str) {
+  std::string str_formatted = "\"";
+  for (auto iter = str.cbegin(); iter != str.cend(); iter++) {
+    const char& c = *iter;
+    if (c == '"') {
+      str_formatted += "\\\"";
+    } else if (c == '\\') {
+      str_formatted += "\\\\";
+    } else if (c == '\n') {
+      str_formatted += "\\n";
+    } else if (c == '\r') {
+      str_formatted += "\\r";
+    } else if (c == '\t') {
+      str_formatted += "\\t";
+    } else if ((0 <= c) && (c < 0x20)) {
+      char buffer[8];
+      std::snprintf(buffer, sizeof(buffer), "\\u%04x", c);
+      str_formatted += buffer;
+    } else {
+      str_formatted += c;
+    }
+  }
+  str_formatted += "\"";
+
+  return str_formatted;
+}
+
+std::string BatchRunner::FormatValue(const double& value,
+                                     const int& precision,
+                                     const std::string& str_invalid) {
+  if (value == -999999) {
+    return str_invalid;
+  } else {
+    return helper::DoubleToFormattedString(value, precision);
+  }
+}
+
+std::string BatchRunner::NameMethod(const SagMethod::Type& type) {
+  if (type == SagMethod::Type::kDynamometer) {
+    return "dynamometer";
+  } else if (type == SagMethod::Type::kStopWatch) {
+    return "stopwatch";
+  } else if (type == SagMethod::Type::kTransit) {
+    return "transit";
+  } else {
+    return "";
+  }
+}
+
+std::string BatchRunner::NameUnits(const units::UnitSystem& units) {
+  if (units == units::UnitSystem::kImperial) {
+    return "Imperial";
+  } else if (units == units::UnitSystem::kMetric) {
+    return "Metric";
+  } else {
+    return "";
+  }
+}
+
+std::vector<std::string> BatchRunner::ParseCsvLine(const std::string& line) {
+  std::vector<std::string> fields(1);
+
+  // splits on commas outside of quotes, unescaping any doubled quotes
+  bool is_quoted = false;
+  const int kSizeLine = line.size();
+  for (int i = 0; i < kSizeLine; i++) {
+    const char& c = line[i];
+    if (is_quoted == true) {
+      if ((c == '"') && (i + 1 < kSizeLine) && (line[i + 1] == '"')) {
+        fields.back() += c;
+        i++;
+      } else if (c == '"') {
+        is_quoted = false;
+      } else {
+        fields.back() += c;
+      }
+    } else if (c == '"') {
+      is_quoted = true;
+    } else if (c == ',') {
+      fields.emplace_back();
+    } else {
+      fields.back() += c;
+    }
+  }
+
+  return fields;
+}
+
+void BatchRunner::WriteCsv(std::ostream& stream) const {
+  // writes header
+  stream << "file,span,method,units,temperature,status,tension_horizontal,"
+            "sag,length,factor_control,angle_transit,distance_target,"
+            "tension_dyno,tension_dyno_back,tension_dyno_ahead,speed_wave,"
+            "time_stopwatch";
+  for (int i = 1; i <= SpanSaggerResult::kNumWavesReturn; i++) {
+    stream << ",time_return_" << i;
+  }
+  stream << "\n";
+
+  // the return time table columns are left empty for error rows
+  const std::string str_empty_times(SpanSaggerResult::kNumWavesReturn, ',');
+
+  // writes a row for each span temperature
+  for (auto iter = results_.cbegin(); iter != results_.cend(); iter++) {
+    const BatchSpanResult& result_span = *iter;
+
+    const std::string str_prefix =
+        FormatCsvString(result_span.document->filepath) + ","
+        + FormatCsvString(result_span.span->description) + ","
+        + NameMethod(result_span.span->method.type) + ","
+        + NameUnits(result_span.document->units) + ",";
+
+    // writes a single error row if the span could not be analyzed
+    if (result_span.results == nullptr) {
+      stream << str_prefix << ",error,,,,,,,,,,," << str_empty_times << "\n";
+      continue;
+    }
+
+    const SpanSaggerResultTable& results = *result_span.results;
+    for (auto it = result_span.temperatures.cbegin();
+         it != result_span.temperatures.cend(); it++) {
+      const int index = results.Index(
+          result_span.index_table,
+          std::distance(result_span.temperatures.cbegin(), it));
+
+      stream << str_prefix << helper::DoubleToFormattedString(*it, 1) << ",";
+
+      if (results.is_solved[index] == false) {
+        stream << "error,,,,,,,,,,," << str_empty_times << "\n";
+        continue;
+      }
+
+      stream << "ok,"
+             << helper::DoubleToFormattedString(
+                    results.tensions_horizontal[index], 1) << ","
+             << helper::DoubleToFormattedString(results.sags[index], 3)
+             << ","
+             << helper::DoubleToFormattedString(results.lengths[index], 3)
+             << ","
+             << FormatValue(results.factors_control[index], 4, "") << ","
+             << FormatValue(results.angles_transit[index], 4, "") << ","
+             << FormatValue(results.distances_target[index], 3, "") << ","
+             << FormatValue(results.tensions_dyno[index], 1, "") << ","
+             << FormatValue(results.tensions_dyno_back[index], 1, "") << ","
+             << FormatValue(results.tensions_dyno_ahead[index], 1, "") << ","
+             << FormatValue(results.speeds_wave[index], 3, "") << ","
+             << FormatValue(results.times_stopwatch[index], 3, "");
+
+      // the return time table is invalid for other methods, so the columns
+      // are left empty
+      const double* times_return =
+          &results.times_return[index * SpanSaggerResult::kNumWavesReturn];
+      for (int i = 0; i < SpanSaggerResult::kNumWavesReturn; i++) {
+        stream << "," << FormatValue(times_return[i], 3, "");
+      }
+      stream << "\n";
+    }
+  }
+}
+
+void BatchRunner::WriteJson(std::ostream& stream) const {
+  stream << "{\n  \"documents\": [";
+
+  const BatchDocument* document = nullptr;
+  for (auto iter = results_.cbegin(); iter != results_.cend(); iter++) {
+    const BatchSpanResult& result_span = *iter;
+
+    // starts a new document if necessary
+    if (result_span.document != document) {
+      if (document != nullptr) {
+        stream << "\n      ]\n    },";
+      }
+      document = result_span.document;
+
+      stream << "\n    {\n"
+             << "      \"file\": " << FormatJsonString(document->filepath)
+             << ",\n"
+             << "      \"units\": "
+             << FormatJsonString(NameUnits(document->units)) << ",\n"
+             << "      \"spans\": [";
+    } else {
+      stream << ",";
+    }
+
+    // writes span
+    stream << "\n        {\n"
+           << "          \"description\": "
+           << FormatJsonString(result_span.span->description) << ",\n"
+           << "          \"method\": "
+           << FormatJsonString(NameMethod(result_span.span->method.type))
+           << ",\n"
+           << "          \"valid\": "
+           << (result_span.is_valid ? "true" : "false") << ",\n"
+           << "          \"errors\": [";
+
+    for (auto it = result_span.messages.cbegin();
+         it != result_span.messages.cend(); it++) {
+      const ErrorMessage& error = *it;
+      if (it != result_span.messages.cbegin()) {
+        stream << ", ";
+      }
+      stream << FormatJsonString(error.title + " - " + error.description);
+    }
+    stream << "],\n"
+           << "          \"results\": [";
+
+    // writes results
+    const SpanSaggerResultTable* results = result_span.results;
+    for (auto it = result_span.temperatures.cbegin();
+         it != result_span.temperatures.cend(); it++) {
+      const int index = results->Index(
+          result_span.index_table,
+          std::distance(result_span.temperatures.cbegin(), it));
+
+      if (it != result_span.temperatures.cbegin()) {
+        stream << ",";
+      }
+
+      stream << "\n            {\"temperature\": "
+             << helper::DoubleToFormattedString(*it, 1);
+
+      if (results->is_solved[index] == false) {
+        stream << ", \"valid\": false}";
+        continue;
+      }
+
+      stream << ", \"valid\": true"
+             << ", \"tension_horizontal\": "
+             << helper::DoubleToFormattedString(
+                    results->tensions_horizontal[index], 1)
+             << ", \"sag\": "
+             << helper::DoubleToFormattedString(results->sags[index], 3)
+             << ", \"length\": "
+             << helper::DoubleToFormattedString(results->lengths[index], 3)
+             << ", \"factor_control\": "
+             << FormatValue(results->factors_control[index], 4, "null")
+             << ", \"angle_transit\": "
+             << FormatValue(results->angles_transit[index], 4, "null")
+             << ", \"distance_target\": "
+             << FormatValue(results->distances_target[index], 3, "null")
+             << ", \"tension_dyno\": "
+             << FormatValue(results->tensions_dyno[index], 1, "null")
+             << ", \"tension_dyno_back\": "
+             << FormatValue(results->tensions_dyno_back[index], 1, "null")
+             << ", \"tension_dyno_ahead\": "
+             << FormatValue(results->tensions_dyno_ahead[index], 1, "null")
+             << ", \"speed_wave\": "
+             << FormatValue(results->speeds_wave[index], 3, "null")
+             << ", \"time_stopwatch\": "
+             << FormatValue(results->times_stopwatch[index], 3, "null")
+             << ", \"sensitivity_temperature\": "
+             << FormatJsonSensitivity(
+                    results->sensitivities_temperature[index])
+             << ", \"sensitivity_creep\": "
+             << FormatJsonSensitivity(results->sensitivities_creep[index])
+             << ", \"sensitivity_weight\": "
+             << FormatJsonSensitivity(results->sensitivities_weight[index])
+             << ", \"times_return\": ";
+
+      // the return time table only applies to the stopwatch method
+      if (result_span.span->method.type != SagMethod::Type::kStopWatch) {
+        stream << "null}";
+        continue;
+      }
+
+      const double* times_return =
+          &results->times_return[index * SpanSaggerResult::kNumWavesReturn];
+      stream << "[";
+      for (int i = 0; i < SpanSaggerResult::kNumWavesReturn; i++) {
+        if (i != 0) {
+          stream << ", ";
+        }
+        stream << FormatValue(times_return[i], 3, "null");
+      }
+      stream << "]}";
+    }
+
+    if (result_span.temperatures.empty() == false) {
+      stream << "\n          ";
+    }
+    stream << "]\n        }";
+  }
+
+  if (document != nullptr) {
+    stream << "\n      ]\n    }\n  ";
+  }
+  stream << "]\n}\n";
+}
@@ -0,0 +1,391 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#include "onsag/catenary_kernels.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#if defined(ONSAG_ENABLE_SIMD) && defined(__AVX2__)
+#define ONSAG_CATENARY_KERNELS_AVX2
+#include <immintrin.h>
+#elif defined(ONSAG_ENABLE_SIMD) \
+    && (defined(__SSE2__) || defined(_M_X64) \
+        || (defined(_M_IX86_FP) && (2 <= _M_IX86_FP)))
+#define ONSAG_CATENARY_KERNELS_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+// constants used by the exp/log approximations
+const double kLn2Hi = 6.93147180369123816490e-01;
+const double kLn2Lo = 1.90821492927058770002e-10;
+const double kLog2e = 1.44269504088896338700e+00;
+const double kMagicRound = 6755399441055744.0;  // 1.5 * 2^52
+const double kMagicInt = 4503599627370496.0;  // 2^52
+const double kSqrt2 = 1.41421356237309504880e+00;
+
+/// \par OVERVIEW
+///
+/// This struct is a pack of one double, which is used for the scalar
+/// fallback and for the remainder of the vector loops.
+struct PackScalar {
+  typedef double V;
+  static const int kSize = 1;
+
+  static V Load(const double* p) { return *p; }
+  static void Store(double* p, const V& a) { *p = a; }
+  static V Set(const double& a) { return a; }
+
+  static V Add(const V& a, const V& b) { return a + b; }
+  static V Sub(const V& a, const V& b) { return a - b; }
+  static V Mul(const V& a, const V& b) { return a * b; }
+  static V Div(const V& a, const V& b) { return a / b; }
+  static V Sqrt(const V& a) { return std::sqrt(a); }
+  static V Max(const V& a, const V& b) { return (a < b) ? b : a; }
+  static V Min(const V& a, const V& b) { return (b < a) ? b : a; }
+
+  static V Abs(const V& a) { return std::abs(a); }
+  static V CopySign(const V& magnitude, const V& sign) {
+    return std::copysign(magnitude, sign);
+  }
+
+  static V SelectGreater(const V& a, const V& b, const V& x, const V& y) {
+    return (b < a) ? x : y;
+  }
+
+  // gets 2^n from the result of adding kMagicRound to n
+  static V Pow2(const V& n_magic) {
+    int64_t bits_n;
+    int64_t bits_magic;
+    std::memcpy(&bits_n, &n_magic, sizeof(bits_n));
+    std::memcpy(&bits_magic, &kMagicRound, sizeof(bits_magic));
+
+    const int64_t bits = ((bits_n - bits_magic) + 1023) << 52;
+    V a;
+    std::memcpy(&a, &bits, sizeof(a));
+    return a;
+  }
+
+  // splits a positive normal value into the biased exponent and the mantissa
+  // in the range [1, 2)
+  static void Split(const V& a, V& exponent, V& mantissa) {
+    uint64_t bits;
+    std::memcpy(&bits, &a, sizeof(bits));
+
+    uint64_t bits_exponent;
+    std::memcpy(&bits_exponent, &kMagicInt, sizeof(bits_exponent));
+    bits_exponent |= (bits >> 52);
+    std::memcpy(&exponent, &bits_exponent, sizeof(exponent));
+    exponent -= kMagicInt;
+
+    const uint64_t bits_mantissa = (bits & 0x000FFFFFFFFFFFFFULL)
+                                   | 0x3FF0000000000000ULL;
+    std::memcpy(&mantissa, &bits_mantissa, sizeof(mantissa));
+  }
+};
+
+#if defined(ONSAG_CATENARY_KERNELS_SSE2)
+/// \par OVERVIEW
+///
+/// This struct is a pack of two doubles in an SSE2 register.
+struct PackSse2 {
+  typedef __m128d V;
+  static const int kSize = 2;
+
+  static V Load(const double* p) { return _mm_loadu_pd(p); }
+  static void Store(double* p, const V& a) { _mm_storeu_pd(p, a); }
+  static V Set(const double& a) { return _mm_set1_pd(a); }
+
+  static V Add(const V& a, const V& b) { return _mm_add_pd(a, b); }
+  static V Sub(const V& a, const V& b) { return _mm_sub_pd(a, b); }
+  static V Mul(const V& a, const V& b) { return _mm_mul_pd(a, b); }
+  static V Div(const V& a, const V& b) { return _mm_div_pd(a, b); }
+  static V Sqrt(const V& a) { return _mm_sqrt_pd(a); }
+  static V Max(const V& a, const V& b) { return _mm_max_pd(a, b); }
+  static V Min(const V& a, const V& b) { return _mm_min_pd(a, b); }
+
+  static V Abs(const V& a) { return _mm_andnot_pd(_mm_set1_pd(-0.0), a); }
+  static V CopySign(const V& magnitude, const V& sign) {
+    const V mask = _mm_set1_pd(-0.0);
+    return _mm_or_pd(_mm_andnot_pd(mask, magnitude), _mm_and_pd(mask, sign));
+  }
+
+  static V SelectGreater(const V& a, const V& b, const V& x, const V& y) {
+    const V mask = _mm_cmpgt_pd(a, b);
+    return _mm_or_pd(_mm_and_pd(mask, x), _mm_andnot_pd(mask, y));
+  }
+
+  static V Pow2(const V& n_magic) {
+    __m128i bits = _mm_sub_epi64(_mm_castpd_si128(n_magic),
+                                 _mm_castpd_si128(_mm_set1_pd(kMagicRound)));
+    bits = _mm_add_epi64(bits, _mm_set_epi32(0, 1023, 0, 1023));
+    bits = _mm_slli_epi64(bits, 52);
+    return _mm_castsi128_pd(bits);
+  }
+
+  static void Split(const V& a, V& exponent, V& mantissa) {
+    const __m128i bits = _mm_castpd_si128(a);
+
+    const __m128i bits_exponent = _mm_or_si128(
+        _mm_srli_epi64(bits, 52),
+        _mm_castpd_si128(_mm_set1_pd(kMagicInt)));
+    exponent = _mm_sub_pd(_mm_castsi128_pd(bits_exponent),
+                          _mm_set1_pd(kMagicInt));
+
+    const __m128i mask = _mm_set_epi32(0x000FFFFF, -1, 0x000FFFFF, -1);
+    const __m128i bits_mantissa = _mm_or_si128(
+        _mm_and_si128(bits, mask),
+        _mm_castpd_si128(_mm_set1_pd(1.0)));
+    mantissa = _mm_castsi128_pd(bits_mantissa);
+  }
+};
+#endif
+
+#if defined(ONSAG_CATENARY_KERNELS_AVX2)
+/// \par OVERVIEW
+///
+/// This struct is a pack of four doubles in an AVX2 register.
+struct PackAvx2 {
+  typedef __m256d V;
+  static const int kSize = 4;
+
+  static V Load(const double* p) { return _mm256_loadu_pd(p); }
+  static void Store(double* p, const V& a) { _mm256_storeu_pd(p, a); }
+  static V Set(const double& a) { return _mm256_set1_pd(a); }
+
+  static V Add(const V& a, const V& b) { return _mm256_add_pd(a, b); }
+  static V Sub(const V& a, const V& b) { return _mm256_sub_pd(a, b); }
+  static V Mul(const V& a, const V& b) { return _mm256_mul_pd(a, b); }
+  static V Div(const V& a, const V& b) { return _mm256_div_pd(a, b); }
+  static V Sqrt(const V& a) { return _mm256_sqrt_pd(a); }
+  static V Max(const V& a, const V& b) { return _mm256_max_pd(a, b); }
+  static V Min(const V& a, const V& b) { return _mm256_min_pd(a, b); }
+
+  static V Abs(const V& a) {
+    return _mm256_andnot_pd(_mm256_set1_pd(-0.0), a);
+  }
+  static V CopySign(const V& magnitude, const V& sign) {
+    const V mask = _mm256_set1_pd(-0.0);
+    return _mm256_or_pd(_mm256_andnot_pd(mask, magnitude),
+                        _mm256_and_pd(mask, sign));
+  }
+
+  static V SelectGreater(const V& a, const V& b, const V& x, const V& y) {
+    return _mm256_blendv_pd(y, x, _mm256_cmp_pd(a, b, _CMP_GT_OQ));
+  }
+
+  static V Pow2(const V& n_magic) {
+    __m256i bits = _mm256_sub_epi64(
+        _mm256_castpd_si256(n_magic),
+        _mm256_castpd_si256(_mm256_set1_pd(kMagicRound)));
+    bits = _mm256_add_epi64(bits, _mm256_set1_epi64x(1023));
+    bits = _mm256_slli_epi64(bits, 52);
+    return _mm256_castsi256_pd(bits);
+  }
+
+  static void Split(const V& a, V& exponent, V& mantissa) {
+    const __m256i bits = _mm256_castpd_si256(a);
+
+    const __m256i bits_exponent = _mm256_or_si256(
+        _mm256_srli_epi64(bits, 52),
+        _mm256_castpd_si256(_mm256_set1_pd(kMagicInt)));
+    exponent = _mm256_sub_pd(_mm256_castsi256_pd(bits_exponent),
+                             _mm256_set1_pd(kMagicInt));
+
+    const __m256i bits_mantissa = _mm256_or_si256(
+        _mm256_and_si256(bits, _mm256_set1_epi64x(0x000FFFFFFFFFFFFFLL)),
+        _mm256_castpd_si256(_mm256_set1_pd(1.0)));
+    mantissa = _mm256_castsi256_pd(bits_mantissa);
+  }
+};
+#endif
+
+/// \brief Calculates the exponential.
+/// \param[in] x
+///   The value.
+/// \return The exponential. Values are clamped so the result is always a
+///   normal number.
+template <class P>
+typename P::V Exp(const typename P::V& x) {
+  typedef typename P::V V;
+
+  const V x_clamped = P::Min(P::Max(x, P::Set(-708.0)), P::Set(709.0));
+
+  // reduces the range to |r| <= ln(2)/2, where x = n*ln(2) + r
+  const V n_magic = P::Add(P::Mul(x_clamped, P::Set(kLog2e)),
+                           P::Set(kMagicRound));
+  const V n = P::Sub(n_magic, P::Set(kMagicRound));
+  const V r = P::Sub(P::Sub(x_clamped, P::Mul(n, P::Set(kLn2Hi))),
+                     P::Mul(n, P::Set(kLn2Lo)));
+
+  // evaluates the taylor series to degree 13
+  V p = P::Set(1.0 / 6227020800.0);
+  p = P::Add(P::Mul(p, r), P::Set(1.0 / 479001600.0));
+  p = P::Add(P::Mul(p, r), P::Set(1.0 / 39916800.0));
+  p = P::Add(P::Mul(p, r), P::Set(1.0 / 3628800.0));
+  p = P::Add(P::Mul(p, r), P::Set(1.0 / 362880.0));
+  p = P::Add(P::Mul(p, r), P::Set(1.0 / 40320.0));
+  p = P::Add(P::Mul(p, r), P::Set(1.0 / 5040.0));
+  p = P::Add(P::Mul(p, r), P::Set(1.0 / 720.0));
+  p = P::Add(P::Mul(p, r), P::Set(1.0 / 120.0));
+  p = P::Add(P::Mul(p, r), P::Set(1.0 / 24.0));
+  p = P::Add(P::Mul(p, r), P::Set(1.0 / 6.0));
+  p = P::Add(P::Mul(p, r), P::Set(1.0 / 2.0));
+  p = P::Add(P::Mul(p, r), P::Set(1.0));
+  p = P::Add(P::Mul(p, r), P::Set(1.0));
+
+  // scales by 2^n
+  return P::Mul(p, P::Pow2(n_magic));
+}
+
+/// \brief Calculates the natural logarithm.
+/// \param[in] x
+///   The value, which must be a positive normal number.
+/// \return The natural logarithm.
+template <class P>
+typename P::V Log(const typename P::V& x) {
+  typedef typename P::V V;
+
+  // splits into x = m * 2^e, with m in the range [sqrt(0.5), sqrt(2))
+  V e;
+  V m;
+  P::Split(x, e, m);
+  e = P::SelectGreater(m, P::Set(kSqrt2), P::Add(e, P::Set(1.0)), e);
+  m = P::SelectGreater(m, P::Set(kSqrt2), P::Mul(m, P::Set(0.5)), m);
+  e = P::Sub(e, P::Set(1023.0));
+
+  // evaluates log(m) = 2*atanh(f), where f = (m-1)/(m+1) and |f| < 0.172
+  const V f = P::Div(P::Sub(m, P::Set(1.0)), P::Add(m, P::Set(1.0)));
+  const V f2 = P::Mul(f, f);
+  V s = P::Set(1.0 / 21.0);
+  s = P::Add(P::Mul(s, f2), P::Set(1.0 / 19.0));
+  s = P::Add(P::Mul(s, f2), P::Set(1.0 / 17.0));
+  s = P::Add(P::Mul(s, f2), P::Set(1.0 / 15.0));
+  s = P::Add(P::Mul(s, f2), P::Set(1.0 / 13.0));
+  s = P::Add(P::Mul(s, f2), P::Set(1.0 / 11.0));
+  s = P::Add(P::Mul(s, f2), P::Set(1.0 / 9.0));
+  s = P::Add(P::Mul(s, f2), P::Set(1.0 / 7.0));
+  s = P::Add(P::Mul(s, f2), P::Set(1.0 / 5.0));
+  s = P::Add(P::Mul(s, f2), P::Set(1.0 / 3.0));
+  s = P::Mul(s, f2);
+
+  const V f_twice = P::Add(f, f);
+  const V log_m = P::Add(f_twice, P::Mul(f_twice, s));
+
+  // combines with the exponent
+  return P::Add(P::Mul(e, P::Set(kLn2Hi)),
+                P::Add(log_m, P::Mul(e, P::Set(kLn2Lo))));
+}
+
+/// \brief Calculates the inverse hyperbolic sine.
+/// \param[in] x
+///   The value.
+/// \return The inverse hyperbolic sine.
+template <class P>
+typename P::V Asinh(const typename P::V& x) {
+  typedef typename P::V V;
+
+  const V a = P::Abs(x);
+  const V r = Log<P>(P::Add(a, P::Sqrt(P::Add(P::Mul(a, a), P::Set(1.0)))));
+  return P::CopySign(r, x);
+}
+
+/// \brief Calculates the hyperbolic cosine.
+/// \param[in] x
+///   The value.
+/// \return The hyperbolic cosine.
+template <class P>
+typename P::V Cosh(const typename P::V& x) {
+  const typename P::V e = Exp<P>(x);
+  return P::Mul(P::Set(0.5), P::Add(e, P::Div(P::Set(1.0), e)));
+}
+
+/// \brief Calculates the hyperbolic sine.
+/// \param[in] x
+///   The value.
+/// \return The hyperbolic sine.
+template <class P>
+typename P::V Sinh(const typename P::V& x) {
+  const typename P::V e = Exp<P>(x);
+  return P::Mul(P::Set(0.5), P::Sub(e, P::Div(P::Set(1.0), e)));
+}
+
+/// \brief Calculates coordinates for a block of positions.
+/// \param[in] index_begin
+///   The first index.
+/// \param[in] index_end
+///   The index past the last value. Only full packs are calculated.
+/// \return The index past the last calculated value.
+template <class P>
+int CoordinatesBlock(const int& index_begin, const int& index_end,
+                     const double& constant, const double& spacing_x,
+                     const double& position_low, const double& offset_z,
+                     const double* positions_fraction, double* coordinates_x,
+                     double* coordinates_z) {
+  typedef typename P::V V;
+
+  const V kConstant = P::Set(constant);
+  const V kOffsetZ = P::Set(offset_z);
+  const V kPositionLow = P::Set(position_low);
+  const V kSpacingX = P::Set(spacing_x);
+
+  int i = index_begin;
+  for (; i + P::kSize <= index_end; i += P::kSize) {
+    const V x = P::Mul(P::Load(&positions_fraction[i]), kSpacingX);
+    const V u = P::Div(P::Sub(x, kPositionLow), kConstant);
+    const V z = P::Sub(P::Mul(kConstant, Cosh<P>(u)), kOffsetZ);
+
+    P::Store(&coordinates_x[i], x);
+    P::Store(&coordinates_z[i], z);
+  }
+
+  return i;
+}
+
+}  // namespace
+
+namespace catenary_kernels {
+
+void Coordinates(const double& constant, const double& spacing_x,
+                 const double& spacing_z, const int& num_points,
+                 const double* positions_fraction, double* coordinates_x,
+                 double* coordinates_z) {
+  // solves for the low point position and the vertical offset once, so the
+  // left end is at the origin
+  // the scalar approximations are used so the left end is exactly zero
+  const double a = constant;
+  const double l = 2 * a * Sinh<PackScalar>(spacing_x / (2 * a));
+  const double position_low = (spacing_x / 2)
+                              - (a * Asinh<PackScalar>(spacing_z / l));
+  const double offset_z = a * Cosh<PackScalar>(-position_low / a);
+
+  // calculates full packs, and then any remaining values
+  int i = 0;
+#if defined(ONSAG_CATENARY_KERNELS_AVX2)
+  i = CoordinatesBlock<PackAvx2>(i, num_points, a, spacing_x, position_low,
+                                 offset_z, positions_fraction, coordinates_x,
+                                 coordinates_z);
+#elif defined(ONSAG_CATENARY_KERNELS_SSE2)
+  i = CoordinatesBlock<PackSse2>(i, num_points, a, spacing_x, position_low,
+                                 offset_z, positions_fraction, coordinates_x,
+                                 coordinates_z);
+#endif
+  CoordinatesBlock<PackScalar>(i, num_points, a, spacing_x, position_low,
+                               offset_z, positions_fraction, coordinates_x,
+                               coordinates_z);
+}
+
+std::string InstructionSet() {
+#if defined(ONSAG_CATENARY_KERNELS_AVX2)
+  return "AVX2";
+#elif defined(ONSAG_CATENARY_KERNELS_SSE2)
+  return "SSE2";
+#else
+  return "Scalar";
+#endif
+}
+
+}  // namespace catenary_kernels
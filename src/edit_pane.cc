@@ -94,6 +94,8 @@ void EditPane::Update(wxObject* hint) {
   const UpdateHint* hint_update = dynamic_cast<UpdateHint*>(hint);
   if (hint_update == nullptr) {
     InitializeTreeCtrl();
+  } else if (hint_update->type() == UpdateHint::Type::kAnalysisUpdate) {
+    // do nothing
   } else if (hint_update->type() == UpdateHint::Type::kPreferencesEdit) {
     // do nothing
   } else if (hint_update->type() == UpdateHint::Type::kSpansEdit) {
@@ -145,6 +145,10 @@ bool OnSagApp::OnInit() {
   config_.options_plot_profile.scale_vertical = 10;
   config_.options_plot_profile.thickness_line = 1;
   config_.size_frame = wxSize(400, 400);
+  config_.sweep.num_intervals = 2;
+  config_.sweep.step = 1;
+  config_.sweep.type = TemperatureSweep::Type::kSpan;
+  config_.tolerance_parabola = 0;
   config_.units = units::UnitSystem::kImperial;
 
   // loads config settings from file, or saves a file if it doesn't exist
@@ -0,0 +1,246 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+// This is the entry point for the onsag-batch command line application. It
+// analyzes every span in a set of OnSag documents and writes the results
+// without starting the GUI. It can also solve field readings for the cable
+// temperature of the document spans, optimize the transit locations, or export
+// the span lookup tables for offline field devices.
+
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "wx/cmdline.h"
+#include "wx/init.h"
+#include "wx/log.h"
+
+#include "onsag/batch_runner.h"
+
+/// This is an array of command line options.
+static const wxCmdLineEntryDesc cmd_line_desc_batch[] = {
+  {wxCMD_LINE_SWITCH, nullptr, "help", "shows this help message",
+      wxCMD_LINE_VAL_NONE, wxCMD_LINE_OPTION_HELP},
+  {wxCMD_LINE_SWITCH, nullptr, "verbose", "logs progress messages",
+      wxCMD_LINE_VAL_NONE},
+  {wxCMD_LINE_SWITCH, nullptr, "optimize-transit",
+      "optimizes the transit location of every transit span over the "
+      "temperature sweep, instead of running the analysis",
+      wxCMD_LINE_VAL_NONE},
+  {wxCMD_LINE_SWITCH, nullptr, "export-tables",
+      "exports the lookup table of every span, instead of running the "
+      "analysis",
+      wxCMD_LINE_VAL_NONE},
+  {wxCMD_LINE_OPTION, nullptr, "format", "the output format (csv or json)",
+      wxCMD_LINE_VAL_STRING},
+  {wxCMD_LINE_OPTION, nullptr, "output",
+      "the output file (defaults to standard output)",
+      wxCMD_LINE_VAL_STRING},
+  {wxCMD_LINE_OPTION, nullptr, "intervals",
+      "the number of span temperature intervals above and below the base "
+      "temperature (defaults to 2)",
+      wxCMD_LINE_VAL_NUMBER},
+  {wxCMD_LINE_OPTION, nullptr, "step",
+      "sweeps the full cable temperature range at this step, instead of the "
+      "span intervals",
+      wxCMD_LINE_VAL_DOUBLE},
+  {wxCMD_LINE_OPTION, nullptr, "readings",
+      "solves the cable temperature for a CSV file of field readings (span, "
+      "measurement), instead of running the analysis",
+      wxCMD_LINE_VAL_STRING},
+  {wxCMD_LINE_OPTION, nullptr, "tolerance-parabola",
+      "evaluates the sags and lengths with a parabola where the error bound "
+      "is within this tolerance, in the document length units (defaults to "
+      "the exact catenary)",
+      wxCMD_LINE_VAL_DOUBLE},
+  {wxCMD_LINE_OPTION, nullptr, "samples",
+      "the number of temperature samples in each exported lookup table "
+      "(defaults to 65)",
+      wxCMD_LINE_VAL_NUMBER},
+  {wxCMD_LINE_OPTION, nullptr, "threads",
+      "the number of worker threads (defaults to all CPUs)",
+      wxCMD_LINE_VAL_NUMBER},
+  {wxCMD_LINE_PARAM, nullptr, nullptr, "document files or directories",
+      wxCMD_LINE_VAL_STRING, wxCMD_LINE_PARAM_MULTIPLE},
+
+  {wxCMD_LINE_NONE}
+};
+
+int main(int argc, char** argv) {
+  // initializes wxWidgets base library
+  wxInitializer initializer(argc, argv);
+  if (initializer.IsOk() == false) {
+    std::cerr << "Couldn't initialize wxWidgets." << std::endl;
+    return -1;
+  }
+
+  // sends all logging to standard error so results can be piped
+  delete wxLog::SetActiveTarget(new wxLogStderr());
+
+  // parses command line
+  wxCmdLineParser parser(cmd_line_desc_batch, argc, argv);
+  parser.EnableLongOptions();
+  parser.SetSwitchChars("--");
+  const int status_parse = parser.Parse();
+  if (status_parse == -1) {
+    return 0;
+  } else if (status_parse != 0) {
+    return -1;
+  }
+
+  if (parser.Found("verbose") == true) {
+    wxLog::SetVerbose(true);
+  }
+
+  // gets output format
+  BatchRunner::FormatType format = BatchRunner::FormatType::kCsv;
+  wxString str_format;
+  if (parser.Found("format", &str_format) == true) {
+    if (str_format == "csv") {
+      format = BatchRunner::FormatType::kCsv;
+    } else if (str_format == "json") {
+      format = BatchRunner::FormatType::kJson;
+    } else {
+      wxLogError("Invalid output format. Aborting.");
+      return -1;
+    }
+  }
+
+  // gets number of threads
+  long num_threads = 0;
+  parser.Found("threads", &num_threads);
+
+  // gets temperature sweep
+  TemperatureSweep sweep;
+  long num_intervals = 0;
+  if (parser.Found("intervals", &num_intervals) == true) {
+    sweep.num_intervals = num_intervals;
+  }
+
+  double step = 0;
+  if (parser.Found("step", &step) == true) {
+    sweep.step = step;
+    sweep.type = TemperatureSweep::Type::kCable;
+  }
+
+  if (sweep.Validate(true, nullptr) == false) {
+    wxLogError("Invalid temperature sweep. Aborting.");
+    return -1;
+  }
+
+  // gets parabola tolerance
+  double tolerance_parabola = 0;
+  if ((parser.Found("tolerance-parabola", &tolerance_parabola) == true)
+      && (tolerance_parabola < 0)) {
+    wxLogError("Invalid parabola tolerance. Aborting.");
+    return -1;
+  }
+
+  // gets number of lookup table samples
+  long num_samples = 65;
+  if ((parser.Found("samples", &num_samples) == true) && (num_samples < 2)) {
+    wxLogError("Invalid number of samples. Aborting.");
+    return -1;
+  }
+
+  // loads all documents
+  BatchRunner runner;
+  runner.set_sweep(sweep);
+  runner.set_tolerance_parabola(tolerance_parabola);
+  bool status_load = true;
+  for (unsigned int i = 0; i < parser.GetParamCount(); i++) {
+    const std::string path = parser.GetParam(i).ToStdString();
+    if (runner.AddPath(path) == false) {
+      status_load = false;
+    }
+  }
+
+  // opens output stream
+  std::ofstream file_output;
+  wxString filepath_output;
+  if (parser.Found("output", &filepath_output) == true) {
+    file_output.open(filepath_output.ToStdString().c_str());
+    if (file_output.is_open() == false) {
+      wxLogError("Couldn't open output file. Aborting.");
+      return -1;
+    }
+  }
+  std::ostream& stream_output =
+      (file_output.is_open() == true) ? file_output : std::cout;
+
+  // solves readings instead of the analysis if a readings file is provided
+  wxString filepath_readings;
+  if (parser.Found("readings", &filepath_readings) == true) {
+    std::ifstream file_readings(filepath_readings.ToStdString().c_str());
+    if (file_readings.is_open() == false) {
+      wxLogError("Couldn't open readings file. Aborting.");
+      return -1;
+    }
+
+    const int num_errors = runner.SolveReadings(file_readings, stream_output);
+    if (num_errors != 0) {
+      std::string message = std::to_string(num_errors)
+                            + " reading(s) could not be solved. Check logs.";
+      wxLogWarning(message.c_str());
+    }
+
+    if ((status_load == false) || (num_errors != 0)) {
+      return 1;
+    } else {
+      return 0;
+    }
+  }
+
+  // optimizes transit locations instead of the analysis if requested
+  if (parser.Found("optimize-transit") == true) {
+    const int num_errors = runner.OptimizeTransits(num_threads,
+                                                   stream_output);
+    if (num_errors != 0) {
+      std::string message = std::to_string(num_errors)
+                            + " transit span(s) could not be optimized. "
+                              "Check logs.";
+      wxLogWarning(message.c_str());
+    }
+
+    if ((status_load == false) || (num_errors != 0)) {
+      return 1;
+    } else {
+      return 0;
+    }
+  }
+
+  // exports lookup tables instead of the analysis if requested
+  if (parser.Found("export-tables") == true) {
+    const int num_errors = runner.ExportTables(num_samples, stream_output);
+    if (num_errors != 0) {
+      std::string message = std::to_string(num_errors)
+                            + " span table(s) could not be exported. "
+                              "Check logs.";
+      wxLogWarning(message.c_str());
+    }
+
+    if ((status_load == false) || (num_errors != 0)) {
+      return 1;
+    } else {
+      return 0;
+    }
+  }
+
+  // runs the analysis
+  const int num_errors = runner.RunAnalysis(num_threads);
+  if (num_errors != 0) {
+    std::string message = std::to_string(num_errors)
+                          + " span(s) could not be fully solved. Check logs.";
+    wxLogWarning(message.c_str());
+  }
+
+  // writes results
+  runner.WriteResults(format, stream_output);
+
+  // returns non-zero if any document or span had errors
+  if ((status_load == false) || (num_errors != 0)) {
+    return 1;
+  } else {
+    return 0;
+  }
+}
@@ -3,7 +3,12 @@
 
 #include "onsag/on_sag_config_xml_handler.h"
 
+#include <iomanip>
+#include <limits>
+#include <sstream>
+
 #include "appcommon/xml/color_xml_handler.h"
+#include "models/base/helper.h"
 #include "wx/filename.h"
 
 #include "onsag/on_sag_app.h"
@@ -88,6 +93,44 @@ wxXmlNode* OnSagConfigXmlHandler::CreateNode(const OnSagConfig& config) {
   node_element->AddAttribute("is_maximized", str);
   node_root->AddChild(node_element);
 
+  // creates sweep node
+  title = "sweep";
+  node_element = new wxXmlNode(wxXML_ELEMENT_NODE, title);
+
+  title = "type";
+  if (config.sweep.type == TemperatureSweep::Type::kCable) {
+    content = "Cable";
+  } else if (config.sweep.type == TemperatureSweep::Type::kSpan) {
+    content = "Span";
+  } else {
+    content = "";
+  }
+  sub_node = CreateElementNodeWithContent(title, content);
+  node_element->AddChild(sub_node);
+
+  title = "num_intervals";
+  content = std::to_string(config.sweep.num_intervals);
+  sub_node = CreateElementNodeWithContent(title, content);
+  node_element->AddChild(sub_node);
+
+  // the step is not rounded, since any positive step is valid and the
+  // significant digits reproduce the step that was entered
+  title = "step";
+  std::ostringstream stream_step;
+  stream_step << std::setprecision(std::numeric_limits<double>::digits10)
+              << config.sweep.step;
+  content = stream_step.str();
+  sub_node = CreateElementNodeWithContent(title, content);
+  node_element->AddChild(sub_node);
+
+  node_root->AddChild(node_element);
+
+  // creates tolerance-parabola node
+  title = "tolerance_parabola";
+  content = helper::DoubleToFormattedString(config.tolerance_parabola, 6);
+  node_element = CreateElementNodeWithContent(title, content);
+  node_root->AddChild(node_element);
+
   // creates units node
   title = "units";
   if (config.units == units::UnitSystem::kMetric) {
@@ -244,6 +287,64 @@ bool OnSagConfigXmlHandler::ParseNodeV1(const wxXmlNode* root,
       } else if (str =="1") {
         config.is_maximized_frame = true;
       }
+    } else if (title == "sweep") {
+      // gets sub-nodes
+      wxXmlNode* sub_node = node->GetChildren();
+      while (sub_node != nullptr) {
+        wxString sub_title = sub_node->GetName();
+        wxString sub_content = ParseElementNodeWithContent(sub_node);
+        long value = -9999;
+        double value_double = -9999;
+
+        if (sub_title == "type") {
+          if (sub_content == "Cable") {
+            config.sweep.type = TemperatureSweep::Type::kCable;
+          } else if (sub_content == "Span") {
+            config.sweep.type = TemperatureSweep::Type::kSpan;
+          } else {
+            message = FileAndLineNumber(filepath, sub_node)
+                      + "Sweep type isn't recognized. Keeping default "
+                      "setting.";
+            wxLogWarning(message);
+          }
+        } else if (sub_title == "num_intervals") {
+          if ((sub_content.ToLong(&value) == true) && (0 <= value)) {
+            config.sweep.num_intervals = value;
+          } else {
+            message = FileAndLineNumber(filepath, sub_node)
+                      + "Invalid number of sweep intervals. Skipping.";
+            wxLogError(message);
+            status = false;
+          }
+        } else if (sub_title == "step") {
+          if ((sub_content.ToDouble(&value_double) == true)
+              && (0 < value_double)) {
+            config.sweep.step = value_double;
+          } else {
+            message = FileAndLineNumber(filepath, sub_node)
+                      + "Invalid sweep step. Skipping.";
+            wxLogError(message);
+            status = false;
+          }
+        } else {
+          message = FileAndLineNumber(filepath, node)
+                    + "XML node isn't recognized. Skipping.";
+          wxLogError(message);
+          status = false;
+        }
+
+        sub_node = sub_node->GetNext();
+      }
+    } else if (title == "tolerance_parabola") {
+      double value = -9999;
+      if ((content.ToDouble(&value) == true) && (0 <= value)) {
+        config.tolerance_parabola = value;
+      } else {
+        message = FileAndLineNumber(filepath, node)
+                  + "Invalid parabola tolerance. Skipping.";
+        wxLogError(message);
+        status = false;
+      }
     } else if (title == "units") {
       if (content == "Metric") {
         config.units = units::UnitSystem::kMetric;
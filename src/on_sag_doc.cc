@@ -14,6 +14,8 @@
 IMPLEMENT_DYNAMIC_CLASS(OnSagDoc, wxDocument)
 
 OnSagDoc::OnSagDoc() {
+  controller_analysis_.set_document(this);
+  controller_analysis_.set_spans(&spans_);
 }
 
 OnSagDoc::~OnSagDoc() {
@@ -58,6 +60,9 @@ void OnSagDoc::ConvertUnitSystem(const units::UnitSystem& system_from,
     SagSpanUnitConverter::ConvertUnitSystem(system_from, system_to, span);
   }
 
+  // clears cached results, which are in the previous unit system
+  controller_analysis_.ClearResults();
+
   // clears commands in the processor
   wxCommandProcessor* processor = GetCommandProcessor();
   processor->ClearCommands();
@@ -235,7 +240,9 @@ wxInputStream& OnSagDoc::LoadObject(wxInputStream& stream) {
 
   // parses the XML node and loads into the document
   std::string filename = this->GetFilename();
-  const bool status_node = OnSagDocXmlHandler::ParseNode(root, filename, *this);
+  std::list<SagSpan> spans;
+  const bool status_node = OnSagDocXmlHandler::ParseNode(root, filename,
+                                                         spans);
   if (status_node == false) {
     // notifies user of error
     message = GetFilename() + "  --  "
@@ -243,6 +250,10 @@ wxInputStream& OnSagDoc::LoadObject(wxInputStream& stream) {
     wxMessageBox(message);
   }
 
+  for (auto iter = spans.cbegin(); iter != spans.cend(); iter++) {
+    AppendSpan(*iter);
+  }
+
   // converts units to consistent style
   ConvertUnitStyle(units_file,
                    units::UnitStyle::kDifferent,
@@ -260,6 +271,9 @@ wxInputStream& OnSagDoc::LoadObject(wxInputStream& stream) {
 
   status_bar_log::PopText(0);
 
+  // starts analyzing all of the loaded spans
+  SyncAnalysisController();
+
   return stream;
 }
 
@@ -276,10 +290,9 @@ bool OnSagDoc::ModifySpan(const int& index, const SagSpan& span) {
   // sets document flag as modified
   Modify(true);
 
-  // runs analysis if necessary
-  if (index == index_activated_) {
-    controller_analysis_.RunAnalysis();
-  }
+  // clears the cached span results and runs analysis
+  controller_analysis_.ClearResults(&(*iter));
+  controller_analysis_.RunAnalysis();
 
   return true;
 }
@@ -336,6 +349,10 @@ const std::vector<SaggingAnalysisResult>* OnSagDoc::Results() const {
   return controller_analysis_.Results();
 }
 
+const SpanResultSet* OnSagDoc::ResultSet(const SagSpan* span) const {
+  return controller_analysis_.ResultSet(span);
+}
+
 void OnSagDoc::RunAnalysis() const {
   controller_analysis_.RunAnalysis();
 }
@@ -356,7 +373,7 @@ wxOutputStream& OnSagDoc::SaveObject(wxOutputStream& stream) {
                    units::UnitStyle::kDifferent);
 
   // generates an xml node
-  wxXmlNode* root = OnSagDocXmlHandler::CreateNode(*this, units);
+  wxXmlNode* root = OnSagDocXmlHandler::CreateNode(spans_, units);
 
   // adds unit attribute to xml node
   // this attribute should be added at this step vs the xml handler because
@@ -421,19 +438,15 @@ const std::list<SagSpan>& OnSagDoc::spans() const {
 }
 
 void OnSagDoc::SyncAnalysisController() {
-  // exits if no span is activated
-  if (index_activated_ == -1) {
-    controller_analysis_.set_span(nullptr);
-    controller_analysis_.ClearResults();
-    return;
-  }
-
   // gets a pointer to the activated span
-  const SagSpan* span = &(*std::next(spans_.cbegin(), index_activated_));
-
-  // forces controller to update if spans don't match
-  if (span != controller_analysis_.span()) {
-    controller_analysis_.set_span(span);
-    controller_analysis_.RunAnalysis();
+  const SagSpan* span = nullptr;
+  if (index_activated_ != -1) {
+    span = &(*std::next(spans_.cbegin(), index_activated_));
   }
+
+  // updates the activated span and solves any spans that aren't cached
+  // if the activated span is already cached, its results are available
+  // immediately
+  controller_analysis_.set_span(span);
+  controller_analysis_.RunAnalysis();
 }
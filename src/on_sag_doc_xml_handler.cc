@@ -6,7 +6,7 @@
 #include "onsag/sag_span_xml_handler.h"
 
 wxXmlNode* OnSagDocXmlHandler::CreateNode(
-    const OnSagDoc& doc,
+    const std::list<SagSpan>& spans,
     const units::UnitSystem& units) {
   // initializes variables used to create XML node
   wxXmlNode* node_root = nullptr;
@@ -23,7 +23,6 @@ wxXmlNode* OnSagDocXmlHandler::CreateNode(
   // creates sag spans node
   title = "sag_spans";
   node_element = new wxXmlNode(wxXML_ELEMENT_NODE, title);
-  const std::list<SagSpan>& spans = doc.spans();
   for (auto iter = spans.cbegin(); iter != spans.cend(); iter++) {
     const SagSpan& span = *iter;
 
@@ -39,7 +38,7 @@ wxXmlNode* OnSagDocXmlHandler::CreateNode(
 bool OnSagDocXmlHandler::ParseNode(
     const wxXmlNode* root,
     const std::string& filepath,
-    OnSagDoc& doc) {
+    std::list<SagSpan>& spans) {
   wxString message;
 
   // checks for valid root node
@@ -61,7 +60,7 @@ bool OnSagDocXmlHandler::ParseNode(
 
   // sends to proper parsing function
   if (version == "1") {
-    return ParseNodeV1(root, filepath, doc);
+    return ParseNodeV1(root, filepath, spans);
   } else {
     message = FileAndLineNumber(filepath, root) +
               " Invalid version number. Aborting node parse.";
@@ -73,7 +72,7 @@ bool OnSagDocXmlHandler::ParseNode(
 bool OnSagDocXmlHandler::ParseNodeV1(
     const wxXmlNode* root,
     const std::string& filepath,
-    OnSagDoc& doc) {
+    std::list<SagSpan>& spans) {
   bool status = true;
   wxString message;
 
@@ -98,7 +97,7 @@ bool OnSagDocXmlHandler::ParseNodeV1(
           }
 
           // adds to container
-          doc.AppendSpan(span);
+          spans.push_back(span);
         } else {
           message = FileAndLineNumber(filepath, sub_node)
                     + "XML node isn't recognized. Skipping.";
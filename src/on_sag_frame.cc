@@ -120,8 +120,11 @@ void OnSagFrame::OnMenuFilePreferences(wxCommandEvent& event) {
   // gets the application config
   OnSagConfig* config = wxGetApp().config();
 
-  // stores a copy of the unit system before letting user edit
+  // stores a copy of the unit system, sweep, and parabola tolerance before
+  // letting user edit
   units::UnitSystem units_before = config->units;
+  const TemperatureSweep sweep_before = config->sweep;
+  const double tolerance_parabola_before = config->tolerance_parabola;
 
   // creates preferences editor dialog and shows
   // exits if user closes/cancels
@@ -147,11 +150,43 @@ void OnSagFrame::OnMenuFilePreferences(wxCommandEvent& event) {
   if (units_before != config->units) {
     wxLogVerbose("Converting unit system.");
 
+    // updates the sweep step, which is a temperature difference
+    if (config->units == units::UnitSystem::kMetric) {
+      config->sweep.step = units::ConvertTemperature(
+          config->sweep.step,
+          units::TemperatureConversionType::kRankineToKelvin, 1, true);
+    } else if (config->units == units::UnitSystem::kImperial) {
+      config->sweep.step = units::ConvertTemperature(
+          config->sweep.step,
+          units::TemperatureConversionType::kKelvinToRankine, 1, true);
+    }
+
+    // updates the parabola tolerance, which is a length
+    if (config->units == units::UnitSystem::kMetric) {
+      config->tolerance_parabola = units::ConvertLength(
+          config->tolerance_parabola,
+          units::LengthConversionType::kFeetToMeters);
+    } else if (config->units == units::UnitSystem::kImperial) {
+      config->tolerance_parabola = units::ConvertLength(
+          config->tolerance_parabola,
+          units::LengthConversionType::kMetersToFeet);
+    }
+
     // updates document
     if (doc != nullptr) {
       doc->ConvertUnitSystem(units_before, config->units);
       doc->RunAnalysis();
     }
+  } else if ((sweep_before.type != config->sweep.type)
+             || (sweep_before.num_intervals != config->sweep.num_intervals)
+             || (sweep_before.step != config->sweep.step)
+             || (tolerance_parabola_before != config->tolerance_parabola)) {
+    wxLogVerbose("Updating analysis settings.");
+
+    // re-runs the analysis, which detects the sweep and tolerance change
+    if (doc != nullptr) {
+      doc->RunAnalysis();
+    }
   }
 
   // updates views
@@ -3,6 +3,11 @@
 
 #include "onsag/preferences_dialog.h"
 
+#include <iomanip>
+#include <limits>
+#include <sstream>
+
+#include "models/base/helper.h"
 #include "wx/clrpicker.h"
 #include "wx/xrc/xmlres.h"
 
@@ -39,6 +44,31 @@ PreferencesDialog::PreferencesDialog(
     radiobox->SetSelection(1);
   }
 
+  // sets the temperature sweep in the radio and text controls
+  radiobox = XRCCTRL(*this, "radiobox_sweep", wxRadioBox);
+  if (config_->sweep.type == TemperatureSweep::Type::kSpan) {
+    radiobox->SetSelection(0);
+  } else if (config_->sweep.type == TemperatureSweep::Type::kCable) {
+    radiobox->SetSelection(1);
+  }
+
+  wxTextCtrl* textctrl = nullptr;
+
+  textctrl = XRCCTRL(*this, "textctrl_sweep_intervals", wxTextCtrl);
+  textctrl->SetValue(std::to_string(config_->sweep.num_intervals));
+
+  // the step is not rounded, since any positive step is valid
+  std::ostringstream stream_step;
+  stream_step << std::setprecision(std::numeric_limits<double>::digits10)
+              << config_->sweep.step;
+  textctrl = XRCCTRL(*this, "textctrl_sweep_step", wxTextCtrl);
+  textctrl->SetValue(stream_step.str());
+
+  // sets the parabola tolerance in the text control
+  textctrl = XRCCTRL(*this, "textctrl_tolerance_parabola", wxTextCtrl);
+  textctrl->SetValue(
+      helper::DoubleToFormattedString(config_->tolerance_parabola, 6));
+
   // sets the color in the color picker
   wxColourPickerCtrl* pickerctrl =
       XRCCTRL(*this, "colorpicker_background", wxColourPickerCtrl);
@@ -59,6 +89,52 @@ void PreferencesDialog::OnButtonOk(wxCommandEvent& event) {
   wxBusyCursor cursor;
 
   wxRadioBox* radiobox = nullptr;
+  wxTextCtrl* textctrl = nullptr;
+
+  // gets the temperature sweep and validates before transferring anything
+  TemperatureSweep sweep;
+
+  radiobox = XRCCTRL(*this, "radiobox_sweep", wxRadioBox);
+  if (radiobox->GetSelection() == 0) {
+    sweep.type = TemperatureSweep::Type::kSpan;
+  } else if (radiobox->GetSelection() == 1) {
+    sweep.type = TemperatureSweep::Type::kCable;
+  }
+
+  long value = -9999;
+  textctrl = XRCCTRL(*this, "textctrl_sweep_intervals", wxTextCtrl);
+  if (textctrl->GetValue().ToLong(&value) == true) {
+    sweep.num_intervals = value;
+  } else {
+    sweep.num_intervals = -1;
+  }
+
+  double value_double = -9999;
+  textctrl = XRCCTRL(*this, "textctrl_sweep_step", wxTextCtrl);
+  if (textctrl->GetValue().ToDouble(&value_double) == true) {
+    sweep.step = value_double;
+  } else {
+    sweep.step = -1;
+  }
+
+  std::list<ErrorMessage> messages;
+  if (sweep.Validate(true, &messages) == false) {
+    std::string message;
+    for (auto iter = messages.cbegin(); iter != messages.cend(); iter++) {
+      message += iter->title + " - " + iter->description + "\n";
+    }
+    wxMessageBox(message);
+    return;
+  }
+
+  // gets the parabola tolerance
+  double tolerance_parabola = -9999;
+  textctrl = XRCCTRL(*this, "textctrl_tolerance_parabola", wxTextCtrl);
+  if ((textctrl->GetValue().ToDouble(&tolerance_parabola) == false)
+      || (tolerance_parabola < 0)) {
+    wxMessageBox("PREFERENCES - Invalid parabola tolerance");
+    return;
+  }
 
   // transfers units
   radiobox = XRCCTRL(*this, "radiobox_units", wxRadioBox);
@@ -76,6 +152,12 @@ void PreferencesDialog::OnButtonOk(wxCommandEvent& event) {
     config_->level_log = wxLOG_Info;
   }
 
+  // transfers temperature sweep
+  config_->sweep = sweep;
+
+  // transfers parabola tolerance
+  config_->tolerance_parabola = tolerance_parabola;
+
   // transfers background color
   wxColourPickerCtrl* pickerctrl =
       XRCCTRL(*this, "colorpicker_background", wxColourPickerCtrl);
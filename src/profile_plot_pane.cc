@@ -4,6 +4,7 @@
 #include "onsag/profile_plot_pane.h"
 
 #include <cmath>
+#include <vector>
 
 #include "appcommon/graphics/line_renderer_2d.h"
 #include "appcommon/graphics/text_renderer_2d.h"
@@ -11,6 +12,7 @@
 #include "models/base/helper.h"
 #include "wx/dcbuffer.h"
 
+#include "onsag/catenary_kernels.h"
 #include "onsag/on_sag_app.h"
 #include "onsag/on_sag_doc.h"
 #include "onsag/on_sag_view.h"
@@ -77,6 +79,10 @@ void ProfilePlotPane::Update(wxObject* hint) {
     UpdatePlotDatasets();
     UpdatePlotRenderers();
     view_->OnDraw(&dc_buf);
+  } else if (hint_update->type() == UpdateHint::Type::kAnalysisUpdate) {
+    UpdatePlotDatasets();
+    UpdatePlotRenderers();
+    view_->OnDraw(&dc_buf);
   } else if (hint_update->type() == UpdateHint::Type::kPreferencesEdit) {
     UpdatePlotDatasets();
     UpdatePlotRenderers();
@@ -167,19 +173,29 @@ void ProfilePlotPane::UpdateDatasetCatenary(
   // gets catenary
   const Catenary3d& catenary = result.catenary;
 
-  // calculates points
-  std::list<Point3d<double>> points;
-  const int i_max = 100;
-  for (int i = 0; i <= i_max; i++) {
-    double pos = static_cast<double>(i) / static_cast<double>(i_max);
+  // calculates the horizontal positions
+  const int kNumPoints = 101;
+  std::vector<double> positions(kNumPoints);
+  for (int i = 0; i < kNumPoints; i++) {
+    positions[i] = static_cast<double>(i)
+                   / static_cast<double>(kNumPoints - 1);
+  }
 
-    // gets catenary coordinate
-    Point3d<double> p = catenary.Coordinate(pos);
+  // calculates catenary coordinates in a single pass
+  std::vector<double> xs(kNumPoints);
+  std::vector<double> zs(kNumPoints);
+  const Vector3d spacing = catenary.spacing_endpoints();
+  catenary_kernels::Coordinates(catenary.Constant(), spacing.x(), spacing.z(),
+                                kNumPoints, positions.data(), xs.data(),
+                                zs.data());
 
-    // shifts coordinates from catenary to span
-    p.x += result.offset_coordinates.x;
-    p.y += 0;
-    p.z += result.offset_coordinates.y;
+  // shifts coordinates from catenary to span
+  std::list<Point3d<double>> points;
+  for (int i = 0; i < kNumPoints; i++) {
+    Point3d<double> p;
+    p.x = xs[i] + result.offset_coordinates.x;
+    p.y = 0;
+    p.z = zs[i] + result.offset_coordinates.y;
 
     // adds to list
     points.push_back(p);
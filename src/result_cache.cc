@@ -0,0 +1,184 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#include "onsag/result_cache.h"
+
+#include "onsag/span_sagger.h"
+
+const std::size_t ResultCache::kSizeMaxDefault = 32 * 1024 * 1024;
+
+ResultCache::ResultCache(const std::size_t& size_max) {
+  num_hits_ = 0;
+  num_misses_ = 0;
+  size_ = 0;
+  size_max_ = size_max;
+}
+
+ResultCache::~ResultCache() {
+}
+
+void ResultCache::Clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  entries_.clear();
+  index_.clear();
+  size_ = 0;
+}
+
+bool ResultCache::Find(const std::string& key, SaggingAnalysisResult& result) {
+  const uint64_t hash = Hash(key);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  // searches index and verifies the full key
+  auto iter = index_.find(hash);
+  if ((iter == index_.end()) || (iter->second->key != key)) {
+    num_misses_++;
+    return false;
+  }
+
+  // moves entry to the front of the list as the most recently used
+  entries_.splice(entries_.begin(), entries_, iter->second);
+
+  num_hits_++;
+  result = iter->second->result;
+  return true;
+}
+
+void ResultCache::Insert(const std::string& key,
+                         const SaggingAnalysisResult& result) {
+  Entry entry;
+  entry.hash = Hash(key);
+  entry.key = key;
+  entry.result = result;
+  entry.result.temperature_cable = nullptr;
+
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  // removes any existing entry with the same hash
+  auto iter = index_.find(entry.hash);
+  if (iter != index_.end()) {
+    size_ -= SizeEntry(*iter->second);
+    entries_.erase(iter->second);
+    index_.erase(iter);
+  }
+
+  // adds to the front of the list as the most recently used
+  size_ += SizeEntry(entry);
+  entries_.push_front(entry);
+  index_[entry.hash] = entries_.begin();
+
+  Evict();
+}
+
+std::string ResultCache::Key(const SagSpan& span, const double& temperature,
+                             const units::UnitSystem& units,
+                             const double& tolerance_parabola) {
+  std::string key;
+
+  // adds analysis inputs
+  AppendKey(temperature, key);
+  AppendKey(static_cast<int>(units), key);
+  if (0 < tolerance_parabola) {
+    AppendKey(tolerance_parabola, key);
+  } else {
+    AppendKey(0.0, key);
+  }
+
+  // adds cable
+  const SagCable& cable = span.cable;
+  AppendKey(cable.correction_creep, key);
+  AppendKey(cable.correction_sag, key);
+  AppendKey(cable.scale, key);
+  AppendKey(cable.weight_unit, key);
+  AppendKey(static_cast<int>(cable.tensions.size()), key);
+  for (auto iter = cable.tensions.cbegin(); iter != cable.tensions.cend();
+       iter++) {
+    const SagCable::TensionPoint& point = *iter;
+    AppendKey(point.temperature, key);
+    AppendKey(point.tension_horizontal, key);
+  }
+
+  // adds structures
+  AppendKey(span.structure_back.point_attachment.x, key);
+  AppendKey(span.structure_back.point_attachment.y, key);
+  AppendKey(span.structure_ahead.point_attachment.x, key);
+  AppendKey(span.structure_ahead.point_attachment.y, key);
+
+  // adds method
+  const SagMethod& method = span.method;
+  // the dynamometer end is not included, since the results contain the
+  // tension at both ends
+  AppendKey(static_cast<int>(method.type), key);
+  AppendKey(method.point_transit.x, key);
+  AppendKey(method.point_transit.y, key);
+
+  // the stopwatch wave number is only included if it is beyond the return
+  // time table, since the stopwatch time is otherwise selected from the table
+  if (SpanSaggerResult::kNumWavesReturn < method.wave_return) {
+    AppendKey(method.wave_return, key);
+  }
+
+  return key;
+}
+
+int ResultCache::count() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return entries_.size();
+}
+
+int ResultCache::num_hits() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return num_hits_;
+}
+
+int ResultCache::num_misses() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return num_misses_;
+}
+
+std::size_t ResultCache::size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return size_;
+}
+
+std::size_t ResultCache::size_max() const {
+  return size_max_;
+}
+
+void ResultCache::AppendKey(const double& value, std::string& key) {
+  // normalizes negative zero so equal values always generate equal keys
+  const double value_key = (value == 0) ? 0 : value;
+  key.append(reinterpret_cast<const char*>(&value_key), sizeof(value_key));
+}
+
+void ResultCache::AppendKey(const int& value, std::string& key) {
+  key.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void ResultCache::Evict() {
+  while ((size_max_ < size_) && (entries_.empty() == false)) {
+    const Entry& entry = entries_.back();
+    size_ -= SizeEntry(entry);
+    index_.erase(entry.hash);
+    entries_.pop_back();
+  }
+}
+
+uint64_t ResultCache::Hash(const std::string& key) {
+  uint64_t hash = 14695981039346656037ULL;
+  for (auto iter = key.cbegin(); iter != key.cend(); iter++) {
+    hash ^= static_cast<unsigned char>(*iter);
+    hash *= 1099511628211ULL;
+  }
+
+  return hash;
+}
+
+std::size_t ResultCache::SizeEntry(const Entry& entry) {
+  // includes the list node, index node, key storage, and return time table
+  return sizeof(Entry) + (4 * sizeof(void*))
+         + sizeof(std::pair<uint64_t, std::list<Entry>::iterator>)
+         + entry.key.capacity()
+         + (entry.result.times_return.capacity() * sizeof(double));
+}
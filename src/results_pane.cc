@@ -8,6 +8,7 @@
 #include "onsag/on_sag_app.h"
 #include "onsag/on_sag_doc.h"
 #include "onsag/on_sag_view.h"
+#include "onsag/span_sagger.h"
 
 BEGIN_EVENT_TABLE(ResultsPane, wxPanel)
   EVT_LIST_ITEM_SELECTED(wxID_ANY, ResultsPane::OnListCtrlSelect)
@@ -37,6 +38,9 @@ void ResultsPane::Update(wxObject* hint) {
   const UpdateHint* hint_update = dynamic_cast<UpdateHint*>(hint);
   if (hint_update == nullptr) {
     // do nothing, this is only passed when pane is created
+  } else if (hint_update->type() == UpdateHint::Type::kAnalysisUpdate) {
+    UpdateReportData();
+    table_->Refresh();
   } else if (hint_update->type() == UpdateHint::Type::kPreferencesEdit) {
     UpdateReportData();
     table_->Refresh();
@@ -61,31 +65,15 @@ void ResultsPane::OnListCtrlSelect(wxListEvent& event) {
   table_->set_index_selected(index_selected);
 
   // gets selected index with no sorting applied
-  // this still may not be the correct index, as invalid results are excluded
-  // from the table
+  // this is the report row index, which is not the document index since
+  // invalid results are excluded from the table
   const long index_unsorted = table_->IndexReportRow(index_selected);
 
   // gets the document index
-  const std::string& str_doc = table_->ValueTable(index_unsorted, 0);
-
   long index_document = -1;
-  const OnSagDoc* doc = dynamic_cast<const OnSagDoc*>(view_->GetDocument());
-  for (unsigned int i = 0; i < doc->Results()->size(); i++) {
-    // gets document result
-    const SaggingAnalysisResult* result = doc->Result(i);
-    if (result == nullptr) {
-      continue;
-    }
-
-    // converts result to string
-    std::string str_result =
-        helper::DoubleToFormattedString(*result->temperature_cable, 0);
-
-    // compares document string to result string
-    if (str_doc == str_result) {
-      index_document = i;
-      break;
-    }
+  if ((0 <= index_unsorted)
+      && (index_unsorted < static_cast<long>(indexes_result_.size()))) {
+    index_document = indexes_result_[index_unsorted];
   }
 
   // updates view index
@@ -103,6 +91,7 @@ void ResultsPane::UpdateReportData() {
   // initializes data
   data_.headers.clear();
   data_.rows.clear();
+  indexes_result_.clear();
 
   // gets activated span from document
   OnSagDoc* doc = dynamic_cast<OnSagDoc*>(view_->GetDocument());
@@ -112,11 +101,14 @@ void ResultsPane::UpdateReportData() {
   }
 
   // gets all valid results from document
+  // the document index is stored for each result, since the report rows are
+  // filled in the same order
   std::list<const SaggingAnalysisResult*> results;
   for (unsigned int i = 0; i < doc->Results()->size(); i++) {
     const SaggingAnalysisResult* result = doc->Result(i);
     if (result != nullptr) {
       results.push_back(result);
+      indexes_result_.push_back(i);
     }
   }
 
@@ -160,6 +152,16 @@ void ResultsPane::UpdateReportDataDyno(
   header.width = wxLIST_AUTOSIZE;
   data_.headers.push_back(header);
 
+  header.title = "T (Back)";
+  header.format = wxLIST_FORMAT_CENTER;
+  header.width = wxLIST_AUTOSIZE;
+  data_.headers.push_back(header);
+
+  header.title = "T (Ahead)";
+  header.format = wxLIST_FORMAT_CENTER;
+  header.width = wxLIST_AUTOSIZE;
+  data_.headers.push_back(header);
+
   // checks if results has any data
   if (results->empty() == true) {
     return;
@@ -177,7 +179,7 @@ void ResultsPane::UpdateReportDataDyno(
 
     // adds temperature
     value = *result->temperature_cable;
-    str = helper::DoubleToFormattedString(value, 0);
+    str = helper::DoubleToFormattedString(value, 1);
     row.values.push_back(str);
 
     // adds tension-horizontal
@@ -186,7 +188,7 @@ void ResultsPane::UpdateReportDataDyno(
     row.values.push_back(str);
 
     // adds sag
-    value = result->catenary.Sag();
+    value = result->sag;
     str = helper::DoubleToFormattedString(value, 2);
     row.values.push_back(str);
 
@@ -195,6 +197,16 @@ void ResultsPane::UpdateReportDataDyno(
     str = helper::DoubleToFormattedString(value, 0);
     row.values.push_back(str);
 
+    // adds tension-dyno-back
+    value = result->tension_dyno_back;
+    str = helper::DoubleToFormattedString(value, 0);
+    row.values.push_back(str);
+
+    // adds tension-dyno-ahead
+    value = result->tension_dyno_ahead;
+    str = helper::DoubleToFormattedString(value, 0);
+    row.values.push_back(str);
+
     // appends row to list
     data_.rows.push_back(row);
   }
@@ -234,6 +246,14 @@ void ResultsPane::UpdateReportDataStopwatch(
   header.width = wxLIST_AUTOSIZE;
   data_.headers.push_back(header);
 
+  // adds a column for every wave in the return time table
+  for (int i = 1; i <= SpanSaggerResult::kNumWavesReturn; i++) {
+    header.title = "T" + std::to_string(i);
+    header.format = wxLIST_FORMAT_CENTER;
+    header.width = wxLIST_AUTOSIZE;
+    data_.headers.push_back(header);
+  }
+
   // checks if results has any data
   if (results->empty() == true) {
     return;
@@ -251,7 +271,7 @@ void ResultsPane::UpdateReportDataStopwatch(
 
     // adds temperature
     value = *result->temperature_cable;
-    str = helper::DoubleToFormattedString(value, 0);
+    str = helper::DoubleToFormattedString(value, 1);
     row.values.push_back(str);
 
     // adds tension-horizontal
@@ -260,7 +280,7 @@ void ResultsPane::UpdateReportDataStopwatch(
     row.values.push_back(str);
 
     // adds sag
-    value = result->catenary.Sag();
+    value = result->sag;
     str = helper::DoubleToFormattedString(value, 2);
     row.values.push_back(str);
 
@@ -270,7 +290,7 @@ void ResultsPane::UpdateReportDataStopwatch(
     row.values.push_back(str);
 
     // adds length
-    value = result->catenary.Length();
+    value = result->length;
     str = helper::DoubleToFormattedString(value, 2);
     row.values.push_back(str);
 
@@ -279,6 +299,17 @@ void ResultsPane::UpdateReportDataStopwatch(
     str = helper::DoubleToFormattedString(value, 2);
     row.values.push_back(str);
 
+    // adds times-return
+    // the table is filled when the result is solved, so it is not recalculated
+    for (int i = 0; i < SpanSaggerResult::kNumWavesReturn; i++) {
+      str = "";
+      if (i < static_cast<int>(result->times_return.size())) {
+        value = result->times_return[i];
+        str = helper::DoubleToFormattedString(value, 2);
+      }
+      row.values.push_back(str);
+    }
+
     // appends row to list
     data_.rows.push_back(row);
   }
@@ -335,7 +366,7 @@ void ResultsPane::UpdateReportDataTransit(
 
     // adds temperature
     value = *result->temperature_cable;
-    str = helper::DoubleToFormattedString(value, 0);
+    str = helper::DoubleToFormattedString(value, 1);
     row.values.push_back(str);
 
     // adds tension-horizontal
@@ -344,7 +375,7 @@ void ResultsPane::UpdateReportDataTransit(
     row.values.push_back(str);
 
     // adds sag
-    value = result->catenary.Sag();
+    value = result->sag;
     str = helper::DoubleToFormattedString(value, 2);
     row.values.push_back(str);
 
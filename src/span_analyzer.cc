@@ -0,0 +1,378 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#include "onsag/span_analyzer.h"
+
+#include <string>
+
+#include "models/base/helper.h"
+
+TemperatureSweep::TemperatureSweep() {
+  num_intervals = 2;
+  step = 1;
+  type = Type::kSpan;
+}
+
+bool TemperatureSweep::Validate(const bool& /**is_included_warnings**/,
+                                std::list<ErrorMessage>* messages) const {
+  // initializes
+  bool is_valid = true;
+  ErrorMessage message;
+  message.title = "TEMPERATURE SWEEP";
+
+  // validates type and type-specific parameters
+  if (type == Type::kCable) {
+    if (step <= 0) {
+      is_valid = false;
+      if (messages != nullptr) {
+        message.description = "Invalid temperature step";
+        messages->push_back(message);
+      }
+    }
+  } else if (type == Type::kSpan) {
+    if (num_intervals < 0) {
+      is_valid = false;
+      if (messages != nullptr) {
+        message.description = "Invalid number of temperature intervals";
+        messages->push_back(message);
+      }
+    }
+  } else {
+    is_valid = false;
+    if (messages != nullptr) {
+      message.description = "Invalid sweep type";
+      messages->push_back(message);
+    }
+  }
+
+  // returns validation status
+  return is_valid;
+}
+
+
+const int SpanAnalyzer::kNumTemperaturesMax = 10000;
+
+SpanAnalyzer::SpanAnalyzer() {
+  cache_ = nullptr;
+  iterations_correction_ = 0;
+  span_ = nullptr;
+  units_ = units::UnitSystem::kNull;
+
+  sagger_.set_is_sensitivity_solved(true);
+  sagger_.set_is_warm_started(true);
+}
+
+SpanAnalyzer::~SpanAnalyzer() {
+}
+
+bool SpanAnalyzer::Analyze(const double* temperature,
+                           SaggingAnalysisResult& result,
+                           std::list<ErrorMessage>* messages) {
+  // initializes result
+  result.angle_transit = -999999;
+  result.catenary = Catenary3d();
+  result.direction_transit = AxisDirectionType::kNull;
+  result.distance_target = -999999;
+  result.factor_control = -999999;
+  result.length = -999999;
+  result.offset_coordinates = Point2d<double>();
+  result.point_target = Point2d<double>();
+  result.sag = -999999;
+  result.sensitivity_creep = SpanSaggerSensitivity();
+  result.sensitivity_temperature = SpanSaggerSensitivity();
+  result.sensitivity_weight = SpanSaggerSensitivity();
+  result.speed_wave = -999999;
+  result.temperature_cable = nullptr;
+  result.tension_dyno = -999999;
+  result.tension_dyno_ahead = -999999;
+  result.tension_dyno_back = -999999;
+  result.time_stopwatch = -999999;
+  result.times_return.clear();
+
+  // checks for a span and temperature before any calculations
+  if ((span_ == nullptr) || (temperature == nullptr)) {
+    if (messages != nullptr) {
+      ErrorMessage message;
+      message.title = "SPAN ANALYZER";
+      if (span_ == nullptr) {
+        message.description = "Invalid span";
+      } else {
+        message.description = "Invalid temperature";
+      }
+      messages->push_back(message);
+    }
+
+    return false;
+  }
+
+  // searches the cache for a previously solved result
+  std::string key;
+  if (cache_ != nullptr) {
+    key = ResultCache::Key(*span_, *temperature, units_,
+                           sagger_.tolerance_parabola());
+    if (cache_->Find(key, result) == true) {
+      result.temperature_cable = temperature;
+
+      // selects the dynamometer end, which is not part of the key
+      if (span_->method.end == SagMethod::SpanEndType::kAheadOnLine) {
+        result.tension_dyno = result.tension_dyno_ahead;
+      } else {
+        result.tension_dyno = result.tension_dyno_back;
+      }
+
+      // selects the stopwatch time from the return time table, since the
+      // wave number is only part of the key if it is beyond the table
+      const int& wave_return = span_->method.wave_return;
+      if ((span_->method.type == SagMethod::Type::kStopWatch)
+          && (1 <= wave_return)
+          && (wave_return <= static_cast<int>(result.times_return.size()))) {
+        result.time_stopwatch = result.times_return[wave_return - 1];
+      }
+
+      return true;
+    }
+  }
+
+  // sets up sagger
+  // the span and units are already set, so the cable tension curve is reused
+  sagger_.set_temperature(temperature);
+
+  // solves the sagger once and returns any errors
+  const SpanSaggerResult result_sagger = sagger_.Result();
+  if (result_sagger.status != SpanSaggerResult::StatusType::kSuccess) {
+    if (messages != nullptr) {
+      // adds analyzer error message to give context
+      ErrorMessage message;
+      message.title = "SPAN ANALYZER";
+      message.description = "No sagging solution for "
+                            + helper::DoubleToFormattedString(*temperature, 0)
+                            + " degrees";
+      messages->push_back(message);
+
+      // adds sagger error messages
+      // the sagger is only validated on failure to get detailed messages
+      sagger_.Validate(false, messages);
+    }
+
+    return false;
+  }
+
+  // copies the sagger result
+  iterations_correction_ += result_sagger.iterations_correction;
+  result.angle_transit = result_sagger.angle_transit;
+  result.catenary = result_sagger.catenary;
+  result.direction_transit = result_sagger.direction_transit;
+  result.distance_target = result_sagger.distance_target;
+  result.factor_control = result_sagger.factor_control;
+  result.length = result_sagger.length;
+  result.offset_coordinates = span_->structure_back.point_attachment;
+  result.point_target = result_sagger.point_target;
+  result.sag = result_sagger.sag;
+  result.sensitivity_creep = result_sagger.sensitivity_creep;
+  result.sensitivity_temperature = result_sagger.sensitivity_temperature;
+  result.sensitivity_weight = result_sagger.sensitivity_weight;
+  result.speed_wave = result_sagger.speed_wave;
+  result.temperature_cable = temperature;
+  result.tension_dyno = result_sagger.tension_dyno;
+  result.tension_dyno_ahead = result_sagger.tension_dyno_ahead;
+  result.tension_dyno_back = result_sagger.tension_dyno_back;
+  result.time_stopwatch = result_sagger.time_stopwatch;
+  result.times_return = result_sagger.times_return;
+
+  // adds to cache
+  if (cache_ != nullptr) {
+    cache_->Insert(key, result);
+  }
+
+  return true;
+}
+
+bool SpanAnalyzer::Analyze(const std::vector<double>& temperatures,
+                           std::vector<SaggingAnalysisResult>& results,
+                           std::list<ErrorMessage>* messages) {
+  bool status = true;
+
+  // creates empty set of results
+  results.clear();
+  results.resize(temperatures.size(), SaggingAnalysisResult());
+
+  // analyzes each temperature
+  const int kSizeTemperatures = temperatures.size();
+  for (int i = 0; i < kSizeTemperatures; i++) {
+    if (Analyze(&temperatures[i], results[i], messages) == false) {
+      status = false;
+    }
+  }
+
+  return status;
+}
+
+std::vector<double> SpanAnalyzer::Temperatures(const SagSpan& span) {
+  return Temperatures(span, TemperatureSweep());
+}
+
+std::vector<double> SpanAnalyzer::Temperatures(
+    const SagSpan& span,
+    const TemperatureSweep& sweep,
+    std::list<ErrorMessage>* messages) {
+  std::vector<double> temperatures;
+
+  if (sweep.Validate(false, messages) == false) {
+    return temperatures;
+  }
+
+  // gets the temperature range and step
+  double temperature_low = -999999;
+  double step = -999999;
+  int num_temperatures = 0;
+  if (sweep.type == TemperatureSweep::Type::kSpan) {
+    temperature_low = span.temperature_base
+                      - (sweep.num_intervals * span.temperature_interval);
+    step = span.temperature_interval;
+
+    // the intervals are checked before counting so the count can't overflow
+    if (sweep.num_intervals <= (kNumTemperaturesMax / 2)) {
+      num_temperatures = (2 * sweep.num_intervals) + 1;
+    } else {
+      num_temperatures = kNumTemperaturesMax + 1;
+    }
+  } else if (sweep.type == TemperatureSweep::Type::kCable) {
+    // gets the range that the solver accepts
+    double temperature_high = -999999;
+    if (SpanCatenarySolver::TemperatureRange(span.cable, temperature_low,
+                                             temperature_high) == false) {
+      return temperatures;
+    }
+
+    // a small tolerance includes the high end if it lands on a step
+    // the count is checked as a double so a tiny step can't overflow it
+    step = sweep.step;
+    const double num_steps = ((temperature_high - temperature_low) / step)
+                             + 1e-9;
+    if (num_steps < kNumTemperaturesMax) {
+      num_temperatures = static_cast<int>(num_steps) + 1;
+    } else {
+      num_temperatures = kNumTemperaturesMax + 1;
+    }
+  }
+
+  // fails instead of silently truncating the sweep
+  if (kNumTemperaturesMax < num_temperatures) {
+    if (messages != nullptr) {
+      ErrorMessage message;
+      message.title = "SPAN ANALYZER";
+      message.description = "Temperature sweep exceeds "
+                            + std::to_string(kNumTemperaturesMax)
+                            + " temperatures";
+      messages->push_back(message);
+    }
+
+    return temperatures;
+  }
+
+  // calculates target temperatures
+  temperatures.reserve(num_temperatures);
+  for (int i = 0; i < num_temperatures; i++) {
+    temperatures.push_back(temperature_low + (i * step));
+  }
+
+  return temperatures;
+}
+
+bool SpanAnalyzer::Validate(const bool& is_included_warnings,
+                            std::list<ErrorMessage>* messages) const {
+  // initializes
+  bool is_valid = true;
+  ErrorMessage message;
+  message.title = "SPAN ANALYZER";
+
+  // validates span
+  if (span_ == nullptr) {
+    is_valid = false;
+    if (messages != nullptr) {
+      message.description = "Invalid span";
+      messages->push_back(message);
+    }
+  } else if (span_->Validate(is_included_warnings, messages) == false) {
+    is_valid = false;
+  }
+
+  // validates units
+  if (units_ == units::UnitSystem::kNull) {
+    is_valid = false;
+    if (messages != nullptr) {
+      message.description = "Invalid unit system";
+      messages->push_back(message);
+    }
+  }
+
+  // returns validation status
+  return is_valid;
+}
+
+void SpanAnalyzer::set_cache(ResultCache* cache) {
+  cache_ = cache;
+}
+
+void SpanAnalyzer::set_is_warm_started(const bool& is_warm_started) {
+  sagger_.set_is_warm_started(is_warm_started);
+}
+
+void SpanAnalyzer::set_span(const SagSpan* span) {
+  span_ = span;
+  iterations_correction_ = 0;
+
+  // updates sagger
+  if (span_ == nullptr) {
+    sagger_.set_cable(nullptr);
+    sagger_.set_method(nullptr);
+    sagger_.set_structure_ahead(nullptr);
+    sagger_.set_structure_back(nullptr);
+  } else {
+    sagger_.set_cable(&span_->cable);
+    sagger_.set_method(&span_->method);
+    sagger_.set_structure_ahead(&span_->structure_ahead);
+    sagger_.set_structure_back(&span_->structure_back);
+  }
+}
+
+void SpanAnalyzer::set_tolerance_parabola(const double& tolerance_parabola) {
+  sagger_.set_tolerance_parabola(tolerance_parabola);
+}
+
+void SpanAnalyzer::set_units(const units::UnitSystem& units) {
+  units_ = units;
+  sagger_.set_units(units_);
+}
+
+ResultCache* SpanAnalyzer::cache() const {
+  return cache_;
+}
+
+bool SpanAnalyzer::is_warm_started() const {
+  return sagger_.is_warm_started();
+}
+
+int SpanAnalyzer::iterations_correction() const {
+  return iterations_correction_;
+}
+
+int SpanAnalyzer::num_solves_parabola() const {
+  return sagger_.num_solves_parabola();
+}
+
+int SpanAnalyzer::num_solves_parabola_fallback() const {
+  return sagger_.num_solves_parabola_fallback();
+}
+
+const SagSpan* SpanAnalyzer::span() const {
+  return span_;
+}
+
+double SpanAnalyzer::tolerance_parabola() const {
+  return sagger_.tolerance_parabola();
+}
+
+units::UnitSystem SpanAnalyzer::units() const {
+  return units_;
+}
@@ -0,0 +1,508 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#include "onsag/span_catenary_solver.h"
+
+#include <cmath>
+
+#include "models/transmissionline/catenary_solver.h"
+
+SpanCatenarySolver::SpanCatenarySolver() {
+  cable_ = nullptr;
+  structure_ahead_ = nullptr;
+  structure_back_ = nullptr;
+  temperature_ = nullptr;
+  tolerance_parabola_ = 0;
+
+  is_warm_started_ = false;
+  iterations_correction_ = -999999;
+  length_ = -999999;
+  num_solves_ = 0;
+  num_solves_parabola_ = 0;
+  num_solves_parabola_fallback_ = 0;
+  sag_ = -999999;
+  seed_tension_corrected_ = -999999;
+  seed_tension_uncorrected_ = -999999;
+  tension_uncorrected_ = -999999;
+
+  is_updated_catenary_ = false;
+}
+
+SpanCatenarySolver::~SpanCatenarySolver() {
+}
+
+const Catenary3d* SpanCatenarySolver::Catenary() const {
+  // updates class if necessary
+  if ((IsUpdated() == false) && (Update() == false)) {
+    return nullptr;
+  }
+
+  return &catenary_;
+}
+
+int SpanCatenarySolver::IterationsCorrection() const {
+  // updates class if necessary
+  if ((IsUpdated() == false) && (Update() == false)) {
+    return -999999;
+  }
+
+  return iterations_correction_;
+}
+
+bool SpanCatenarySolver::IsUpdated() const {
+  return is_updated_catenary_ == true;
+}
+
+double SpanCatenarySolver::Length() const {
+  // updates class if necessary
+  if ((IsUpdated() == false) && (Update() == false)) {
+    return -999999;
+  }
+
+  return length_;
+}
+
+double SpanCatenarySolver::Sag() const {
+  // updates class if necessary
+  if ((IsUpdated() == false) && (Update() == false)) {
+    return -999999;
+  }
+
+  return sag_;
+}
+
+bool SpanCatenarySolver::TemperatureRange(const SagCable& cable,
+                                          double& temperature_min,
+                                          double& temperature_max) {
+  temperature_min = -999999;
+  temperature_max = -999999;
+
+  if (cable.tensions.empty() == true) {
+    return false;
+  }
+
+  // the tension points are in ascending temperature order
+  temperature_min = cable.tensions.front().temperature
+                    + cable.correction_creep;
+  temperature_max = cable.tensions.back().temperature
+                    + cable.correction_creep;
+  return true;
+}
+
+bool SpanCatenarySolver::SlopesTensionHorizontal(double& slope_temperature,
+                                                 double& slope_weight) const {
+  slope_temperature = -999999;
+  slope_weight = -999999;
+
+  // updates class if necessary
+  if ((IsUpdated() == false) && (Update() == false)) {
+    return false;
+  }
+
+  // gets the uncorrected tension slope from the tension curve
+  const double temperature = *temperature_ - cable_->correction_creep;
+  double slope = curve_.SlopeTensionHorizontal(temperature);
+  if (slope == -999999) {
+    return false;
+  }
+  slope = slope * cable_->scale;
+
+  // the uncorrected tension does not depend on the weight
+  if (cable_->correction_sag == 0) {
+    slope_temperature = slope;
+    slope_weight = 0;
+    return true;
+  }
+
+  // the corrected sag differs from the uncorrected sag by a constant, and the
+  // sag only depends on the ratio of the tension to the weight, so the
+  // uncorrected tension slopes are scaled by the ratio of the sag slopes
+  const double tension = catenary_.tension_horizontal();
+  const double weight = catenary_.weight_unit().z();
+  const double slope_sag = SlopeSag(tension);
+  if (slope_sag == 0) {
+    return false;
+  }
+
+  const double ratio = SlopeSag(tension_uncorrected_) / slope_sag;
+  slope_temperature = ratio * slope;
+  slope_weight = (tension - (ratio * tension_uncorrected_)) / weight;
+  return true;
+}
+
+const SagCable* SpanCatenarySolver::cable() const {
+  return cable_;
+}
+
+bool SpanCatenarySolver::is_warm_started() const {
+  return is_warm_started_;
+}
+
+int SpanCatenarySolver::num_solves() const {
+  return num_solves_;
+}
+
+int SpanCatenarySolver::num_solves_parabola() const {
+  return num_solves_parabola_;
+}
+
+int SpanCatenarySolver::num_solves_parabola_fallback() const {
+  return num_solves_parabola_fallback_;
+}
+
+void SpanCatenarySolver::set_cable(const SagCable* cable) {
+  cable_ = cable;
+  curve_.set_cable(cable);
+  ResetSeed();
+  is_updated_catenary_ = false;
+}
+
+void SpanCatenarySolver::set_is_warm_started(const bool& is_warm_started) {
+  is_warm_started_ = is_warm_started;
+  ResetSeed();
+}
+
+void SpanCatenarySolver::set_structure_ahead(
+    const SagStructure* structure_ahead) {
+  structure_ahead_ = structure_ahead;
+  ResetSeed();
+  is_updated_catenary_ = false;
+}
+
+void SpanCatenarySolver::set_structure_back(
+    const SagStructure* structure_back) {
+  structure_back_ = structure_back;
+  ResetSeed();
+  is_updated_catenary_ = false;
+}
+
+void SpanCatenarySolver::set_temperature(const double* temperature) {
+  temperature_ = temperature;
+  is_updated_catenary_ = false;
+}
+
+void SpanCatenarySolver::set_tolerance_parabola(
+    const double& tolerance_parabola) {
+  tolerance_parabola_ = tolerance_parabola;
+  is_updated_catenary_ = false;
+}
+
+const SagStructure* SpanCatenarySolver::structure_ahead() const {
+  return structure_ahead_;
+}
+
+const SagStructure* SpanCatenarySolver::structure_back() const {
+  return structure_back_;
+}
+
+const double* SpanCatenarySolver::temperature() const {
+  return temperature_;
+}
+
+double SpanCatenarySolver::tolerance_parabola() const {
+  return tolerance_parabola_;
+}
+
+bool SpanCatenarySolver::LengthParabola(const double& tension_horizontal,
+                                        double& length,
+                                        double& bound) const {
+  length = -999999;
+  bound = -999999;
+
+  const double spacing_horizontal = std::abs(catenary_.spacing_endpoints().x());
+  const double spacing_vertical = catenary_.spacing_endpoints().z();
+  const double weight = catenary_.weight_unit().z();
+  if ((spacing_horizontal <= 0) || (tension_horizontal <= 0)
+      || (weight <= 0)) {
+    return false;
+  }
+
+  // the bound on cosh(s) requires s^2 < 2
+  const double s = spacing_horizontal * weight / (2 * tension_horizontal);
+  const double s2 = s * s;
+  if (2 <= s2) {
+    return false;
+  }
+  const double cosh_max = 2 / (2 - s2);
+
+  // the catenary length is sqrt(h^2 + (a * sinh(s) / s)^2), so the series is
+  // truncated after the s^2 term
+  const double length_horizontal = spacing_horizontal * (1 + (s2 / 6));
+  length = std::sqrt((spacing_vertical * spacing_vertical)
+                     + (length_horizontal * length_horizontal));
+  bound = spacing_horizontal * cosh_max * s2 * s2 / 120;
+  return true;
+}
+
+void SpanCatenarySolver::ResetSeed() const {
+  seed_tension_corrected_ = -999999;
+  seed_tension_uncorrected_ = -999999;
+}
+
+bool SpanCatenarySolver::SagParabola(const double& tension_horizontal,
+                                     double& sag, double& bound) const {
+  sag = -999999;
+  bound = -999999;
+
+  const double spacing_horizontal = std::abs(catenary_.spacing_endpoints().x());
+  const double spacing_vertical = catenary_.spacing_endpoints().z();
+  const double weight = catenary_.weight_unit().z();
+  if ((spacing_horizontal <= 0) || (tension_horizontal <= 0)
+      || (weight <= 0)) {
+    return false;
+  }
+
+  // the bound on cosh(s) requires s^2 < 2
+  const double constant = tension_horizontal / weight;
+  const double s = spacing_horizontal / (2 * constant);
+  if (2 <= s * s) {
+    return false;
+  }
+  const double cosh_max = 2 / (2 - (s * s));
+
+  // the sag is measured vertically from the chord, so it is scaled by the
+  // chord length
+  const double slope = spacing_vertical / spacing_horizontal;
+  const double factor_chord = std::sqrt(1 + (slope * slope));
+  sag = factor_chord * spacing_horizontal * s / 4;
+  bound = constant * cosh_max * std::pow(s, 3)
+          * ((factor_chord * s / 24) + (std::abs(slope) / 6));
+  return true;
+}
+
+double SpanCatenarySolver::SlopeSag(const double& tension_horizontal) const {
+  const double kStepDerivative = 1e-6;
+
+  const double step = tension_horizontal * kStepDerivative;
+  Catenary3d catenary = catenary_;
+  catenary.set_tension_horizontal(tension_horizontal + step);
+  const double sag_high = catenary.Sag();
+  catenary.set_tension_horizontal(tension_horizontal - step);
+  const double sag_low = catenary.Sag();
+
+  return (sag_high - sag_low) / (2 * step);
+}
+
+bool SpanCatenarySolver::SolveCorrectionParabola(
+    const double& tension_horizontal,
+    double& tension_parabola) const {
+  tension_parabola = tension_horizontal;
+
+  // gets the uncorrected parabolic sag
+  double sag = -999999;
+  double bound = -999999;
+  if (SagParabola(tension_horizontal, sag, bound) == false) {
+    return false;
+  }
+
+  const double sag_target = sag + cable_->correction_sag;
+  if (sag_target <= 0) {
+    return false;
+  }
+
+  // scales the tension by the parabolic sag ratio, so the corrected parabolic
+  // sag matches the target
+  tension_parabola = tension_horizontal * (sag / sag_target);
+
+  // the catenary sag error is bounded by the parabola error at both tensions
+  double sag_parabola = -999999;
+  double bound_parabola = -999999;
+  if ((SagParabola(tension_parabola, sag_parabola, bound_parabola) == false)
+      || (tolerance_parabola_ < (bound + bound_parabola))) {
+    return false;
+  }
+
+  catenary_.set_tension_horizontal(tension_parabola);
+  return true;
+}
+
+bool SpanCatenarySolver::SolveCorrectionSag(const double& tension_seed,
+                                            const double& sag_target) const {
+  // the sag is nearly inversely proportional to the horizontal tension, so
+  // the solve is done on the reciprocal of the sag, which is nearly linear
+  // with tension and converges in very few newton iterations
+  const int kIterationsMax = 50;
+  const double kPrecision = 1e-10;
+  const double kStepDerivative = 1e-6;
+
+  iterations_correction_ = 0;
+  if (sag_target <= 0) {
+    return false;
+  }
+
+  Catenary3d catenary = catenary_;
+  double tension = tension_seed;
+  while (iterations_correction_ < kIterationsMax) {
+    // calculates the sag error at the current tension
+    catenary.set_tension_horizontal(tension);
+    const double sag = catenary.Sag();
+    if (std::abs(sag - sag_target) <= kPrecision * sag_target) {
+      catenary_.set_tension_horizontal(tension);
+      return true;
+    }
+
+    iterations_correction_++;
+
+    // calculates the slope using a forward difference
+    const double step = tension * kStepDerivative;
+    catenary.set_tension_horizontal(tension + step);
+    const double sag_step = catenary.Sag();
+    const double slope = ((1 / sag_step) - (1 / sag)) / step;
+    if (slope <= 0) {
+      return false;
+    }
+
+    // updates the tension, limiting the step so the tension stays positive
+    double tension_next = tension - (((1 / sag) - (1 / sag_target)) / slope);
+    if (tension_next <= 0) {
+      tension_next = tension / 2;
+    }
+    tension = tension_next;
+  }
+
+  return false;
+}
+
+bool SpanCatenarySolver::Update() const {
+  // updates the catenary
+  is_updated_catenary_ = UpdateCatenary();
+  if (is_updated_catenary_ == false) {
+    return false;
+  }
+
+  num_solves_++;
+
+  // if it reaches this point, update was successful
+  return true;
+}
+
+bool SpanCatenarySolver::UpdateCatenary() const {
+  // checks inputs
+  if ((cable_ == nullptr) || (structure_ahead_ == nullptr)
+      || (structure_back_ == nullptr) || (temperature_ == nullptr)
+      || (cable_->tensions.empty() == true)) {
+    return false;
+  }
+
+  // determines if the temperature is within the solvable range
+  double temperature_min = -999999;
+  double temperature_max = -999999;
+  TemperatureRange(*cable_, temperature_min, temperature_max);
+  if ((*temperature_ < temperature_min) || (temperature_max < *temperature_)) {
+    return false;
+  }
+
+  // adjusts temperature based on creep correction
+  // this is clamped to the tension points, since removing the creep shift can
+  // round just past the range ends
+  double temperature = *temperature_ - cable_->correction_creep;
+  if (temperature < cable_->tensions.front().temperature) {
+    temperature = cable_->tensions.front().temperature;
+  } else if (cable_->tensions.back().temperature < temperature) {
+    temperature = cable_->tensions.back().temperature;
+  }
+
+  // interpolates to find the tension
+  double tension_horizontal = curve_.TensionHorizontal(temperature);
+  if (tension_horizontal == -999999) {
+    return false;
+  }
+
+  // applies scaling factor to tension
+  tension_horizontal = tension_horizontal * cable_->scale;
+  tension_uncorrected_ = tension_horizontal;
+
+  // solves for the catenary spacing
+  Vector3d spacing;
+  spacing.set_x(structure_ahead_->point_attachment.x
+                - structure_back_->point_attachment.x);
+  spacing.set_y(0);
+  spacing.set_z(structure_ahead_->point_attachment.y
+                - structure_back_->point_attachment.y);
+
+  // solves for unit weight
+  Vector3d weight_unit;
+  weight_unit.set_x(0);
+  weight_unit.set_y(0);
+  weight_unit.set_z(cable_->weight_unit);
+
+  // builds a catenary
+  catenary_.set_direction_transverse(AxisDirectionType::kPositive);
+  catenary_.set_spacing_endpoints(spacing);
+  catenary_.set_tension_horizontal(tension_horizontal);
+  catenary_.set_weight_unit(weight_unit);
+
+  // accounts for sag correction
+  iterations_correction_ = 0;
+  bool is_parabola = 0 < tolerance_parabola_;
+  if (cable_->correction_sag != 0) {
+    // solves with the parabola if enabled, and uses the parabolic tension as
+    // the seed if it exceeds the tolerance
+    double tension_seed = tension_horizontal;
+    if (is_parabola == true) {
+      is_parabola = SolveCorrectionParabola(tension_horizontal, tension_seed);
+    }
+
+    // solves for the corrected tension if the parabola did not, falling back
+    // to the general solver if the iterations do not converge
+    if (is_parabola == false) {
+      const double sag_target = catenary_.Sag() + cable_->correction_sag;
+
+      // selects the warm start seed tension
+      // the sag correction shifts the reciprocal of the tension by a nearly
+      // constant amount, so the previous shift is applied to the warm start
+      if ((is_warm_started_ == true) && (seed_tension_corrected_ != -999999)) {
+        const double tension_warm = 1 / ((1 / tension_horizontal)
+                                         + (1 / seed_tension_corrected_)
+                                         - (1 / seed_tension_uncorrected_));
+        if (0 < tension_warm) {
+          tension_seed = tension_warm;
+        }
+      }
+
+      if (SolveCorrectionSag(tension_seed, sag_target) == false) {
+        CatenarySolver solver;
+        solver.set_spacing_endpoints(catenary_.spacing_endpoints());
+        solver.set_type_target(CatenarySolver::TargetType::kSag);
+        solver.set_value_target(sag_target);
+        solver.set_weight_unit(catenary_.weight_unit());
+
+        if (solver.Validate() == true) {
+          catenary_ = solver.Catenary();
+        } else {
+          ResetSeed();
+          return false;
+        }
+      }
+    }
+
+    // stores the seed for the next solve
+    seed_tension_corrected_ = catenary_.tension_horizontal();
+    seed_tension_uncorrected_ = tension_horizontal;
+  }
+
+  if (catenary_.Validate(false, nullptr) == false) {
+    return false;
+  }
+
+  // calculates the sag and length with the parabola if both are within the
+  // tolerance, otherwise with the catenary
+  const double tension = catenary_.tension_horizontal();
+  double bound_length = -999999;
+  double bound_sag = -999999;
+  if ((is_parabola == true)
+      && (SagParabola(tension, sag_, bound_sag) == true)
+      && (LengthParabola(tension, length_, bound_length) == true)
+      && (bound_sag <= tolerance_parabola_)
+      && (bound_length <= tolerance_parabola_)) {
+    num_solves_parabola_++;
+  } else {
+    if (0 < tolerance_parabola_) {
+      num_solves_parabola_fallback_++;
+    }
+    length_ = catenary_.Length();
+    sag_ = catenary_.Sag();
+  }
+
+  return true;
+}
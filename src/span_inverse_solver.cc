@@ -0,0 +1,283 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#include "onsag/span_inverse_solver.h"
+
+#include <cmath>
+
+SpanInverseResult::SpanInverseResult() {
+  is_solved = false;
+  iterations = 0;
+  temperature = -999999;
+  tension_horizontal = -999999;
+}
+
+SpanInverseSolver::SpanInverseSolver() {
+  span_ = nullptr;
+  temperature_ = -999999;
+  units_ = units::UnitSystem::kNull;
+
+  // the sagger always references the same temperature, which is modified
+  // for each evaluation
+  sagger_.set_is_warm_started(true);
+  sagger_.set_temperature(&temperature_);
+}
+
+SpanInverseSolver::~SpanInverseSolver() {
+}
+
+bool SpanInverseSolver::Solve(const double& measurement,
+                              SpanInverseResult& result) const {
+  const int kIterationsMax = 100;
+  const double kPrecision = 1e-9;
+  const double kStepTemperature = 1e-4;
+
+  // initializes
+  result = SpanInverseResult();
+
+  if (span_ == nullptr) {
+    return false;
+  }
+
+  // selects the table value that matches the measurement
+  SpanLookupTable::ValueType type;
+  if (span_->method.type == SagMethod::Type::kDynamometer) {
+    type = SpanLookupTable::ValueType::kTensionDyno;
+  } else if (span_->method.type == SagMethod::Type::kStopWatch) {
+    type = SpanLookupTable::ValueType::kTimeStopwatch;
+  } else if (span_->method.type == SagMethod::Type::kTransit) {
+    type = SpanLookupTable::ValueType::kAngleTransit;
+  } else {
+    return false;
+  }
+
+  // searches the table samples for the first bracket
+  // the table is updated by the first query, and is invalid if it fails
+  double temperature_low = -999999;
+  double temperature_high = -999999;
+  double diff_low = -999999;
+  double diff_high = -999999;
+  bool is_bracketed = false;
+  const int kSizeSamples = table_.num_samples();
+  for (int i = 0; i < kSizeSamples - 1; i++) {
+    const double m0 = table_.ValueSample(type, i);
+    const double m1 = table_.ValueSample(type, i + 1);
+    if ((m0 == -999999) || (m1 == -999999)) {
+      continue;
+    }
+
+    if (((m0 - measurement) * (m1 - measurement)) <= 0) {
+      temperature_low = table_.TemperatureSample(i);
+      temperature_high = table_.TemperatureSample(i + 1);
+      diff_low = m0 - measurement;
+      diff_high = m1 - measurement;
+      is_bracketed = true;
+      break;
+    }
+  }
+
+  if (is_bracketed == false) {
+    return false;
+  }
+
+  // orients the bracket so the difference is negative at the low end
+  const double sign = (diff_low <= diff_high) ? 1 : -1;
+  const double tolerance = kPrecision * std::abs(measurement);
+
+  // starts from the linear interpolation of the bracket
+  double temperature = temperature_low;
+  if (diff_low != diff_high) {
+    temperature = temperature_low
+                  - (diff_low * (temperature_high - temperature_low)
+                     / (diff_high - diff_low));
+  }
+
+  double tension_horizontal = -999999;
+  while (result.iterations < kIterationsMax) {
+    result.iterations++;
+
+    // calculates the difference at the current temperature
+    const double value = Measurement(temperature, tension_horizontal);
+    if (value == -999999) {
+      return false;
+    }
+
+    const double diff = value - measurement;
+    if ((std::abs(diff) <= tolerance)
+        || ((temperature_high - temperature_low) <= kPrecision)) {
+      result.is_solved = true;
+      result.temperature = temperature;
+      result.tension_horizontal = tension_horizontal;
+      return true;
+    }
+
+    // narrows the bracket
+    if ((sign * diff) < 0) {
+      temperature_low = temperature;
+      diff_low = diff;
+    } else {
+      temperature_high = temperature;
+      diff_high = diff;
+    }
+
+    // calculates the slope using a finite difference inside the bracket
+    double step = kStepTemperature;
+    if (temperature_high < (temperature + step)) {
+      step = -step;
+    }
+
+    double tension_step = -999999;
+    const double value_step = Measurement(temperature + step, tension_step);
+
+    // takes a newton step, or bisects if the step leaves the bracket
+    double temperature_next = -999999;
+    if (value_step != -999999) {
+      const double slope = (value_step - value) / step;
+      if (slope != 0) {
+        temperature_next = temperature - (diff / slope);
+      }
+    }
+
+    if ((temperature_next <= temperature_low)
+        || (temperature_high <= temperature_next)) {
+      temperature_next = (temperature_low + temperature_high) / 2;
+    }
+
+    // accepts the current temperature if the step is negligible
+    if (std::abs(temperature_next - temperature) <= kPrecision) {
+      result.is_solved = true;
+      result.temperature = temperature;
+      result.tension_horizontal = tension_horizontal;
+      return true;
+    }
+
+    temperature = temperature_next;
+  }
+
+  return false;
+}
+
+int SpanInverseSolver::Solve(const std::vector<double>& measurements,
+                             std::vector<SpanInverseResult>& results) const {
+  results.clear();
+  results.resize(measurements.size(), SpanInverseResult());
+
+  // solves each measurement, sharing the table
+  int num_errors = 0;
+  const int kSizeMeasurements = measurements.size();
+  for (int i = 0; i < kSizeMeasurements; i++) {
+    if (Solve(measurements[i], results[i]) == false) {
+      num_errors++;
+    }
+  }
+
+  return num_errors;
+}
+
+bool SpanInverseSolver::Validate(const bool& is_included_warnings,
+                                 std::list<ErrorMessage>* messages) const {
+  // initializes
+  bool is_valid = true;
+  ErrorMessage message;
+  message.title = "SPAN INVERSE SOLVER";
+
+  // validates span
+  if (span_ == nullptr) {
+    is_valid = false;
+    if (messages != nullptr) {
+      message.description = "Invalid span";
+      messages->push_back(message);
+    }
+  } else if (span_->Validate(is_included_warnings, messages) == false) {
+    is_valid = false;
+  }
+
+  // validates units
+  if (units_ == units::UnitSystem::kNull) {
+    is_valid = false;
+    if (messages != nullptr) {
+      message.description = "Invalid unit system";
+      messages->push_back(message);
+    }
+  }
+
+  // returns if errors are present
+  if (is_valid == false) {
+    return false;
+  }
+
+  // validates the table update process
+  if (table_.TemperatureMin() == -999999) {
+    is_valid = false;
+    if (messages != nullptr) {
+      message.description = "Couldn't solve the span at any cable "
+                            "temperature";
+      messages->push_back(message);
+    }
+  }
+
+  return is_valid;
+}
+
+void SpanInverseSolver::set_span(const SagSpan* span) {
+  span_ = span;
+
+  // updates sagger
+  if (span_ == nullptr) {
+    sagger_.set_cable(nullptr);
+    sagger_.set_method(nullptr);
+    sagger_.set_structure_ahead(nullptr);
+    sagger_.set_structure_back(nullptr);
+  } else {
+    sagger_.set_cable(&span_->cable);
+    sagger_.set_method(&span_->method);
+    sagger_.set_structure_ahead(&span_->structure_ahead);
+    sagger_.set_structure_back(&span_->structure_back);
+  }
+
+  table_.set_span(span_);
+}
+
+void SpanInverseSolver::set_units(const units::UnitSystem& units) {
+  units_ = units;
+  sagger_.set_units(units_);
+  table_.set_units(units_);
+}
+
+const SagSpan* SpanInverseSolver::span() const {
+  return span_;
+}
+
+const SpanLookupTable& SpanInverseSolver::table() const {
+  return table_;
+}
+
+units::UnitSystem SpanInverseSolver::units() const {
+  return units_;
+}
+
+double SpanInverseSolver::Measurement(const double& temperature,
+                                      double& tension_horizontal) const {
+  // solves the sagger at the temperature
+  temperature_ = temperature;
+  sagger_.set_temperature(&temperature_);
+
+  const SpanSaggerResult result = sagger_.Result();
+  if (result.status != SpanSaggerResult::StatusType::kSuccess) {
+    tension_horizontal = -999999;
+    return -999999;
+  }
+
+  tension_horizontal = result.catenary.tension_horizontal();
+
+  // selects the measurement based on method type
+  if (result.type_method == SagMethod::Type::kDynamometer) {
+    return result.tension_dyno;
+  } else if (result.type_method == SagMethod::Type::kStopWatch) {
+    return result.time_stopwatch;
+  } else if (result.type_method == SagMethod::Type::kTransit) {
+    return result.angle_transit;
+  } else {
+    return -999999;
+  }
+}
@@ -0,0 +1,346 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#include "onsag/span_lookup_table.h"
+
+#include "models/base/helper.h"
+
+const int SpanLookupTable::kNumValues = 5;
+
+SpanLookupTable::SpanLookupTable() {
+  num_samples_ = 65;
+  span_ = nullptr;
+  spacing_temperature_ = -999999;
+  temperature_ = -999999;
+  temperature_max_ = -999999;
+  temperature_min_ = -999999;
+  units_ = units::UnitSystem::kNull;
+
+  is_updated_table_ = false;
+
+  // the sagger always references the same temperature, which is modified
+  // for each sample
+  sagger_.set_is_sensitivity_solved(true);
+  sagger_.set_is_warm_started(true);
+  sagger_.set_temperature(&temperature_);
+}
+
+SpanLookupTable::~SpanLookupTable() {
+}
+
+double SpanLookupTable::TemperatureMax() const {
+  // updates class if necessary
+  if ((IsUpdated() == false) && (Update() == false)) {
+    return -999999;
+  }
+
+  return temperature_max_;
+}
+
+double SpanLookupTable::TemperatureMin() const {
+  // updates class if necessary
+  if ((IsUpdated() == false) && (Update() == false)) {
+    return -999999;
+  }
+
+  return temperature_min_;
+}
+
+double SpanLookupTable::TemperatureSample(const int& index) const {
+  // updates class if necessary
+  if ((IsUpdated() == false) && (Update() == false)) {
+    return -999999;
+  }
+
+  if ((index < 0) || (num_samples_ <= index)) {
+    return -999999;
+  }
+
+  return Temperature(index);
+}
+
+bool SpanLookupTable::Validate(const bool& is_included_warnings,
+                               std::list<ErrorMessage>* messages) const {
+  // initializes
+  bool is_valid = true;
+  ErrorMessage message;
+  message.title = "SPAN LOOKUP TABLE";
+
+  // validates num-samples
+  if (num_samples_ < 2) {
+    is_valid = false;
+    if (messages != nullptr) {
+      message.description = "Invalid number of temperature samples";
+      messages->push_back(message);
+    }
+  }
+
+  // validates span
+  if (span_ == nullptr) {
+    is_valid = false;
+    if (messages != nullptr) {
+      message.description = "Invalid span";
+      messages->push_back(message);
+    }
+  } else if (span_->Validate(is_included_warnings, messages) == false) {
+    is_valid = false;
+  }
+
+  // validates units
+  if (units_ == units::UnitSystem::kNull) {
+    is_valid = false;
+    if (messages != nullptr) {
+      message.description = "Invalid unit system";
+      messages->push_back(message);
+    }
+  }
+
+  // returns if errors are present
+  if (is_valid == false) {
+    return false;
+  }
+
+  // validates update process
+  if (Update() == false) {
+    is_valid = false;
+    if (messages != nullptr) {
+      message.description = "Couldn't solve the span at any cable "
+                            "temperature";
+      messages->push_back(message);
+    }
+  }
+
+  return is_valid;
+}
+
+double SpanLookupTable::Value(const ValueType& type,
+                              const double& temperature) const {
+  // updates class if necessary
+  if ((IsUpdated() == false) && (Update() == false)) {
+    return -999999;
+  }
+
+  // checks the table range
+  if ((temperature < temperature_min_) || (temperature_max_ < temperature)) {
+    return -999999;
+  }
+
+  // indexes the segment directly, clamping the maximum temperature to the
+  // last segment
+  int index = static_cast<int>((temperature - temperature_min_)
+                               / spacing_temperature_);
+  if (num_samples_ - 2 < index) {
+    index = num_samples_ - 2;
+  }
+
+  // gets the segment values
+  const int index_value = (index * kNumValues) + static_cast<int>(type);
+  const double& value_0 = values_[index_value];
+  const double& value_1 = values_[index_value + kNumValues];
+  if ((value_0 == -999999) || (value_1 == -999999)) {
+    return -999999;
+  }
+
+  const double temperature_0 = Temperature(index);
+  const double width = Temperature(index + 1) - temperature_0;
+  const double t = (temperature - temperature_0) / width;
+
+  // interpolates linearly if the slopes are not solved
+  const double& slope_0 = slopes_[index_value];
+  const double& slope_1 = slopes_[index_value + kNumValues];
+  if ((slope_0 == -999999) || (slope_1 == -999999)) {
+    return value_0 + (t * (value_1 - value_0));
+  }
+
+  // interpolates with the cubic hermite basis
+  const double t2 = t * t;
+  const double t3 = t2 * t;
+  return ((2 * t3) - (3 * t2) + 1) * value_0
+         + (t3 - (2 * t2) + t) * width * slope_0
+         + ((-2 * t3) + (3 * t2)) * value_1
+         + (t3 - t2) * width * slope_1;
+}
+
+double SpanLookupTable::ValueSample(const ValueType& type,
+                                    const int& index) const {
+  // updates class if necessary
+  if ((IsUpdated() == false) && (Update() == false)) {
+    return -999999;
+  }
+
+  if ((index < 0) || (num_samples_ <= index)) {
+    return -999999;
+  }
+
+  return values_[(index * kNumValues) + static_cast<int>(type)];
+}
+
+void SpanLookupTable::Write(std::ostream& stream) const {
+  // writes header
+  stream << "temperature,"
+            "angle_transit,angle_transit_slope,"
+            "sag,sag_slope,"
+            "tension_dyno,tension_dyno_slope,"
+            "tension_horizontal,tension_horizontal_slope,"
+            "time_stopwatch,time_stopwatch_slope\n";
+
+  // updates class if necessary
+  if ((IsUpdated() == false) && (Update() == false)) {
+    return;
+  }
+
+  // writes a row for each sample
+  // the values are in the same order as the value type
+  for (int i = 0; i < num_samples_; i++) {
+    stream << helper::DoubleToFormattedString(Temperature(i), 6);
+
+    for (int k = 0; k < kNumValues; k++) {
+      const int index_value = (i * kNumValues) + k;
+      const double& value = values_[index_value];
+      const double& slope = slopes_[index_value];
+
+      stream << ",";
+      if (value != -999999) {
+        stream << helper::DoubleToFormattedString(value, 6);
+      }
+
+      stream << ",";
+      if (slope != -999999) {
+        stream << helper::DoubleToFormattedString(slope, 6);
+      }
+    }
+
+    stream << "\n";
+  }
+}
+
+int SpanLookupTable::num_samples() const {
+  return num_samples_;
+}
+
+void SpanLookupTable::set_num_samples(const int& num_samples) {
+  num_samples_ = num_samples;
+  is_updated_table_ = false;
+}
+
+void SpanLookupTable::set_span(const SagSpan* span) {
+  span_ = span;
+
+  // updates sagger
+  if (span_ == nullptr) {
+    sagger_.set_cable(nullptr);
+    sagger_.set_method(nullptr);
+    sagger_.set_structure_ahead(nullptr);
+    sagger_.set_structure_back(nullptr);
+  } else {
+    sagger_.set_cable(&span_->cable);
+    sagger_.set_method(&span_->method);
+    sagger_.set_structure_ahead(&span_->structure_ahead);
+    sagger_.set_structure_back(&span_->structure_back);
+  }
+
+  is_updated_table_ = false;
+}
+
+void SpanLookupTable::set_units(const units::UnitSystem& units) {
+  units_ = units;
+  sagger_.set_units(units_);
+  is_updated_table_ = false;
+}
+
+const SagSpan* SpanLookupTable::span() const {
+  return span_;
+}
+
+units::UnitSystem SpanLookupTable::units() const {
+  return units_;
+}
+
+bool SpanLookupTable::IsUpdated() const {
+  return is_updated_table_ == true;
+}
+
+double SpanLookupTable::Temperature(const int& index) const {
+  // the last sample is set exactly to avoid rounding past the range
+  if (index == num_samples_ - 1) {
+    return temperature_max_;
+  } else {
+    return temperature_min_ + (index * spacing_temperature_);
+  }
+}
+
+bool SpanLookupTable::Update() const {
+  // updates the table
+  is_updated_table_ = UpdateTable();
+  if (is_updated_table_ == false) {
+    return false;
+  }
+
+  // if it reaches this point, update was successful
+  return true;
+}
+
+bool SpanLookupTable::UpdateTable() const {
+  slopes_.clear();
+  values_.clear();
+
+  if ((span_ == nullptr) || (units_ == units::UnitSystem::kNull)
+      || (num_samples_ < 2)) {
+    return false;
+  }
+
+  // gets the target temperature range of the solver
+  if ((SpanCatenarySolver::TemperatureRange(span_->cable, temperature_min_,
+                                            temperature_max_) == false)
+      || (temperature_max_ <= temperature_min_)) {
+    return false;
+  }
+
+  spacing_temperature_ =
+      (temperature_max_ - temperature_min_) / (num_samples_ - 1);
+
+  // solves the span at each sample temperature
+  bool is_solved = false;
+  slopes_.assign(num_samples_ * kNumValues, -999999);
+  values_.assign(num_samples_ * kNumValues, -999999);
+  for (int i = 0; i < num_samples_; i++) {
+    temperature_ = Temperature(i);
+    sagger_.set_temperature(&temperature_);
+
+    const SpanSaggerResult result = sagger_.Result();
+    if (result.status != SpanSaggerResult::StatusType::kSuccess) {
+      continue;
+    }
+
+    is_solved = true;
+
+    // copies the values and slopes in the value type order
+    // values that do not apply to the method are already invalid
+    const SpanSaggerSensitivity& sensitivity = result.sensitivity_temperature;
+    double* values = &values_[i * kNumValues];
+    double* slopes = &slopes_[i * kNumValues];
+
+    values[static_cast<int>(ValueType::kAngleTransit)] = result.angle_transit;
+    slopes[static_cast<int>(ValueType::kAngleTransit)] =
+        sensitivity.angle_transit;
+
+    values[static_cast<int>(ValueType::kSag)] = result.sag;
+    slopes[static_cast<int>(ValueType::kSag)] = sensitivity.sag;
+
+    values[static_cast<int>(ValueType::kTensionDyno)] = result.tension_dyno;
+    slopes[static_cast<int>(ValueType::kTensionDyno)] =
+        sensitivity.tension_dyno;
+
+    values[static_cast<int>(ValueType::kTensionHorizontal)] =
+        result.catenary.tension_horizontal();
+    slopes[static_cast<int>(ValueType::kTensionHorizontal)] =
+        sensitivity.tension_horizontal;
+
+    values[static_cast<int>(ValueType::kTimeStopwatch)] =
+        result.time_stopwatch;
+    slopes[static_cast<int>(ValueType::kTimeStopwatch)] =
+        sensitivity.time_stopwatch;
+  }
+
+  return is_solved;
+}
@@ -0,0 +1,531 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#include "onsag/span_monte_carlo.h"
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+#include "onsag/thread_pool.h"
+
+SpanUncertainty::SpanUncertainty() {
+  deviation_coordinates = 0;
+  deviation_creep = 0;
+  deviation_scale = 0;
+  deviation_tension = 0;
+  deviation_weight = 0;
+}
+
+bool SpanUncertainty::Validate(const bool& /**is_included_warnings**/,
+                               std::list<ErrorMessage>* messages) const {
+  // initializes
+  bool is_valid = true;
+  ErrorMessage message;
+  message.title = "SPAN UNCERTAINTY";
+
+  // validates deviation-coordinates
+  if (deviation_coordinates < 0) {
+    is_valid = false;
+    if (messages != nullptr) {
+      message.description = "Invalid coordinate deviation";
+      messages->push_back(message);
+    }
+  }
+
+  // validates deviation-creep
+  if (deviation_creep < 0) {
+    is_valid = false;
+    if (messages != nullptr) {
+      message.description = "Invalid creep correction deviation";
+      messages->push_back(message);
+    }
+  }
+
+  // validates deviation-scale
+  if (deviation_scale < 0) {
+    is_valid = false;
+    if (messages != nullptr) {
+      message.description = "Invalid scale deviation";
+      messages->push_back(message);
+    }
+  }
+
+  // validates deviation-tension
+  if ((deviation_tension < 0) || (1 <= deviation_tension)) {
+    is_valid = false;
+    if (messages != nullptr) {
+      message.description = "Invalid tension deviation. It must be a "
+                            "fraction less than one";
+      messages->push_back(message);
+    }
+  }
+
+  // validates deviation-weight
+  if ((deviation_weight < 0) || (1 <= deviation_weight)) {
+    is_valid = false;
+    if (messages != nullptr) {
+      message.description = "Invalid unit weight deviation. It must be a "
+                            "fraction less than one";
+      messages->push_back(message);
+    }
+  }
+
+  return is_valid;
+}
+
+SampleDistribution::SampleDistribution() {
+  deviation = -999999;
+  max = -999999;
+  mean = -999999;
+  min = -999999;
+  num_above = 0;
+  num_below = 0;
+  num_samples = 0;
+  value_begin = -999999;
+  width_bin = -999999;
+}
+
+SpanMonteCarloResult::SpanMonteCarloResult() {
+  num_failures = 0;
+  temperature = -999999;
+}
+
+const int SpanMonteCarlo::kNumSamplesBlock = 256;
+const int SpanMonteCarlo::kNumValues = 3;
+
+SpanMonteCarlo::SpanMonteCarlo() {
+  num_bins_ = 50;
+  num_samples_ = 10000;
+  seed_ = 0;
+  span_ = nullptr;
+  units_ = units::UnitSystem::kNull;
+}
+
+SpanMonteCarlo::~SpanMonteCarlo() {
+}
+
+bool SpanMonteCarlo::Run(const int& num_threads) {
+  // initializes
+  blocks_.clear();
+  results_.clear();
+  values_begin_.clear();
+  widths_bin_.clear();
+
+  if (Validate(false, nullptr) == false) {
+    return false;
+  }
+
+  temperatures_ = SpanAnalyzer::Temperatures(*span_, sweep_);
+  if (temperatures_.empty() == true) {
+    return false;
+  }
+
+  const int kNumBlocks = (num_samples_ + kNumSamplesBlock - 1)
+                         / kNumSamplesBlock;
+  blocks_.resize(kNumBlocks);
+
+  // solves the first block without histograms to set the bins
+  RunBlock(0);
+  UpdateBins();
+
+  // determines the number of threads to use
+  int num_threads_used = num_threads;
+  if (num_threads_used < 1) {
+    num_threads_used = std::thread::hardware_concurrency();
+  }
+  num_threads_used = std::max(1, std::min(num_threads_used, kNumBlocks));
+
+  // solves every block as a separate task
+  // the first block is solved again, now that the bins are set
+  ThreadPool pool(num_threads_used);
+  for (int index = 0; index < kNumBlocks; index++) {
+    pool.AddTask([this, index](const int& /**index_worker**/) {
+      RunBlock(index);
+    });
+  }
+  pool.Wait();
+
+  // merges the blocks in order
+  const int kSizeTemperatures = temperatures_.size();
+  Block total = blocks_.front();
+  for (int index = 1; index < kNumBlocks; index++) {
+    const Block& block = blocks_[index];
+    for (int i = 0; i < kSizeTemperatures * kNumValues; i++) {
+      Merge(block.accumulators[i], total.accumulators[i]);
+    }
+    for (int i = 0; i < kSizeTemperatures; i++) {
+      total.num_failures[i] += block.num_failures[i];
+    }
+  }
+
+  // converts the accumulators to distributions
+  results_.resize(kSizeTemperatures);
+  for (int i = 0; i < kSizeTemperatures; i++) {
+    SpanMonteCarloResult& result = results_[i];
+    result.num_failures = total.num_failures[i];
+    result.temperature = temperatures_[i];
+
+    SampleDistribution* distributions[] = {
+        &result.sag, &result.angle_transit, &result.time_stopwatch};
+    for (int k = 0; k < kNumValues; k++) {
+      const int index = (i * kNumValues) + k;
+      const Accumulator& accumulator = total.accumulators[index];
+      if (accumulator.num_samples == 0) {
+        continue;
+      }
+
+      SampleDistribution& distribution = *distributions[k];
+      distribution.counts = accumulator.counts;
+      distribution.deviation = 0;
+      if (1 < accumulator.num_samples) {
+        distribution.deviation =
+            std::sqrt(accumulator.m2 / (accumulator.num_samples - 1));
+      }
+      distribution.max = accumulator.max;
+      distribution.mean = accumulator.mean;
+      distribution.min = accumulator.min;
+      distribution.num_above = accumulator.num_above;
+      distribution.num_below = accumulator.num_below;
+      distribution.num_samples = accumulator.num_samples;
+      distribution.value_begin = values_begin_[index];
+      distribution.width_bin = widths_bin_[index];
+    }
+  }
+
+  blocks_.clear();
+  return true;
+}
+
+bool SpanMonteCarlo::Validate(const bool& is_included_warnings,
+                              std::list<ErrorMessage>* messages) const {
+  // initializes
+  bool is_valid = true;
+  ErrorMessage message;
+  message.title = "SPAN MONTE CARLO";
+
+  // validates num-bins
+  if (num_bins_ < 1) {
+    is_valid = false;
+    if (messages != nullptr) {
+      message.description = "Invalid number of histogram bins";
+      messages->push_back(message);
+    }
+  }
+
+  // validates num-samples
+  if (num_samples_ < 1) {
+    is_valid = false;
+    if (messages != nullptr) {
+      message.description = "Invalid number of samples";
+      messages->push_back(message);
+    }
+  }
+
+  // validates span
+  if (span_ == nullptr) {
+    is_valid = false;
+    if (messages != nullptr) {
+      message.description = "Invalid span";
+      messages->push_back(message);
+    }
+  } else if (span_->Validate(is_included_warnings, messages) == false) {
+    is_valid = false;
+  }
+
+  // validates sweep, including the number of temperatures for the span
+  if (sweep_.Validate(is_included_warnings, messages) == false) {
+    is_valid = false;
+  } else if ((span_ != nullptr)
+             && (SpanAnalyzer::Temperatures(*span_, sweep_, messages).empty()
+                 == true)) {
+    is_valid = false;
+  }
+
+  // validates uncertainty
+  if (uncertainty_.Validate(is_included_warnings, messages) == false) {
+    is_valid = false;
+  }
+
+  // validates units
+  if (units_ == units::UnitSystem::kNull) {
+    is_valid = false;
+    if (messages != nullptr) {
+      message.description = "Invalid unit system";
+      messages->push_back(message);
+    }
+  }
+
+  return is_valid;
+}
+
+int SpanMonteCarlo::num_bins() const {
+  return num_bins_;
+}
+
+int SpanMonteCarlo::num_samples() const {
+  return num_samples_;
+}
+
+const std::vector<SpanMonteCarloResult>& SpanMonteCarlo::results() const {
+  return results_;
+}
+
+uint64_t SpanMonteCarlo::seed() const {
+  return seed_;
+}
+
+void SpanMonteCarlo::set_num_bins(const int& num_bins) {
+  num_bins_ = num_bins;
+}
+
+void SpanMonteCarlo::set_num_samples(const int& num_samples) {
+  num_samples_ = num_samples;
+}
+
+void SpanMonteCarlo::set_seed(const uint64_t& seed) {
+  seed_ = seed;
+}
+
+void SpanMonteCarlo::set_span(const SagSpan* span) {
+  span_ = span;
+}
+
+void SpanMonteCarlo::set_sweep(const TemperatureSweep& sweep) {
+  sweep_ = sweep;
+}
+
+void SpanMonteCarlo::set_uncertainty(const SpanUncertainty& uncertainty) {
+  uncertainty_ = uncertainty;
+}
+
+void SpanMonteCarlo::set_units(const units::UnitSystem& units) {
+  units_ = units;
+}
+
+const SagSpan* SpanMonteCarlo::span() const {
+  return span_;
+}
+
+const TemperatureSweep& SpanMonteCarlo::sweep() const {
+  return sweep_;
+}
+
+const SpanUncertainty& SpanMonteCarlo::uncertainty() const {
+  return uncertainty_;
+}
+
+units::UnitSystem SpanMonteCarlo::units() const {
+  return units_;
+}
+
+void SpanMonteCarlo::Accumulate(const double& value,
+                                const double& value_begin,
+                                const double& width_bin,
+                                Accumulator& accumulator) {
+  // updates the running moments
+  accumulator.num_samples++;
+  const double delta = value - accumulator.mean;
+  accumulator.mean += delta / accumulator.num_samples;
+  accumulator.m2 += delta * (value - accumulator.mean);
+
+  if (accumulator.num_samples == 1) {
+    accumulator.max = value;
+    accumulator.min = value;
+  } else {
+    accumulator.max = std::max(accumulator.max, value);
+    accumulator.min = std::min(accumulator.min, value);
+  }
+
+  // updates the histogram, if the bins are set
+  if (accumulator.counts.empty() == true) {
+    return;
+  }
+
+  const double position = (value - value_begin) / width_bin;
+  if (position < 0) {
+    accumulator.num_below++;
+  } else if (accumulator.counts.size() <= position) {
+    accumulator.num_above++;
+  } else {
+    accumulator.counts[static_cast<int>(position)]++;
+  }
+}
+
+void SpanMonteCarlo::Merge(const Accumulator& source, Accumulator& target) {
+  if (source.num_samples == 0) {
+    return;
+  }
+
+  // combines the moments of the two sample sets
+  if (target.num_samples == 0) {
+    target.m2 = source.m2;
+    target.max = source.max;
+    target.mean = source.mean;
+    target.min = source.min;
+  } else {
+    const double num_samples = target.num_samples + source.num_samples;
+    const double delta = source.mean - target.mean;
+    target.m2 += source.m2 + (delta * delta * target.num_samples
+                              * source.num_samples / num_samples);
+    target.max = std::max(target.max, source.max);
+    target.mean += delta * source.num_samples / num_samples;
+    target.min = std::min(target.min, source.min);
+  }
+  target.num_samples += source.num_samples;
+
+  // combines the histograms
+  target.num_above += source.num_above;
+  target.num_below += source.num_below;
+  const int kSizeCounts = std::min(source.counts.size(),
+                                   target.counts.size());
+  for (int i = 0; i < kSizeCounts; i++) {
+    target.counts[i] += source.counts[i];
+  }
+}
+
+void SpanMonteCarlo::SampleSpan(const SagSpan& span,
+                                const SpanUncertainty& uncertainty,
+                                std::mt19937_64& generator, SagSpan& sample) {
+  std::normal_distribution<double> normal(0, 1);
+
+  // samples the cable
+  const SagCable& cable = span.cable;
+  SagCable& cable_sample = sample.cable;
+  cable_sample.correction_creep = cable.correction_creep
+      + (uncertainty.deviation_creep * normal(generator));
+  cable_sample.scale = cable.scale
+      + (uncertainty.deviation_scale * normal(generator));
+  cable_sample.weight_unit = cable.weight_unit
+      * (1 + (uncertainty.deviation_weight * normal(generator)));
+
+  auto it = cable_sample.tensions.begin();
+  for (auto iter = cable.tensions.cbegin(); iter != cable.tensions.cend();
+       iter++, it++) {
+    it->tension_horizontal = iter->tension_horizontal
+        * (1 + (uncertainty.deviation_tension * normal(generator)));
+  }
+
+  // samples the structure attachments
+  const double& deviation = uncertainty.deviation_coordinates;
+  sample.structure_ahead.point_attachment.x =
+      span.structure_ahead.point_attachment.x + (deviation * normal(generator));
+  sample.structure_ahead.point_attachment.y =
+      span.structure_ahead.point_attachment.y + (deviation * normal(generator));
+  sample.structure_back.point_attachment.x =
+      span.structure_back.point_attachment.x + (deviation * normal(generator));
+  sample.structure_back.point_attachment.y =
+      span.structure_back.point_attachment.y + (deviation * normal(generator));
+}
+
+void SpanMonteCarlo::RunBlock(const int& index_block) {
+  const int kSizeTemperatures = temperatures_.size();
+  const bool is_binned = widths_bin_.empty() == false;
+
+  // initializes the block accumulators
+  Block& block = blocks_[index_block];
+  Accumulator accumulator;
+  accumulator.m2 = 0;
+  accumulator.max = -999999;
+  accumulator.mean = 0;
+  accumulator.min = -999999;
+  accumulator.num_above = 0;
+  accumulator.num_below = 0;
+  accumulator.num_samples = 0;
+  if (is_binned == true) {
+    accumulator.counts.assign(num_bins_, 0);
+  }
+  block.accumulators.assign(kSizeTemperatures * kNumValues, accumulator);
+  block.num_failures.assign(kSizeTemperatures, 0);
+
+  // seeds the block stream from the analysis seed and the block index
+  std::seed_seq sequence{static_cast<uint32_t>(seed_),
+                         static_cast<uint32_t>(seed_ >> 32),
+                         static_cast<uint32_t>(index_block)};
+  std::mt19937_64 generator(sequence);
+
+  // the sample span is copied once, and only the sampled values are
+  // overwritten for each sample
+  SagSpan sample = *span_;
+  double temperature = -999999;
+
+  SpanSagger sagger;
+  sagger.set_is_warm_started(true);
+  sagger.set_method(&sample.method);
+  sagger.set_structure_ahead(&sample.structure_ahead);
+  sagger.set_structure_back(&sample.structure_back);
+  sagger.set_temperature(&temperature);
+  sagger.set_units(units_);
+
+  const int index_begin = index_block * kNumSamplesBlock;
+  const int index_end = std::min(index_begin + kNumSamplesBlock,
+                                 num_samples_);
+  for (int index = index_begin; index < index_end; index++) {
+    SampleSpan(*span_, uncertainty_, generator, sample);
+
+    // rejects samples with an invalid cable (ex: a scale factor that is not
+    // positive, or tensions that increase with temperature)
+    if (sample.cable.Validate(false, nullptr) == false) {
+      for (int i = 0; i < kSizeTemperatures; i++) {
+        block.num_failures[i]++;
+      }
+      continue;
+    }
+
+    // the inputs are modified in place, so they are set again to refit the
+    // tension curve and invalidate the catenary
+    sagger.set_cable(&sample.cable);
+    sagger.set_structure_ahead(&sample.structure_ahead);
+    sagger.set_structure_back(&sample.structure_back);
+
+    for (int i = 0; i < kSizeTemperatures; i++) {
+      temperature = temperatures_[i];
+      sagger.set_temperature(&temperature);
+
+      const SpanSaggerResult result = sagger.Result();
+      if (result.status != SpanSaggerResult::StatusType::kSuccess) {
+        block.num_failures[i]++;
+        continue;
+      }
+
+      const double values[] = {
+          result.sag, result.angle_transit, result.time_stopwatch};
+      for (int k = 0; k < kNumValues; k++) {
+        if (values[k] == -999999) {
+          continue;
+        }
+
+        const int index_value = (i * kNumValues) + k;
+        if (is_binned == true) {
+          Accumulate(values[k], values_begin_[index_value],
+                     widths_bin_[index_value],
+                     block.accumulators[index_value]);
+        } else {
+          Accumulate(values[k], 0, 0, block.accumulators[index_value]);
+        }
+      }
+    }
+  }
+}
+
+void SpanMonteCarlo::UpdateBins() {
+  const int kSizeValues = temperatures_.size() * kNumValues;
+  values_begin_.assign(kSizeValues, 0);
+  widths_bin_.assign(kSizeValues, 1);
+
+  const Block& block = blocks_.front();
+  for (int index = 0; index < kSizeValues; index++) {
+    const Accumulator& accumulator = block.accumulators[index];
+    if (accumulator.num_samples == 0) {
+      continue;
+    }
+
+    // widens the sampled range by half on each side, and keeps a minimum
+    // range in case the inputs are not uncertain
+    double range = accumulator.max - accumulator.min;
+    range = std::max(range, 1e-6 * std::max(1.0, std::abs(accumulator.mean)));
+
+    values_begin_[index] = accumulator.min - (range / 2);
+    widths_bin_[index] = (2 * range) / num_bins_;
+  }
+}
@@ -5,38 +5,96 @@
 
 #include <cmath>
 
-#include "models/base/helper.h"
-#include "models/base/polynomial.h"
-#include "models/transmissionline/catenary_solver.h"
+#include "onsag/span_sagger_t.h"
+
+int SpanSaggerInputTable::Size() const {
+  const int kSizeCables = cables.size();
+  const int kSizeMethods = methods.size();
+  const int kSizeStructuresAhead = structures_ahead.size();
+  const int kSizeStructuresBack = structures_back.size();
+
+  if ((kSizeCables != kSizeMethods)
+      || (kSizeCables != kSizeStructuresAhead)
+      || (kSizeCables != kSizeStructuresBack)) {
+    return -1;
+  }
+
+  return kSizeCables;
+}
+
+int SpanSaggerResultTable::Index(const int& index_span,
+                                 const int& index_temperature) const {
+  return (index_span * num_temperatures) + index_temperature;
+}
+
+void SpanSaggerResultTable::Resize(const int& num_spans,
+                                   const int& num_temperatures) {
+  this->num_spans = num_spans;
+  this->num_temperatures = num_temperatures;
+  num_solves_parabola = 0;
+  num_solves_parabola_fallback = 0;
+
+  // assigns every column so any stale values are cleared
+  const int kSize = num_spans * num_temperatures;
+  angles_transit.assign(kSize, -999999);
+  distances_target.assign(kSize, -999999);
+  factors_control.assign(kSize, -999999);
+  is_solved.assign(kSize, false);
+  iterations_correction.assign(kSize, -999999);
+  lengths.assign(kSize, -999999);
+  sags.assign(kSize, -999999);
+  sensitivities_creep.assign(kSize, SpanSaggerSensitivity());
+  sensitivities_temperature.assign(kSize, SpanSaggerSensitivity());
+  sensitivities_weight.assign(kSize, SpanSaggerSensitivity());
+  speeds_wave.assign(kSize, -999999);
+  tensions_dyno.assign(kSize, -999999);
+  tensions_dyno_ahead.assign(kSize, -999999);
+  tensions_dyno_back.assign(kSize, -999999);
+  tensions_horizontal.assign(kSize, -999999);
+  times_return.assign(kSize * SpanSaggerResult::kNumWavesReturn, -999999);
+  times_stopwatch.assign(kSize, -999999);
+}
+
+constexpr double SpanSagger::kFactorsControlMin[];
+constexpr int SpanSagger::kNumFactorsControlMin;
+constexpr double SpanSagger::kSpacingFactorElevation;
+
+SpanSaggerSensitivity::SpanSaggerSensitivity() {
+  angle_transit = -999999;
+  sag = -999999;
+  tension_dyno = -999999;
+  tension_horizontal = -999999;
+  time_stopwatch = -999999;
+}
+
+const int SpanSaggerResult::kNumWavesReturn = 10;
+
+SpanSaggerResult::SpanSaggerResult() {
+  angle_transit = -999999;
+  direction_transit = AxisDirectionType::kNull;
+  distance_target = -999999;
+  factor_control = -999999;
+  iterations_correction = -999999;
+  length = -999999;
+  point_target = Point2d<double>();
+  sag = -999999;
+  speed_wave = -999999;
+  status = StatusType::kNull;
+  tension_dyno = -999999;
+  tension_dyno_ahead = -999999;
+  tension_dyno_back = -999999;
+  time_stopwatch = -999999;
+  type_method = SagMethod::Type::kNull;
+}
 
 SpanSagger::SpanSagger() {
-  cable_ = nullptr;
+  is_sensitivity_solved_ = false;
   method_ = nullptr;
-  structure_ahead_ = nullptr;
-  structure_back_ = nullptr;
-  temperature_ = nullptr;
   units_ = units::UnitSystem::kNull;
 
-  is_updated_catenary_ = false;
   is_updated_sagger_ = false;
 
-  points_control_min_.resize(16, Point2d<double>());
-  points_control_min_[0] = Point2d<double>(0.00, 0.750);
-  points_control_min_[1] = Point2d<double>(0.05, 0.750);
-  points_control_min_[2] = Point2d<double>(0.10, 0.850);
-  points_control_min_[3] = Point2d<double>(0.15, 0.910);
-  points_control_min_[4] = Point2d<double>(0.20, 0.940);
-  points_control_min_[5] = Point2d<double>(0.25, 0.960);
-  points_control_min_[6] = Point2d<double>(0.30, 0.970);
-  points_control_min_[7] = Point2d<double>(0.35, 0.980);
-  points_control_min_[8] = Point2d<double>(0.40, 0.985);
-  points_control_min_[9] = Point2d<double>(0.45, 0.990);
-  points_control_min_[10] = Point2d<double>(0.50, 0.992);
-  points_control_min_[11] = Point2d<double>(0.55, 0.994);
-  points_control_min_[12] = Point2d<double>(0.60, 0.996);
-  points_control_min_[13] = Point2d<double>(0.65, 0.997);
-  points_control_min_[14] = Point2d<double>(0.70, 0.998);
-  points_control_min_[15] = Point2d<double>(0.75, 0.999);
+  num_solves_catenary_avoided_ = 0;
 }
 
 SpanSagger::~SpanSagger() {
@@ -48,12 +106,7 @@ double SpanSagger::AngleTransit() const {
     return -999999;
   }
 
-  // returns valid answer if method type is correct
-  if (method_->type == SagMethod::Type::kTransit) {
-    return sagger_transit_.AngleLow();
-  } else {
-    return -999999;
-  }
+  return result_.angle_transit;
 }
 
 Catenary3d SpanSagger::Catenary() const {
@@ -62,7 +115,7 @@ Catenary3d SpanSagger::Catenary() const {
     return Catenary3d();
   }
 
-  return catenary_;
+  return result_.catenary;
 }
 
 AxisDirectionType SpanSagger::DirectionTransit() const {
@@ -71,18 +124,7 @@ AxisDirectionType SpanSagger::DirectionTransit() const {
     return AxisDirectionType::kNull;
   }
 
-  // returns valid answer if method type is correct
-  if (method_->type == SagMethod::Type::kTransit) {
-    if (method_->point_transit.x < point_target_.x) {
-      return AxisDirectionType::kPositive;
-    } else if (point_target_.x < method_->point_transit.x) {
-      return AxisDirectionType::kNegative;
-    } else {
-      return AxisDirectionType::kNull;
-    }
-  } else {
-    return AxisDirectionType::kNull;
-  }
+  return result_.direction_transit;
 }
 
 double SpanSagger::DistanceAttachmentToTarget() const {
@@ -91,35 +133,59 @@ double SpanSagger::DistanceAttachmentToTarget() const {
     return -999999;
   }
 
-  // returns valid answer if method type is correct
-  if (method_->type == SagMethod::Type::kTransit) {
-    // gets the direction
-    AxisDirectionType direction = DirectionTransit();
+  return result_.distance_target;
+}
 
-    if (direction == AxisDirectionType::kNegative) {
-      return structure_back_->point_attachment.y - point_target_.y;
-    } else if (direction == AxisDirectionType::kPositive) {
-      return structure_ahead_->point_attachment.y - point_target_.y;
-    } else {
-      return -999999;
-    }
-  } else {
+double SpanSagger::FactorControl() const {
+  // updates class if necessary
+  if ((IsUpdated() == false) && (Update() == false)) {
     return -999999;
   }
+
+  return result_.factor_control;
 }
 
-double SpanSagger::FactorControl() const {
+double SpanSagger::FactorControlMin(const double& factor_elevation) {
+  // gets the table segment directly from the uniform spacing
+  // the comparison is arranged so an undefined factor is also rejected
+  const double position = std::abs(factor_elevation) / kSpacingFactorElevation;
+  if ((position < (kNumFactorsControlMin - 1)) == false) {
+    return -999999;
+  }
+
+  const int index = static_cast<int>(position);
+  const double fraction = position - index;
+
+  // interpolates within the segment
+  const double& factor_start = kFactorsControlMin[index];
+  const double& factor_end = kFactorsControlMin[index + 1];
+  return factor_start + (fraction * (factor_end - factor_start));
+}
+
+void SpanSagger::FactorsControlMin(const int& num_factors,
+                                   const double* factors_elevation,
+                                   double* factors_control_min) {
+  for (int i = 0; i < num_factors; i++) {
+    factors_control_min[i] = FactorControlMin(factors_elevation[i]);
+  }
+}
+
+int SpanSagger::IterationsCorrection() const {
   // updates class if necessary
   if ((IsUpdated() == false) && (Update() == false)) {
     return -999999;
   }
 
-  // returns valid answer if method type is correct
-  if (method_->type == SagMethod::Type::kTransit) {
-    return sagger_transit_.FactorControl();
-  } else {
+  return result_.iterations_correction;
+}
+
+double SpanSagger::Length() const {
+  // updates class if necessary
+  if ((IsUpdated() == false) && (Update() == false)) {
     return -999999;
   }
+
+  return result_.length;
 }
 
 Point2d<double> SpanSagger::PointTarget() const {
@@ -128,26 +194,93 @@ Point2d<double> SpanSagger::PointTarget() const {
     return Point2d<double>();
   }
 
-  // returns valid answer if method type is correct
-  if (method_->type == SagMethod::Type::kTransit) {
-    return point_target_;
-  } else {
-    return Point2d<double>();
+  return result_.point_target;
+}
+
+SpanSaggerResult SpanSagger::Result() const {
+  // checks inputs
+  if ((method_ == nullptr) || (solver_catenary_.cable() == nullptr)
+      || (solver_catenary_.structure_ahead() == nullptr)
+      || (solver_catenary_.structure_back() == nullptr)
+      || (solver_catenary_.temperature() == nullptr)) {
+    SpanSaggerResult result;
+    result.status = SpanSaggerResult::StatusType::kErrorInput;
+    return result;
+  }
+
+  // updates class if necessary
+  if ((IsUpdated() == false) && (Update() == false)) {
+    SpanSaggerResult result;
+    result.type_method = method_->type;
+    if (solver_catenary_.IsUpdated() == false) {
+      result.status = SpanSaggerResult::StatusType::kErrorCatenary;
+    } else {
+      result.status = SpanSaggerResult::StatusType::kErrorSagger;
+    }
+    return result;
   }
+
+  return result_;
 }
 
-double SpanSagger::SpeedWave() const {
+double SpanSagger::Sag() const {
   // updates class if necessary
   if ((IsUpdated() == false) && (Update() == false)) {
     return -999999;
   }
 
-  // returns valid answer if method type is correct
-  if (method_->type == SagMethod::Type::kStopWatch) {
-    return sagger_stopwatch_.VelocityWave();
-  } else {
+  return result_.sag;
+}
+
+int SpanSagger::SagTable(const SpanSaggerInputTable& spans,
+                         const std::vector<double>& temperatures,
+                         const units::UnitSystem& units,
+                         const bool& is_sensitivity_solved,
+                         const double& tolerance_parabola,
+                         SpanSaggerResultTable& results) {
+  // checks input table
+  const int kSizeSpans = spans.Size();
+  if (kSizeSpans < 0) {
+    results.Resize(0, 0);
+    return -1;
+  }
+
+  const int kSizeTemperatures = temperatures.size();
+  results.Resize(kSizeSpans, kSizeTemperatures);
+
+  // solves each span with a sagger that is specialized for the span method
+  int num_errors = 0;
+  for (int i = 0; i < kSizeSpans; i++) {
+    const SagMethod* method = spans.methods[i];
+    if (method == nullptr) {
+      num_errors += kSizeTemperatures;
+    } else if (method->type == SagMethod::Type::kDynamometer) {
+      num_errors += SagTableSpan<SaggerDynamometer>(
+          spans, i, temperatures, units, is_sensitivity_solved,
+          tolerance_parabola, results);
+    } else if (method->type == SagMethod::Type::kStopWatch) {
+      num_errors += SagTableSpan<SaggerStopWatch>(
+          spans, i, temperatures, units, is_sensitivity_solved,
+          tolerance_parabola, results);
+    } else if (method->type == SagMethod::Type::kTransit) {
+      num_errors += SagTableSpan<SaggerTransit>(
+          spans, i, temperatures, units, is_sensitivity_solved,
+          tolerance_parabola, results);
+    } else {
+      num_errors += kSizeTemperatures;
+    }
+  }
+
+  return num_errors;
+}
+
+double SpanSagger::SpeedWave() const {
+  // updates class if necessary
+  if ((IsUpdated() == false) && (Update() == false)) {
     return -999999;
   }
+
+  return result_.speed_wave;
 }
 
 double SpanSagger::TensionDyno() const {
@@ -156,26 +289,43 @@ double SpanSagger::TensionDyno() const {
     return -999999;
   }
 
-  // returns valid answer if method type is correct
-  if (method_->type == SagMethod::Type::kDynamometer) {
-    return sagger_dyno_.Tension();
-  } else {
+  return result_.tension_dyno;
+}
+
+double SpanSagger::TensionDynoAhead() const {
+  // updates class if necessary
+  if ((IsUpdated() == false) && (Update() == false)) {
     return -999999;
   }
+
+  return result_.tension_dyno_ahead;
 }
 
-double SpanSagger::TimeStopwatch() const {
+double SpanSagger::TensionDynoBack() const {
   // updates class if necessary
   if ((IsUpdated() == false) && (Update() == false)) {
     return -999999;
   }
 
-  // returns valid answer if method type is correct
-  if (method_->type == SagMethod::Type::kStopWatch) {
-    return sagger_stopwatch_.TimeReturn(method_->wave_return);
-  } else {
+  return result_.tension_dyno_back;
+}
+
+double SpanSagger::TimeStopwatch() const {
+  // updates class if necessary
+  if ((IsUpdated() == false) && (Update() == false)) {
     return -999999;
   }
+
+  return result_.time_stopwatch;
+}
+
+std::vector<double> SpanSagger::TimesReturn() const {
+  // updates class if necessary
+  if ((IsUpdated() == false) && (Update() == false)) {
+    return std::vector<double>();
+  }
+
+  return result_.times_return;
 }
 
 /// This method depends on the most of the data being checked in the
@@ -187,8 +337,12 @@ bool SpanSagger::Validate(const bool& /**is_included_warnings**/,
   ErrorMessage message;
   message.title = "SPAN SAGGER";
 
+  // gets the catenary solver inputs
+  const SagCable* cable = solver_catenary_.cable();
+  const double* temperature = solver_catenary_.temperature();
+
   // checks cable
-  if (cable_ == nullptr) {
+  if (cable == nullptr) {
     is_valid = false;
     if (messages != nullptr) {
       message.description = "Invalid sag cable";
@@ -206,7 +360,7 @@ bool SpanSagger::Validate(const bool& /**is_included_warnings**/,
   }
 
   // checks structure-ahead
-  if (structure_ahead_ == nullptr) {
+  if (solver_catenary_.structure_ahead() == nullptr) {
     is_valid = false;
     if (messages != nullptr) {
       message.description = "Invalid ahead structure";
@@ -215,7 +369,7 @@ bool SpanSagger::Validate(const bool& /**is_included_warnings**/,
   }
 
   // checks structure-back
-  if (method_ == nullptr) {
+  if (solver_catenary_.structure_back() == nullptr) {
     is_valid = false;
     if (messages != nullptr) {
       message.description = "Invalid back structure";
@@ -224,7 +378,7 @@ bool SpanSagger::Validate(const bool& /**is_included_warnings**/,
   }
 
   // checks temperature
-  if (temperature_ == nullptr) {
+  if (temperature == nullptr) {
     is_valid = false;
     if (messages != nullptr) {
       message.description = "Invalid temperature";
@@ -237,15 +391,20 @@ bool SpanSagger::Validate(const bool& /**is_included_warnings**/,
     return false;
   }
 
-  // compares temperature to cable tension points
-  if (*temperature_ < cable_->tensions.front().temperature) {
+  // compares temperature to cable tension points, which are shifted by the
+  // creep correction
+  double temperature_min = -999999;
+  double temperature_max = -999999;
+  SpanCatenarySolver::TemperatureRange(*cable, temperature_min,
+                                       temperature_max);
+  if (*temperature < temperature_min) {
     is_valid = false;
     if (messages != nullptr) {
       message.description = "Target temperature is less than all cable "
                             "temperature-tension points";
       messages->push_back(message);
     }
-  } else if (cable_->tensions.back().temperature < *temperature_) {
+  } else if (temperature_max < *temperature) {
     is_valid = false;
     if (messages != nullptr) {
       message.description = "Target temperature is greater than all cable "
@@ -257,7 +416,7 @@ bool SpanSagger::Validate(const bool& /**is_included_warnings**/,
   // validates update process
   if (Update() == false) {
     is_valid = false;
-    if ((messages != nullptr) && (is_updated_catenary_ == false)) {
+    if ((messages != nullptr) && (solver_catenary_.IsUpdated() == false)) {
       message.description = "Couldn't solve for a catenary.";
       messages->push_back(message);
     } else if ((messages != nullptr) && (is_updated_sagger_ == false)) {
@@ -275,40 +434,74 @@ bool SpanSagger::Validate(const bool& /**is_included_warnings**/,
 }
 
 const SagCable* SpanSagger::cable() const {
-  return cable_;
+  return solver_catenary_.cable();
+}
+
+bool SpanSagger::is_sensitivity_solved() const {
+  return is_sensitivity_solved_;
+}
+
+bool SpanSagger::is_warm_started() const {
+  return solver_catenary_.is_warm_started();
 }
 
 const SagMethod* SpanSagger::method() const {
   return method_;
 }
 
+int SpanSagger::num_solves_catenary() const {
+  return solver_catenary_.num_solves();
+}
+
+int SpanSagger::num_solves_catenary_avoided() const {
+  return num_solves_catenary_avoided_;
+}
+
+int SpanSagger::num_solves_parabola() const {
+  return solver_catenary_.num_solves_parabola();
+}
+
+int SpanSagger::num_solves_parabola_fallback() const {
+  return solver_catenary_.num_solves_parabola_fallback();
+}
+
 void SpanSagger::set_cable(const SagCable* cable) {
-  cable_ = cable;
-  is_updated_catenary_ = false;
+  solver_catenary_.set_cable(cable);
   is_updated_sagger_ = false;
 }
 
+void SpanSagger::set_is_sensitivity_solved(
+    const bool& is_sensitivity_solved) {
+  is_sensitivity_solved_ = is_sensitivity_solved;
+  is_updated_sagger_ = false;
+}
+
+void SpanSagger::set_is_warm_started(const bool& is_warm_started) {
+  solver_catenary_.set_is_warm_started(is_warm_started);
+}
+
 void SpanSagger::set_method(const SagMethod* method) {
   method_ = method;
-  is_updated_catenary_ = false;
   is_updated_sagger_ = false;
 }
 
 void SpanSagger::set_structure_ahead(const SagStructure* structure_ahead) {
-  structure_ahead_ = structure_ahead;
-  is_updated_catenary_ = false;
+  solver_catenary_.set_structure_ahead(structure_ahead);
   is_updated_sagger_ = false;
 }
 
 void SpanSagger::set_structure_back(const SagStructure* structure_back) {
-  structure_back_ = structure_back;
-  is_updated_catenary_ = false;
+  solver_catenary_.set_structure_back(structure_back);
   is_updated_sagger_ = false;
 }
 
 void SpanSagger::set_temperature(const double* temperature) {
-  temperature_ = temperature;
-  is_updated_catenary_ = false;
+  solver_catenary_.set_temperature(temperature);
+  is_updated_sagger_ = false;
+}
+
+void SpanSagger::set_tolerance_parabola(const double& tolerance_parabola) {
+  solver_catenary_.set_tolerance_parabola(tolerance_parabola);
   is_updated_sagger_ = false;
 }
 
@@ -318,15 +511,19 @@ void SpanSagger::set_units(const units::UnitSystem& units) {
 }
 
 const SagStructure* SpanSagger::structure_ahead() const {
-  return structure_ahead_;
+  return solver_catenary_.structure_ahead();
 }
 
 const SagStructure* SpanSagger::structure_back() const {
-  return structure_back_;
+  return solver_catenary_.structure_back();
 }
 
 const double* SpanSagger::temperature() const {
-  return temperature_;
+  return solver_catenary_.temperature();
+}
+
+double SpanSagger::tolerance_parabola() const {
+  return solver_catenary_.tolerance_parabola();
 }
 
 units::UnitSystem SpanSagger::units() const {
@@ -334,287 +531,153 @@ units::UnitSystem SpanSagger::units() const {
 }
 
 bool SpanSagger::IsUpdated() const {
-  return (is_updated_catenary_ == true) && (is_updated_sagger_ == true);
+  return (solver_catenary_.IsUpdated() == true)
+      && (is_updated_sagger_ == true);
 }
 
-bool SpanSagger::IsValidControlFactor(const double& factor_control) const {
-  // calculates the elevation factor (x-axis)
-  const Vector3d& spacing = catenary_.spacing_endpoints();
-  const double kFactorElevation = std::abs(spacing.z() / spacing.x());
-
-  // searches the minimum control points list to find boundary index(es)
-  unsigned int i = 0;
-  while (i < points_control_min_.size()) {
-    const Point2d<double>& point = points_control_min_[i];
-
-    // checks if point exceeds elevation factor
-    if (kFactorElevation < point.x) {
-      break;
-    } else {
-      i++;
+template <class Method>
+int SpanSagger::SagTableSpan(const SpanSaggerInputTable& spans,
+                             const int& index_span,
+                             const std::vector<double>& temperatures,
+                             const units::UnitSystem& units,
+                             const bool& is_sensitivity_solved,
+                             const double& tolerance_parabola,
+                             SpanSaggerResultTable& results) {
+  // sets the span inputs once, which fits the cable tension curve
+  SpanSaggerT<Method> sagger;
+  sagger.set_cable(spans.cables[index_span]);
+  sagger.set_is_sensitivity_solved(is_sensitivity_solved);
+  sagger.set_is_warm_started(true);
+  sagger.set_method(spans.methods[index_span]);
+  sagger.set_structure_ahead(spans.structures_ahead[index_span]);
+  sagger.set_structure_back(spans.structures_back[index_span]);
+  sagger.set_tolerance_parabola(tolerance_parabola);
+  sagger.set_units(units);
+
+  // solves each temperature
+  int num_errors = 0;
+  const int kSizeTemperatures = temperatures.size();
+  for (int j = 0; j < kSizeTemperatures; j++) {
+    sagger.set_temperature(&temperatures[j]);
+    const SpanSaggerResult result = sagger.Result();
+    if (result.status != SpanSaggerResult::StatusType::kSuccess) {
+      num_errors++;
+      continue;
     }
-  }
-
-  // checks index
-  if (i == 0) {
-    return false;
-  } else if (i == points_control_min_.size()) {
-    return false;
-  }
 
-  // assigns boundary points
-  const Point2d<double>& point_start = points_control_min_[i - 1];
-  const Point2d<double>& point_end = points_control_min_[i];
-
-  // uses linear interpolation to determine the minimum control factor
-  Point2d<double> point_min;
-  point_min.x = factor_control;
-  point_min.y = helper::LinearY(point_start.x, point_start.y,
-                                point_end.x, point_end.y, point_min.x);
-
-  // compares and returns
-  return point_min.y <= factor_control;
-}
-
-double SpanSagger::TensionHorizontalPolynomialFitted(
-    const std::list<const SagCable::TensionPoint*>& points,
-    const double& temperature) const {
-  // determines shift to absolute scale
-  double temperature_shift = 0;
-  if (units_ == units::UnitSystem::kImperial) {
-    temperature_shift = units::ConvertTemperature(
-        0,
-        units::TemperatureConversionType::kFahrenheitToRankine);
-  } else if (units_ == units::UnitSystem::kMetric) {
-    temperature_shift = units::ConvertTemperature(
-        0,
-        units::TemperatureConversionType::kCelsiusToKelvin);
-  } else {
-    return -999999;
+    // copies the result into the columns
+    // values that do not apply to the method are already invalid, so every
+    // column is copied without checking the method
+    const int index = results.Index(index_span, j);
+    results.angles_transit[index] = result.angle_transit;
+    results.distances_target[index] = result.distance_target;
+    results.factors_control[index] = result.factor_control;
+    results.is_solved[index] = true;
+    results.iterations_correction[index] = result.iterations_correction;
+    results.lengths[index] = result.length;
+    results.sags[index] = result.sag;
+    results.sensitivities_creep[index] = result.sensitivity_creep;
+    results.sensitivities_temperature[index] = result.sensitivity_temperature;
+    results.sensitivities_weight[index] = result.sensitivity_weight;
+    results.speeds_wave[index] = result.speed_wave;
+    results.tensions_dyno[index] = result.tension_dyno;
+    results.tensions_dyno_ahead[index] = result.tension_dyno_ahead;
+    results.tensions_dyno_back[index] = result.tension_dyno_back;
+    results.tensions_horizontal[index] =
+        result.catenary.tension_horizontal();
+    results.times_stopwatch[index] = result.time_stopwatch;
+
+    const int kSizeTimesReturn = result.times_return.size();
+    for (int k = 0; k < kSizeTimesReturn; k++) {
+      results.times_return[(index * SpanSaggerResult::kNumWavesReturn) + k] =
+          result.times_return[k];
+    }
   }
 
-  // creates a duplicated list of points
-  // converts to x-y coordinates (x=temperature, y=tension)
-  // x coordinates use absolute temperature scale
-  std::vector<Point2d<double>> pts(3);
-  for (auto iter = points.cbegin(); iter != points.cend(); iter++) {
-    const SagCable::TensionPoint* point = *iter;
-
-    Point2d<double> pt;
-    pt.x = point->temperature + temperature_shift;
-    pt.y = point->tension_horizontal;
-
-    const int i = std::distance(points.cbegin(), iter);
-    pts[i] = pt;
-  }
-
-  // converts target temperature to absolute scale
-  const double x_target = temperature + temperature_shift;
-
-  /// \todo this method needs updated to use a better implemented polynomial
-  ///   fitting method. See here:
-  /// https://en.wikipedia.org/wiki/Newton_polynomial
-
-  // calculates constants to simplify expressions
-  const double k1 = (pts[0].y - pts[2].y) / std::pow(pts[0].x, 2);
-  const double k2 = (pts[2].x - pts[0].x) / std::pow(pts[0].x, 2);
-  const double k3 = 1 - (std::pow(pts[2].x, 2) / std::pow(pts[0].x, 2));
-  const double k4 = (std::pow(pts[2].x, 2) - std::pow(pts[1].x, 2)) / pts[1].x;
-  const double k5 = (pts[1].y - pts[2].y) / pts[1].x;
-  const double k6 = 1 - (pts[2].x / pts[1].x);
-
-  // calculate coefficients of parabolic interpolating polynomial
-  std::vector<double> coefficients(3);
-  coefficients[1] = ((k5 * k3) + (k1 * k4)) / ((k6 * k3) - (k2 * k4));
-  coefficients[2] = (k1 + (coefficients[1] * k2)) / k3;
-  coefficients[0] = pts[2].y - (coefficients[2] * std::pow(pts[2].x, 2))
-                    - (coefficients[1] * pts[2].x);
-
-  // creates a polynomial from the coefficients
-  Polynomial polynomial;
-  polynomial.set_coefficients(&coefficients);
-
-  // checks for negative polynomial concavity, which is related to how a
-  // catenary lets off tension as temperature increases
-  Polynomial derivative_1 = polynomial.Derivative();
-  Polynomial derivative_2 = derivative_1.Derivative();
-  const double kConcavity = derivative_2.Y(x_target);
-  if (0 < helper::Round(kConcavity, 4)) {
-    return -999999;
-  }
+  const SpanCatenarySolver& solver = sagger.solver_catenary();
+  results.num_solves_parabola += solver.num_solves_parabola();
+  results.num_solves_parabola_fallback +=
+      solver.num_solves_parabola_fallback();
 
-  // calculates the horizontal tension for the target temp
-  return polynomial.Y(x_target);
+  return num_errors;
 }
 
 bool SpanSagger::Update() const {
-  // updates the catenary
-  is_updated_catenary_ = UpdateCatenary();
-  if (is_updated_catenary_ == false) {
-    return false;
+  // counts the sagger updates that reuse the solved catenary
+  // the catenary does not depend on the method or units, so it is reused if
+  // only the sagger is out of date
+  if ((solver_catenary_.IsUpdated() == true) && (is_updated_sagger_ == false)) {
+    num_solves_catenary_avoided_++;
   }
 
-  // updates sagging result
-  is_updated_sagger_ = UpdateSagger();
-  if (is_updated_sagger_ == false) {
+  // updates the catenary if necessary
+  if (solver_catenary_.Catenary() == nullptr) {
+    is_updated_sagger_ = false;
     return false;
   }
 
-  // if it reaches this point, update was successful
-  return true;
-}
-
-bool SpanSagger::UpdateCatenary() const {
-  // adjusts temperature based on creep correction
-  const double temperature = *temperature_ - cable_->correction_creep;
-
-  // gets min and max temp/tension point
-  const SagCable::TensionPoint& point_min = cable_->tensions.front();
-  const SagCable::TensionPoint& point_max = cable_->tensions.back();
-
-  // determines if the tension point is valid
-  if (temperature < point_min.temperature) {
-    return false;
-  } else if (point_max.temperature < temperature) {
-    return false;
-  }
-
-  // gets polynomial fit points
-  // there are only 5 points total, and 3 are needed for polynomial fit
-  // checks against median point and selects points 0-2 or 2-4
-  std::list <const SagCable::TensionPoint*> points;
-  const SagCable::TensionPoint& point_median =
-      *std::next(cable_->tensions.cbegin(), 2);
-  if (temperature <= point_median.temperature) {
-    points.push_back(&(*std::next(cable_->tensions.cbegin(), 0)));
-    points.push_back(&(*std::next(cable_->tensions.cbegin(), 1)));
-    points.push_back(&(*std::next(cable_->tensions.cbegin(), 2)));
-  } else if (point_median.temperature < temperature) {
-    points.push_back(&(*std::next(cable_->tensions.cbegin(), 2)));
-    points.push_back(&(*std::next(cable_->tensions.cbegin(), 3)));
-    points.push_back(&(*std::next(cable_->tensions.cbegin(), 4)));
-  }
-
-  // interpolates to find the tension
-  double tension_horizontal =
-      TensionHorizontalPolynomialFitted(points, temperature);
-  if (tension_horizontal == -999999) {
-    return false;
-  }
-
-  // applies scaling factor to tension
-  tension_horizontal = tension_horizontal * cable_->scale;
-
-  // solves for the catenary spacing
-  Vector3d spacing;
-  spacing.set_x(structure_ahead_->point_attachment.x
-                - structure_back_->point_attachment.x);
-  spacing.set_y(0);
-  spacing.set_z(structure_ahead_->point_attachment.y
-                - structure_back_->point_attachment.y);
-
-  // solves for unit weight
-  Vector3d weight_unit;
-  weight_unit.set_x(0);
-  weight_unit.set_y(0);
-  weight_unit.set_z(cable_->weight_unit);
-
-  // builds a catenary
-  catenary_.set_direction_transverse(AxisDirectionType::kPositive);
-  catenary_.set_spacing_endpoints(spacing);
-  catenary_.set_tension_horizontal(tension_horizontal);
-  catenary_.set_weight_unit(weight_unit);
-
-  // accounts for sag correction
-  if (cable_->correction_sag != 0) {
-    CatenarySolver solver;
-    solver.set_spacing_endpoints(catenary_.spacing_endpoints());
-    solver.set_type_target(CatenarySolver::TargetType::kSag);
-    solver.set_value_target(catenary_.Sag() + cable_->correction_sag);
-    solver.set_weight_unit(catenary_.weight_unit());
-
-    if (solver.Validate() == true) {
-      catenary_ = solver.Catenary();
-    } else {
+  // updates sagging result
+  if (is_updated_sagger_ == false) {
+    is_updated_sagger_ = UpdateSagger();
+    if (is_updated_sagger_ == false) {
       return false;
     }
   }
 
-  // returns catenary status
-  return catenary_.Validate(false, nullptr);
-}
-
-bool SpanSagger::UpdatePointTarget() const {
-  // shifts coordinates to match external
-  Point3d<double> point_target = sagger_transit_.PointTarget();
-  point_target.x += structure_back_->point_attachment.x;
-  point_target.z += structure_back_->point_attachment.y;
-
-  // converts 3d point to 2d
-  point_target_.x = point_target.x;
-  point_target_.y = point_target.z;
-
+  // if it reaches this point, update was successful
   return true;
 }
 
 bool SpanSagger::UpdateSagger() const {
-  // intializes all saggers and cached data
-  sagger_dyno_ = DynoSagger();
-  sagger_stopwatch_ = StopwatchSagger();
-  sagger_transit_ = TransitSagger();
-  point_target_ = Point2d<double>();
+  // initializes the cached result
+  result_ = SpanSaggerResult();
+  if (method_ == nullptr) {
+    return false;
+  }
 
   // selects the sagger to update based on sagging method
   if (method_->type == SagMethod::Type::kDynamometer) {
-    sagger_dyno_.set_catenary(catenary_);
-
-    if (method_->end == SagMethod::SpanEndType::kAheadOnLine) {
-      sagger_dyno_.set_location(DynoSagger::SpanEndLocation::kAhead);
-    } else if (method_->end == SagMethod::SpanEndType::kBackOnLine) {
-      sagger_dyno_.set_location(DynoSagger::SpanEndLocation::kBack);
-    } else {
-      return false;
-    }
-
-    return sagger_dyno_.Validate(false, nullptr);
-
+    return UpdateSaggerMethod<SaggerDynamometer>();
   } else if (method_->type == SagMethod::Type::kStopWatch) {
-    sagger_stopwatch_.set_catenary(catenary_);
-    sagger_stopwatch_.set_units(units_);
-
-    return sagger_stopwatch_.Validate(false, nullptr);
-
+    return UpdateSaggerMethod<SaggerStopWatch>();
   } else if (method_->type == SagMethod::Type::kTransit) {
-    bool status = false;
-
-    // adjusts the transit point to fit the sagger coordinate system
-    Point3d<double> point;
-    point.x = method_->point_transit.x
-              - structure_back_->point_attachment.x;
-    point.y = 0;
-    point.z = method_->point_transit.y
-              - structure_back_->point_attachment.y;
-
-    // updates the sagger
-    sagger_transit_.set_catenary(catenary_);
-    sagger_transit_.set_point_transit(point);
-
-    status = sagger_transit_.Validate();
-    if (status == false) {
-      return false;
-    }
-
-    // checks the control factor
-    status = IsValidControlFactor(sagger_transit_.FactorControl());
-    if (status == false) {
-      return false;
-    }
+    return UpdateSaggerMethod<SaggerTransit>();
+  } else {
+    return false;
+  }
+}
 
-    // updates target point
-    UpdatePointTarget();
+template <class Method>
+bool SpanSagger::UpdateSaggerMethod() const {
+  const Catenary3d& catenary = *solver_catenary_.Catenary();
+  const SagStructure& structure_ahead = *solver_catenary_.structure_ahead();
+  const SagStructure& structure_back = *solver_catenary_.structure_back();
 
-    return true;
-  } else {
+  // updates the method sagger
+  typename Method::Sagger sagger;
+  if (Method::Update(catenary, *method_, structure_back, units_,
+                     sagger) == false) {
     return false;
   }
+
+  // fills the cached result
+  result_.catenary = catenary;
+  result_.iterations_correction = solver_catenary_.IterationsCorrection();
+  result_.length = solver_catenary_.Length();
+  result_.sag = solver_catenary_.Sag();
+  result_.type_method = Method::kType;
+  Method::Fill(sagger, *method_, structure_ahead, structure_back, result_);
+  result_.status = SpanSaggerResult::StatusType::kSuccess;
+
+  // solves the sensitivities, which are left unsolved if the slopes can't be
+  // calculated
+  result_.sensitivity_creep = SpanSaggerSensitivity();
+  result_.sensitivity_temperature = SpanSaggerSensitivity();
+  result_.sensitivity_weight = SpanSaggerSensitivity();
+  if (is_sensitivity_solved_ == true) {
+    SpanSaggerT<Method>::UpdateSensitivities(solver_catenary_, *method_,
+                                             units_, result_);
+  }
+
+  return true;
 }
@@ -0,0 +1,132 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#include "onsag/span_sagger_t.h"
+
+const SagMethod::Type SaggerDynamometer::kType =
+    SagMethod::Type::kDynamometer;
+
+void SaggerDynamometer::Fill(const Sagger& sagger,
+                             const SagMethod& method,
+                             const SagStructure& /**structure_ahead**/,
+                             const SagStructure& /**structure_back**/,
+                             SpanSaggerResult& result) {
+  // solves the tension at both span ends from the same catenary, so the
+  // results are valid for either end without another solve
+  Sagger sagger_end = sagger;
+  sagger_end.set_location(DynoSagger::SpanEndLocation::kAhead);
+  result.tension_dyno_ahead = sagger_end.Tension();
+  sagger_end.set_location(DynoSagger::SpanEndLocation::kBack);
+  result.tension_dyno_back = sagger_end.Tension();
+
+  if (method.end == SagMethod::SpanEndType::kAheadOnLine) {
+    result.tension_dyno = result.tension_dyno_ahead;
+  } else {
+    result.tension_dyno = result.tension_dyno_back;
+  }
+}
+
+bool SaggerDynamometer::Update(const Catenary3d& catenary,
+                               const SagMethod& method,
+                               const SagStructure& /**structure_back**/,
+                               const units::UnitSystem& /**units**/,
+                               Sagger& sagger) {
+  sagger.set_catenary(catenary);
+
+  if (method.end == SagMethod::SpanEndType::kAheadOnLine) {
+    sagger.set_location(DynoSagger::SpanEndLocation::kAhead);
+  } else if (method.end == SagMethod::SpanEndType::kBackOnLine) {
+    sagger.set_location(DynoSagger::SpanEndLocation::kBack);
+  } else {
+    return false;
+  }
+
+  return sagger.Validate(false, nullptr);
+}
+
+const SagMethod::Type SaggerStopWatch::kType = SagMethod::Type::kStopWatch;
+
+void SaggerStopWatch::Fill(const Sagger& sagger,
+                           const SagMethod& method,
+                           const SagStructure& /**structure_ahead**/,
+                           const SagStructure& /**structure_back**/,
+                           SpanSaggerResult& result) {
+  result.speed_wave = sagger.VelocityWave();
+  result.time_stopwatch = sagger.TimeReturn(method.wave_return);
+
+  // fills the return time table from the first wave, since the return time
+  // is proportional to the number of waves
+  const double time_wave = sagger.TimeReturn(1);
+  result.times_return.resize(SpanSaggerResult::kNumWavesReturn);
+  for (int i = 0; i < SpanSaggerResult::kNumWavesReturn; i++) {
+    result.times_return[i] = time_wave * (i + 1);
+  }
+}
+
+bool SaggerStopWatch::Update(const Catenary3d& catenary,
+                             const SagMethod& /**method**/,
+                             const SagStructure& /**structure_back**/,
+                             const units::UnitSystem& units,
+                             Sagger& sagger) {
+  sagger.set_catenary(catenary);
+  sagger.set_units(units);
+
+  return sagger.Validate(false, nullptr);
+}
+
+const SagMethod::Type SaggerTransit::kType = SagMethod::Type::kTransit;
+
+void SaggerTransit::Fill(const Sagger& sagger,
+                         const SagMethod& method,
+                         const SagStructure& structure_ahead,
+                         const SagStructure& structure_back,
+                         SpanSaggerResult& result) {
+  result.angle_transit = sagger.AngleLow();
+  result.factor_control = sagger.FactorControl();
+
+  // shifts the target point to match external coordinates
+  const Point3d<double> point_target = sagger.PointTarget();
+  result.point_target.x = point_target.x + structure_back.point_attachment.x;
+  result.point_target.y = point_target.z + structure_back.point_attachment.y;
+
+  // determines the direction, and the attachment the transit sights
+  if (method.point_transit.x < result.point_target.x) {
+    result.direction_transit = AxisDirectionType::kPositive;
+    result.distance_target =
+        structure_ahead.point_attachment.y - result.point_target.y;
+  } else if (result.point_target.x < method.point_transit.x) {
+    result.direction_transit = AxisDirectionType::kNegative;
+    result.distance_target =
+        structure_back.point_attachment.y - result.point_target.y;
+  }
+}
+
+bool SaggerTransit::Update(const Catenary3d& catenary,
+                           const SagMethod& method,
+                           const SagStructure& structure_back,
+                           const units::UnitSystem& /**units**/,
+                           Sagger& sagger) {
+  // adjusts the transit point to fit the sagger coordinate system
+  Point3d<double> point;
+  point.x = method.point_transit.x - structure_back.point_attachment.x;
+  point.y = 0;
+  point.z = method.point_transit.y - structure_back.point_attachment.y;
+
+  // updates the sagger
+  sagger.set_catenary(catenary);
+  sagger.set_point_transit(point);
+
+  if (sagger.Validate() == false) {
+    return false;
+  }
+
+  // checks the control factor against the minimum for the elevation factor
+  const Vector3d& spacing = catenary.spacing_endpoints();
+  const double factor_control_min =
+      SpanSagger::FactorControlMin(spacing.z() / spacing.x());
+  if (factor_control_min == -999999) {
+    return false;
+  }
+
+  return factor_control_min <= sagger.FactorControl();
+}
@@ -0,0 +1,235 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#include "onsag/tension_curve.h"
+
+#include <algorithm>
+#include <cmath>
+
+TensionCurve::TensionCurve() {
+  cable_ = nullptr;
+
+  is_updated_segments_ = false;
+}
+
+TensionCurve::~TensionCurve() {
+}
+
+double TensionCurve::SlopeTensionHorizontal(const double& temperature) const {
+  // updates class if necessary
+  if ((IsUpdated() == false) && (Update() == false)) {
+    return -999999;
+  }
+
+  // gets the segment
+  const int index = IndexSegment(temperature);
+  if (index == -1) {
+    return -999999;
+  }
+
+  // evaluates the derivative of the cubic polynomial
+  const double t = temperature - temperatures_[index];
+  const double* c = segments_[index].coefficients;
+  return c[1] + (t * ((2 * c[2]) + (t * 3 * c[3])));
+}
+
+double TensionCurve::TensionHorizontal(const double& temperature) const {
+  // updates class if necessary
+  if ((IsUpdated() == false) && (Update() == false)) {
+    return -999999;
+  }
+
+  // gets the segment
+  const int index = IndexSegment(temperature);
+  if (index == -1) {
+    return -999999;
+  }
+
+  // evaluates the cubic polynomial
+  const double t = temperature - temperatures_[index];
+  const double* c = segments_[index].coefficients;
+  return c[0] + (t * (c[1] + (t * (c[2] + (t * c[3])))));
+}
+
+bool TensionCurve::Validate(const bool& /**is_included_warnings**/,
+                            std::list<ErrorMessage>* messages) const {
+  // initializes
+  bool is_valid = true;
+  ErrorMessage message;
+  message.title = "TENSION CURVE";
+
+  // validates cable
+  if (cable_ == nullptr) {
+    is_valid = false;
+    if (messages != nullptr) {
+      message.description = "Invalid sag cable";
+      messages->push_back(message);
+    }
+
+    return is_valid;
+  }
+
+  // validates tension points
+  if (cable_->tensions.size() < 2) {
+    is_valid = false;
+    if (messages != nullptr) {
+      message.description = "Invalid number of cable tension points";
+      messages->push_back(message);
+    }
+  }
+
+  // returns if errors are present
+  if (is_valid == false) {
+    return false;
+  }
+
+  // validates update process
+  if (Update() == false) {
+    is_valid = false;
+    if (messages != nullptr) {
+      message.description = "Couldn't fit the cable tension points";
+      messages->push_back(message);
+    }
+  }
+
+  return is_valid;
+}
+
+const SagCable* TensionCurve::cable() const {
+  return cable_;
+}
+
+void TensionCurve::set_cable(const SagCable* cable) {
+  cable_ = cable;
+  is_updated_segments_ = false;
+}
+
+int TensionCurve::IndexSegment(const double& temperature) const {
+  // checks bounds
+  if ((temperature < temperatures_.front())
+      || (temperatures_.back() < temperature)) {
+    return -1;
+  }
+
+  // searches the interior tension points for the segment
+  // the upper bound is the end point of the segment
+  auto iter = std::upper_bound(temperatures_.cbegin() + 1,
+                               temperatures_.cend() - 1, temperature);
+  return std::distance(temperatures_.cbegin() + 1, iter);
+}
+
+bool TensionCurve::IsUpdated() const {
+  return is_updated_segments_ == true;
+}
+
+bool TensionCurve::Update() const {
+  // updates the segments
+  is_updated_segments_ = UpdateSegments();
+  if (is_updated_segments_ == false) {
+    return false;
+  }
+
+  // if it reaches this point, update was successful
+  return true;
+}
+
+bool TensionCurve::UpdateSegments() const {
+  segments_.clear();
+  temperatures_.clear();
+
+  if (cable_ == nullptr) {
+    return false;
+  }
+
+  // copies the tension points into contiguous arrays
+  const int kSizePoints = cable_->tensions.size();
+  if (kSizePoints < 2) {
+    return false;
+  }
+
+  std::vector<double> tensions;
+  tensions.reserve(kSizePoints);
+  temperatures_.reserve(kSizePoints);
+  for (auto iter = cable_->tensions.cbegin(); iter != cable_->tensions.cend();
+       iter++) {
+    const SagCable::TensionPoint& point = *iter;
+    temperatures_.push_back(point.temperature);
+    tensions.push_back(point.tension_horizontal);
+  }
+
+  // calculates the segment widths and secant slopes
+  const int kSizeSegments = kSizePoints - 1;
+  std::vector<double> widths(kSizeSegments);
+  std::vector<double> secants(kSizeSegments);
+  for (int i = 0; i < kSizeSegments; i++) {
+    widths[i] = temperatures_[i + 1] - temperatures_[i];
+    if (widths[i] <= 0) {
+      return false;
+    }
+
+    secants[i] = (tensions[i + 1] - tensions[i]) / widths[i];
+  }
+
+  // calculates the slopes at the tension points
+  std::vector<double> slopes(kSizePoints);
+  if (kSizeSegments == 1) {
+    slopes[0] = secants[0];
+    slopes[1] = secants[0];
+  } else {
+    // interior points use a weighted harmonic mean of the secants, and are
+    // flat at a local extreme to prevent overshoot
+    for (int i = 1; i < kSizeSegments; i++) {
+      const double& s0 = secants[i - 1];
+      const double& s1 = secants[i];
+      if ((s0 * s1) <= 0) {
+        slopes[i] = 0;
+      } else {
+        const double w0 = (2 * widths[i]) + widths[i - 1];
+        const double w1 = widths[i] + (2 * widths[i - 1]);
+        slopes[i] = (w0 + w1) / ((w0 / s0) + (w1 / s1));
+      }
+    }
+
+    // end points use a three point estimate, limited to preserve
+    // monotonicity
+    const int n = kSizeSegments;
+    double& slope_begin = slopes[0];
+    slope_begin = (((2 * widths[0]) + widths[1]) * secants[0]
+                   - (widths[0] * secants[1]))
+                  / (widths[0] + widths[1]);
+    if ((slope_begin * secants[0]) <= 0) {
+      slope_begin = 0;
+    } else if (((secants[0] * secants[1]) <= 0)
+               && (std::abs(3 * secants[0]) < std::abs(slope_begin))) {
+      slope_begin = 3 * secants[0];
+    }
+
+    double& slope_end = slopes[n];
+    slope_end = (((2 * widths[n - 1]) + widths[n - 2]) * secants[n - 1]
+                 - (widths[n - 1] * secants[n - 2]))
+                / (widths[n - 1] + widths[n - 2]);
+    if ((slope_end * secants[n - 1]) <= 0) {
+      slope_end = 0;
+    } else if (((secants[n - 1] * secants[n - 2]) <= 0)
+               && (std::abs(3 * secants[n - 1]) < std::abs(slope_end))) {
+      slope_end = 3 * secants[n - 1];
+    }
+  }
+
+  // calculates the cubic hermite coefficients for each segment
+  segments_.resize(kSizeSegments);
+  for (int i = 0; i < kSizeSegments; i++) {
+    const double& h = widths[i];
+    const double& s = secants[i];
+    const double& m0 = slopes[i];
+    const double& m1 = slopes[i + 1];
+
+    double* c = segments_[i].coefficients;
+    c[0] = tensions[i];
+    c[1] = m0;
+    c[2] = ((3 * s) - (2 * m0) - m1) / h;
+    c[3] = (m0 + m1 - (2 * s)) / (h * h);
+  }
+
+  return true;
+}
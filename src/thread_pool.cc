@@ -0,0 +1,160 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#include "onsag/thread_pool.h"
+
+/// The pool that owns the current thread, if it is a worker thread.
+static thread_local const ThreadPool* pool_worker = nullptr;
+
+/// The worker index of the current thread, if it is a worker thread.
+static thread_local int index_worker = -1;
+
+ThreadPool::ThreadPool(const int& num_threads) {
+  index_queue_next_ = 0;
+  is_stopped_ = false;
+  num_tasks_ = 0;
+  num_tasks_queued_ = 0;
+
+  // determines the number of threads to use
+  int num_threads_used = num_threads;
+  if (num_threads_used < 1) {
+    num_threads_used = std::thread::hardware_concurrency();
+  }
+  if (num_threads_used < 1) {
+    num_threads_used = 1;
+  }
+
+  // creates worker queues before any thread can access them
+  for (int i = 0; i < num_threads_used; i++) {
+    queues_.push_back(std::unique_ptr<WorkerQueue>(new WorkerQueue()));
+  }
+
+  // starts worker threads
+  threads_.reserve(num_threads_used);
+  for (int i = 0; i < num_threads_used; i++) {
+    threads_.push_back(std::thread(&ThreadPool::RunWorker, this, i));
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  // signals worker threads to exit once the queues are empty
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    is_stopped_ = true;
+  }
+  condition_tasks_.notify_all();
+
+  // joins worker threads
+  for (auto iter = threads_.begin(); iter != threads_.end(); iter++) {
+    std::thread& thread = *iter;
+    thread.join();
+  }
+}
+
+void ThreadPool::AddTask(const Task& task) {
+  // selects a queue
+  // a worker keeps its own tasks, other threads spread tasks round robin
+  const int kSizeQueues = queues_.size();
+  int index_queue = -1;
+  if (pool_worker == this) {
+    index_queue = index_worker;
+  } else {
+    index_queue = index_queue_next_++ % kSizeQueues;
+  }
+
+  // updates counters before queuing so a worker can never finish the task
+  // before it is counted
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    num_tasks_++;
+    num_tasks_queued_++;
+  }
+
+  // queues task
+  {
+    WorkerQueue& queue = *queues_[index_queue];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    queue.tasks.push_back(task);
+  }
+
+  condition_tasks_.notify_one();
+}
+
+void ThreadPool::Wait() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (num_tasks_ != 0) {
+    condition_done_.wait(lock);
+  }
+}
+
+int ThreadPool::size() const {
+  return threads_.size();
+}
+
+bool ThreadPool::PopTask(const int& index, Task& task) {
+  const int kSizeQueues = queues_.size();
+
+  // takes the most recent task from the worker queue
+  {
+    WorkerQueue& queue = *queues_[index];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tasks.empty() == false) {
+      task = queue.tasks.back();
+      queue.tasks.pop_back();
+      return true;
+    }
+  }
+
+  // steals the oldest task from another worker queue
+  for (int i = 1; i < kSizeQueues; i++) {
+    WorkerQueue& queue = *queues_[(index + i) % kSizeQueues];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tasks.empty() == false) {
+      task = queue.tasks.front();
+      queue.tasks.pop_front();
+      return true;
+    }
+  }
+
+  return false;
+}
+
+void ThreadPool::RunWorker(const int index) {
+  pool_worker = this;
+  index_worker = index;
+
+  while (true) {
+    Task task;
+
+    if (PopTask(index, task) == true) {
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        num_tasks_queued_--;
+      }
+
+      // runs task outside of any lock
+      task(index);
+
+      // updates counter and notifies any waiting threads
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        num_tasks_--;
+        if (num_tasks_ == 0) {
+          condition_done_.notify_all();
+        }
+      }
+
+      continue;
+    }
+
+    // waits for a task to be queued, or for the pool to stop
+    std::unique_lock<std::mutex> lock(mutex_);
+    while ((num_tasks_queued_ == 0) && (is_stopped_ == false)) {
+      condition_tasks_.wait(lock);
+    }
+
+    if ((num_tasks_queued_ == 0) && (is_stopped_ == true)) {
+      return;
+    }
+  }
+}
@@ -0,0 +1,323 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#include "onsag/transit_optimizer.h"
+
+#include <algorithm>
+#include <thread>
+
+#include "models/sagging/transit_sagger.h"
+
+#include "onsag/span_catenary_solver.h"
+#include "onsag/span_sagger.h"
+#include "onsag/thread_pool.h"
+
+TransitCandidate::TransitCandidate() {
+  angle_max = -999999;
+  angle_min = -999999;
+  is_feasible = false;
+  margin_control = -999999;
+}
+
+TransitOptimizer::TransitOptimizer() {
+  num_points_x_ = 11;
+  num_points_y_ = 11;
+  span_ = nullptr;
+
+  factor_control_min_ = -999999;
+  index_best_ = -1;
+}
+
+TransitOptimizer::~TransitOptimizer() {
+}
+
+const TransitCandidate* TransitOptimizer::CandidateBest() const {
+  if (index_best_ == -1) {
+    return nullptr;
+  }
+
+  return &candidates_[index_best_];
+}
+
+bool TransitOptimizer::Optimize(const int& num_threads) {
+  // initializes
+  candidates_.clear();
+  index_best_ = -1;
+
+  if (Validate(false, nullptr) == false) {
+    return false;
+  }
+
+  // solves the catenaries, which are shared by every candidate
+  if (UpdateCatenaries() == false) {
+    return false;
+  }
+
+  // creates the candidates
+  candidates_.resize(num_points_x_ * num_points_y_, TransitCandidate());
+  const double step_x = (num_points_x_ == 1) ? 0
+      : (point_max_.x - point_min_.x) / (num_points_x_ - 1);
+  const double step_y = (num_points_y_ == 1) ? 0
+      : (point_max_.y - point_min_.y) / (num_points_y_ - 1);
+  for (int j = 0; j < num_points_y_; j++) {
+    for (int i = 0; i < num_points_x_; i++) {
+      TransitCandidate& candidate = candidates_[(j * num_points_x_) + i];
+      candidate.point_transit.x = point_min_.x + (i * step_x);
+      candidate.point_transit.y = point_min_.y + (j * step_y);
+    }
+  }
+
+  // determines the number of threads to use
+  int num_threads_used = num_threads;
+  if (num_threads_used < 1) {
+    num_threads_used = std::thread::hardware_concurrency();
+  }
+  num_threads_used = std::max(1, std::min(num_threads_used, num_points_y_));
+
+  // evaluates every row as a separate task
+  ThreadPool pool(num_threads_used);
+  for (int j = 0; j < num_points_y_; j++) {
+    pool.AddTask([this, j](const int& /**index_worker**/) {
+      EvaluateRow(j);
+    });
+  }
+  pool.Wait();
+
+  // selects the feasible candidate with the largest margin
+  const int kSizeCandidates = candidates_.size();
+  for (int index = 0; index < kSizeCandidates; index++) {
+    const TransitCandidate& candidate = candidates_[index];
+    if (candidate.is_feasible == false) {
+      continue;
+    }
+
+    if ((index_best_ == -1)
+        || (candidates_[index_best_].margin_control
+            < candidate.margin_control)) {
+      index_best_ = index;
+    }
+  }
+
+  return true;
+}
+
+bool TransitOptimizer::Validate(const bool& is_included_warnings,
+                                std::list<ErrorMessage>* messages) const {
+  // initializes
+  bool is_valid = true;
+  ErrorMessage message;
+  message.title = "TRANSIT OPTIMIZER";
+
+  // validates num-points-x
+  if (num_points_x_ < 1) {
+    is_valid = false;
+    if (messages != nullptr) {
+      message.description = "Invalid number of horizontal grid points";
+      messages->push_back(message);
+    }
+  }
+
+  // validates num-points-y
+  if (num_points_y_ < 1) {
+    is_valid = false;
+    if (messages != nullptr) {
+      message.description = "Invalid number of vertical grid points";
+      messages->push_back(message);
+    }
+  }
+
+  // validates point-max
+  if ((point_max_.x < point_min_.x) || (point_max_.y < point_min_.y)) {
+    is_valid = false;
+    if (messages != nullptr) {
+      message.description = "Invalid grid region. The maximum point is less "
+                            "than the minimum point";
+      messages->push_back(message);
+    }
+  }
+
+  // validates span
+  if (span_ == nullptr) {
+    is_valid = false;
+    if (messages != nullptr) {
+      message.description = "Invalid span";
+      messages->push_back(message);
+    }
+  } else if (span_->Validate(is_included_warnings, messages) == false) {
+    is_valid = false;
+  } else {
+    // validates the span elevation factor against the control factor table
+    const double spacing_x = span_->structure_ahead.point_attachment.x
+                             - span_->structure_back.point_attachment.x;
+    const double spacing_y = span_->structure_ahead.point_attachment.y
+                             - span_->structure_back.point_attachment.y;
+    if ((spacing_x == 0) || (SpanSagger::FactorControlMin(spacing_y / spacing_x)
+                             == -999999)) {
+      is_valid = false;
+      if (messages != nullptr) {
+        message.description = "Invalid span elevation factor. The minimum "
+                              "control factor is not defined";
+        messages->push_back(message);
+      }
+    }
+  }
+
+  // validates sweep, including the number of temperatures for the span
+  if (sweep_.Validate(is_included_warnings, messages) == false) {
+    is_valid = false;
+  } else if ((span_ != nullptr)
+             && (SpanAnalyzer::Temperatures(*span_, sweep_, messages).empty()
+                 == true)) {
+    is_valid = false;
+  }
+
+  return is_valid;
+}
+
+const std::vector<TransitCandidate>& TransitOptimizer::candidates() const {
+  return candidates_;
+}
+
+int TransitOptimizer::num_points_x() const {
+  return num_points_x_;
+}
+
+int TransitOptimizer::num_points_y() const {
+  return num_points_y_;
+}
+
+const Point2d<double>& TransitOptimizer::point_max() const {
+  return point_max_;
+}
+
+const Point2d<double>& TransitOptimizer::point_min() const {
+  return point_min_;
+}
+
+void TransitOptimizer::set_num_points_x(const int& num_points_x) {
+  num_points_x_ = num_points_x;
+}
+
+void TransitOptimizer::set_num_points_y(const int& num_points_y) {
+  num_points_y_ = num_points_y;
+}
+
+void TransitOptimizer::set_point_max(const Point2d<double>& point_max) {
+  point_max_ = point_max;
+}
+
+void TransitOptimizer::set_point_min(const Point2d<double>& point_min) {
+  point_min_ = point_min;
+}
+
+void TransitOptimizer::set_span(const SagSpan* span) {
+  span_ = span;
+}
+
+void TransitOptimizer::set_sweep(const TemperatureSweep& sweep) {
+  sweep_ = sweep;
+}
+
+const SagSpan* TransitOptimizer::span() const {
+  return span_;
+}
+
+const TemperatureSweep& TransitOptimizer::sweep() const {
+  return sweep_;
+}
+
+void TransitOptimizer::EvaluateRow(const int& index_row) {
+  const SagStructure& structure_back = span_->structure_back;
+
+  const int index_begin = index_row * num_points_x_;
+  const int index_end = index_begin + num_points_x_;
+  for (int index = index_begin; index < index_end; index++) {
+    TransitCandidate& candidate = candidates_[index];
+
+    // adjusts the transit point to fit the sagger coordinate system
+    Point3d<double> point;
+    point.x = candidate.point_transit.x - structure_back.point_attachment.x;
+    point.y = 0;
+    point.z = candidate.point_transit.y - structure_back.point_attachment.y;
+
+    // solves the transit sagger at every temperature
+    bool is_solved = true;
+    for (auto iter = catenaries_.cbegin(); iter != catenaries_.cend();
+         iter++) {
+      const Catenary3d& catenary = *iter;
+
+      TransitSagger sagger;
+      sagger.set_catenary(catenary);
+      sagger.set_point_transit(point);
+      if (sagger.Validate(false, nullptr) == false) {
+        is_solved = false;
+        break;
+      }
+
+      const double angle = sagger.AngleLow();
+      const double margin = sagger.FactorControl() - factor_control_min_;
+      if (iter == catenaries_.cbegin()) {
+        candidate.angle_max = angle;
+        candidate.angle_min = angle;
+        candidate.margin_control = margin;
+      } else {
+        candidate.angle_max = std::max(candidate.angle_max, angle);
+        candidate.angle_min = std::min(candidate.angle_min, angle);
+        candidate.margin_control = std::min(candidate.margin_control, margin);
+      }
+    }
+
+    if (is_solved == false) {
+      candidate.angle_max = -999999;
+      candidate.angle_min = -999999;
+      candidate.margin_control = -999999;
+      continue;
+    }
+
+    candidate.is_feasible = 0 <= candidate.margin_control;
+  }
+}
+
+bool TransitOptimizer::UpdateCatenaries() {
+  catenaries_.clear();
+
+  // gets the minimum allowable control factor, which depends only on the
+  // span geometry
+  const double spacing_x = span_->structure_ahead.point_attachment.x
+                           - span_->structure_back.point_attachment.x;
+  const double spacing_y = span_->structure_ahead.point_attachment.y
+                           - span_->structure_back.point_attachment.y;
+  factor_control_min_ = SpanSagger::FactorControlMin(spacing_y / spacing_x);
+  if (factor_control_min_ == -999999) {
+    return false;
+  }
+
+  // solves the catenary at every temperature, warm starting from the
+  // previous temperature
+  const std::vector<double> temperatures =
+      SpanAnalyzer::Temperatures(*span_, sweep_);
+  if (temperatures.empty() == true) {
+    return false;
+  }
+
+  SpanCatenarySolver solver;
+  solver.set_cable(&span_->cable);
+  solver.set_is_warm_started(true);
+  solver.set_structure_ahead(&span_->structure_ahead);
+  solver.set_structure_back(&span_->structure_back);
+
+  for (auto iter = temperatures.cbegin(); iter != temperatures.cend();
+       iter++) {
+    solver.set_temperature(&(*iter));
+
+    const Catenary3d* catenary = solver.Catenary();
+    if (catenary == nullptr) {
+      catenaries_.clear();
+      return false;
+    }
+
+    catenaries_.push_back(*catenary);
+  }
+
+  return true;
+}
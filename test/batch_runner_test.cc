@@ -0,0 +1,407 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#include "onsag/batch_runner.h"
+
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "models/base/helper.h"
+
+#include "test/factory.h"
+
+namespace {
+
+/// \brief Splits a CSV line into fields.
+/// \param[in] line
+///   The line, which can contain quoted fields.
+/// \return The unquoted fields.
+std::vector<std::string> SplitCsv(const std::string& line) {
+  std::vector<std::string> fields(1);
+  bool is_quoted = false;
+  for (std::size_t i = 0; i < line.size(); i++) {
+    const char& c = line[i];
+    if (is_quoted == true) {
+      if ((c == '"') && (i + 1 < line.size()) && (line[i + 1] == '"')) {
+        fields.back() += '"';
+        i++;
+      } else if (c == '"') {
+        is_quoted = false;
+      } else {
+        fields.back() += c;
+      }
+    } else if (c == '"') {
+      is_quoted = true;
+    } else if (c == ',') {
+      fields.push_back("");
+    } else {
+      fields.back() += c;
+    }
+  }
+
+  return fields;
+}
+
+/// \brief Gets the index of a CSV column.
+/// \param[in] header
+///   The header fields.
+/// \param[in] name
+///   The column name.
+/// \return The column index, or -1 if the column is not found.
+int IndexColumn(const std::vector<std::string>& header,
+                const std::string& name) {
+  for (std::size_t i = 0; i < header.size(); i++) {
+    if (header[i] == name) {
+      return i;
+    }
+  }
+
+  return -1;
+}
+
+/// \brief Splits text into lines.
+/// \param[in] str
+///   The text.
+/// \return The lines, without the line endings.
+std::vector<std::string> SplitLines(const std::string& str) {
+  std::vector<std::string> lines;
+  std::istringstream stream(str);
+  std::string line;
+  while (std::getline(stream, line)) {
+    lines.push_back(line);
+  }
+
+  return lines;
+}
+
+}  // namespace
+
+class BatchRunnerTest : public ::testing::Test {
+ protected:
+  BatchRunnerTest() {
+    // builds a document with a span for each method, and an invalid span
+    // with a description that has to be quoted
+    BatchDocument document;
+    document.filepath = "test.onsag";
+    document.units = units::UnitSystem::kImperial;
+    document.spans.push_back(
+        factory::BuildSagSpan(SagMethod::Type::kDynamometer));
+    document.spans.push_back(
+        factory::BuildSagSpan(SagMethod::Type::kStopWatch));
+    document.spans.push_back(factory::BuildSagSpan(SagMethod::Type::kTransit));
+
+    SagSpan span = factory::BuildSagSpan(SagMethod::Type::kDynamometer);
+    span.cable.weight_unit = -1;
+    span.description = "Invalid, \"quoted\"";
+    document.spans.push_back(span);
+
+    runner_.AddDocument(document);
+    num_errors_ = runner_.RunAnalysis(2);
+  }
+
+  int num_errors_;
+  BatchRunner runner_;
+};
+
+TEST_F(BatchRunnerTest, ExportTables) {
+  std::ostringstream stream;
+  EXPECT_EQ(1, runner_.ExportTables(5, stream));
+  const std::vector<std::string> lines = SplitLines(stream.str());
+
+  // checks the header, and the sample rows for the valid spans
+  ASSERT_EQ(1 + (3 * 5), static_cast<int>(lines.size()));
+  const std::vector<std::string> header = SplitCsv(lines[0]);
+  ASSERT_EQ(13, static_cast<int>(header.size()));
+  EXPECT_EQ("span", header[1]);
+  EXPECT_EQ("temperature", header[2]);
+
+  // the dynamometer span has a tension but no stopwatch time, and the last
+  // span is skipped
+  const int index_tension = IndexColumn(header, "tension_dyno");
+  const int index_time = IndexColumn(header, "time_stopwatch");
+  for (int i = 1; i < static_cast<int>(lines.size()); i++) {
+    const std::vector<std::string> fields = SplitCsv(lines[i]);
+    ASSERT_EQ(header.size(), fields.size());
+    EXPECT_EQ("test.onsag", fields[0]);
+    EXPECT_EQ("Test", fields[1]);
+    if (i <= 5) {
+      EXPECT_FALSE(fields[index_tension].empty());
+      EXPECT_TRUE(fields[index_time].empty());
+    }
+  }
+}
+
+TEST_F(BatchRunnerTest, OptimizeTransits) {
+  std::ostringstream stream;
+  EXPECT_EQ(0, runner_.OptimizeTransits(2, stream));
+  const std::vector<std::string> lines = SplitLines(stream.str());
+
+  // checks the header, and one row for the transit span
+  ASSERT_EQ(2, static_cast<int>(lines.size()));
+  const std::vector<std::string> header = SplitCsv(lines[0]);
+  ASSERT_EQ(10, static_cast<int>(header.size()));
+  EXPECT_EQ("status", header[2]);
+  EXPECT_EQ("feasible_current", header[8]);
+
+  // the transit location in the span is already feasible
+  const std::vector<std::string> fields = SplitCsv(lines[1]);
+  ASSERT_EQ(header.size(), fields.size());
+  EXPECT_EQ("ok", fields[2]);
+  EXPECT_FALSE(fields[3].empty());
+  EXPECT_EQ("true", fields[8]);
+}
+
+TEST_F(BatchRunnerTest, RunAnalysis) {
+  EXPECT_EQ(1, num_errors_);
+
+  const std::vector<BatchSpanResult>& results = runner_.results();
+  ASSERT_EQ(4, static_cast<int>(results.size()));
+  for (int i = 0; i < 3; i++) {
+    EXPECT_TRUE(results[i].is_valid);
+    EXPECT_EQ(5, static_cast<int>(results[i].temperatures.size()));
+  }
+  EXPECT_FALSE(results[3].is_valid);
+  EXPECT_FALSE(results[3].messages.empty());
+}
+
+TEST_F(BatchRunnerTest, SolveReadings) {
+  // gets the dynamometer tension of the first span at the base temperature
+  const BatchSpanResult& result_span = runner_.results()[0];
+  const double tension_dyno = result_span.results->tensions_dyno[
+      result_span.results->Index(result_span.index_table, 2)];
+  ASSERT_EQ(60, result_span.temperatures[2]);
+
+  // includes readings for a missing span and an invalid measurement
+  std::istringstream readings(
+      "span,measurement\r\n"
+      "Test," + helper::DoubleToFormattedString(tension_dyno, 6) + "\r\n"
+      "\n"
+      "Missing,5000\n"
+      "Test,invalid\n");
+
+  std::ostringstream stream;
+  EXPECT_EQ(2, runner_.SolveReadings(readings, stream));
+  const std::vector<std::string> lines = SplitLines(stream.str());
+  ASSERT_EQ(3, static_cast<int>(lines.size()));
+  EXPECT_EQ("file,span,measurement,status,temperature,tension_horizontal",
+            lines[0]);
+
+  // the reading is solved for the base temperature of the first span
+  std::vector<std::string> fields = SplitCsv(lines[1]);
+  ASSERT_EQ(6, static_cast<int>(fields.size()));
+  EXPECT_EQ("test.onsag", fields[0]);
+  EXPECT_EQ("Test", fields[1]);
+  EXPECT_EQ("ok", fields[3]);
+  EXPECT_EQ("60.00", fields[4]);
+
+  fields = SplitCsv(lines[2]);
+  ASSERT_EQ(6, static_cast<int>(fields.size()));
+  EXPECT_EQ("Missing", fields[1]);
+  EXPECT_EQ("error", fields[3]);
+}
+
+TEST_F(BatchRunnerTest, WriteCsv) {
+  std::ostringstream stream;
+  runner_.WriteResults(BatchRunner::FormatType::kCsv, stream);
+  const std::vector<std::string> lines = SplitLines(stream.str());
+
+  // checks the header, and one row for each span temperature and the error
+  ASSERT_EQ(1 + 5 + 5 + 5 + 1, static_cast<int>(lines.size()));
+
+  const std::vector<std::string> header = SplitCsv(lines[0]);
+  const std::vector<std::string> columns = {
+      "file", "span", "method", "units", "temperature", "status",
+      "tension_horizontal", "sag", "length", "factor_control",
+      "angle_transit", "distance_target"};
+  ASSERT_LE(columns.size(), header.size());
+  for (std::size_t i = 0; i < columns.size(); i++) {
+    EXPECT_EQ(columns[i], header[i]);
+  }
+
+  // checks that every row has a field for each column
+  for (std::size_t i = 1; i < lines.size(); i++) {
+    EXPECT_EQ(header.size(), SplitCsv(lines[i]).size()) << lines[i];
+  }
+
+  // checks a solved row
+  std::vector<std::string> fields = SplitCsv(lines[1]);
+  EXPECT_EQ("test.onsag", fields[0]);
+  EXPECT_EQ("Test", fields[1]);
+  EXPECT_EQ("dynamometer", fields[2]);
+  EXPECT_EQ("Imperial", fields[3]);
+  EXPECT_EQ("50.0", fields[4]);
+  EXPECT_EQ("ok", fields[5]);
+  EXPECT_FALSE(fields[6].empty());
+  EXPECT_FALSE(fields[7].empty());
+  EXPECT_FALSE(fields[8].empty());
+  EXPECT_TRUE(fields[9].empty());
+
+  // checks that the transit values are only filled for the transit span
+  fields = SplitCsv(lines[11]);
+  EXPECT_EQ("transit", fields[2]);
+  EXPECT_FALSE(fields[9].empty());
+  EXPECT_FALSE(fields[10].empty());
+  EXPECT_FALSE(fields[11].empty());
+
+  // checks the error row, which has a quoted description
+  fields = SplitCsv(lines[16]);
+  EXPECT_EQ("Invalid, \"quoted\"", fields[1]);
+  EXPECT_TRUE(fields[4].empty());
+  EXPECT_EQ("error", fields[5]);
+  for (std::size_t i = 6; i < fields.size(); i++) {
+    EXPECT_TRUE(fields[i].empty());
+  }
+}
+
+TEST_F(BatchRunnerTest, WriteJson) {
+  std::ostringstream stream;
+  runner_.WriteResults(BatchRunner::FormatType::kJson, stream);
+  const std::string str = stream.str();
+
+  // checks the document and span structure
+  EXPECT_EQ(0u, str.find("{\n  \"documents\": ["));
+  EXPECT_NE(std::string::npos, str.find("\"file\": \"test.onsag\""));
+  EXPECT_NE(std::string::npos, str.find("\"units\": \"Imperial\""));
+  EXPECT_NE(std::string::npos, str.find("\"method\": \"dynamometer\""));
+  EXPECT_NE(std::string::npos, str.find("\"method\": \"stopwatch\""));
+  EXPECT_NE(std::string::npos, str.find("\"method\": \"transit\""));
+  EXPECT_NE(std::string::npos,
+            str.find("\"description\": \"Invalid, \\\"quoted\\\"\""));
+
+  // checks the order of the values in the first result
+  const std::size_t position = str.find("{\"temperature\": 50.0");
+  ASSERT_NE(std::string::npos, position);
+  const std::string line = str.substr(position, str.find('\n', position)
+                                                - position);
+  const std::vector<std::string> keys = {
+      "\"temperature\"", "\"valid\": true", "\"tension_horizontal\"",
+      "\"sag\"", "\"length\"", "\"factor_control\": null",
+      "\"angle_transit\": null", "\"distance_target\": null"};
+  std::size_t position_key = 0;
+  for (auto iter = keys.cbegin(); iter != keys.cend(); iter++) {
+    const std::size_t position_next = line.find(*iter, position_key);
+    EXPECT_NE(std::string::npos, position_next) << *iter;
+    position_key = position_next;
+  }
+
+  // checks the invalid span
+  EXPECT_NE(std::string::npos, str.find("\"valid\": false"));
+  EXPECT_NE(std::string::npos, str.find("\"errors\": [\"SAG CABLE - "));
+}
+
+TEST_F(BatchRunnerTest, WriteTensionDyno) {
+  // checks the CSV dynamometer columns
+  std::ostringstream stream_csv;
+  runner_.WriteResults(BatchRunner::FormatType::kCsv, stream_csv);
+  const std::vector<std::string> lines = SplitLines(stream_csv.str());
+  ASSERT_EQ(17, static_cast<int>(lines.size()));
+
+  const std::vector<std::string> header = SplitCsv(lines[0]);
+  const int index_dyno = IndexColumn(header, "tension_dyno");
+  ASSERT_NE(-1, index_dyno);
+  EXPECT_EQ("tension_dyno_back", header[index_dyno + 1]);
+  EXPECT_EQ("tension_dyno_ahead", header[index_dyno + 2]);
+
+  // the dynamometer is on the ahead end, which is the higher attachment, so
+  // it has the larger tension
+  std::vector<std::string> fields = SplitCsv(lines[1]);
+  ASSERT_EQ("dynamometer", fields[2]);
+  const double tension_back = std::stod(fields[index_dyno + 1]);
+  const double tension_ahead = std::stod(fields[index_dyno + 2]);
+  const std::string str_ahead = fields[index_dyno + 2];
+  EXPECT_EQ(str_ahead, fields[index_dyno]);
+  EXPECT_LT(tension_back, tension_ahead);
+  EXPECT_LT(std::stod(fields[IndexColumn(header, "tension_horizontal")]),
+            tension_back);
+
+  // the dynamometer columns are empty for the other methods
+  fields = SplitCsv(lines[6]);
+  ASSERT_EQ("stopwatch", fields[2]);
+  for (int i = 0; i < 3; i++) {
+    EXPECT_TRUE(fields[index_dyno + i].empty());
+  }
+
+  // checks the JSON dynamometer values, which are null for the other methods
+  std::ostringstream stream_json;
+  runner_.WriteResults(BatchRunner::FormatType::kJson, stream_json);
+  const std::string str = stream_json.str();
+
+  std::size_t position = str.find("\"method\": \"dynamometer\"");
+  ASSERT_NE(std::string::npos, position);
+  position = str.find("\"tension_dyno\": ", position);
+  ASSERT_NE(std::string::npos, position);
+  std::string line = str.substr(position,
+                                str.find('\n', position) - position);
+  EXPECT_EQ(std::string::npos, line.find("\"tension_dyno_back\": null"));
+  EXPECT_EQ(std::string::npos, line.find("\"tension_dyno_ahead\": null"));
+  EXPECT_NE(std::string::npos,
+            line.find("\"tension_dyno_ahead\": " + str_ahead + ","));
+
+  position = str.find("\"method\": \"stopwatch\"");
+  ASSERT_NE(std::string::npos, position);
+  position = str.find("\"tension_dyno\": ", position);
+  ASSERT_NE(std::string::npos, position);
+  line = str.substr(position, str.find('\n', position) - position);
+  EXPECT_NE(std::string::npos, line.find("\"tension_dyno_back\": null"));
+  EXPECT_NE(std::string::npos, line.find("\"tension_dyno_ahead\": null"));
+}
+
+TEST_F(BatchRunnerTest, WriteTimesReturn) {
+  // checks the CSV return time columns, which follow the stopwatch time
+  std::ostringstream stream_csv;
+  runner_.WriteResults(BatchRunner::FormatType::kCsv, stream_csv);
+  const std::vector<std::string> lines = SplitLines(stream_csv.str());
+  ASSERT_EQ(17, static_cast<int>(lines.size()));
+
+  const std::vector<std::string> header = SplitCsv(lines[0]);
+  const int index_stopwatch = IndexColumn(header, "time_stopwatch");
+  ASSERT_NE(-1, index_stopwatch);
+  ASSERT_EQ(index_stopwatch + 1 + SpanSaggerResult::kNumWavesReturn,
+            static_cast<int>(header.size()));
+  for (int i = 1; i <= SpanSaggerResult::kNumWavesReturn; i++) {
+    EXPECT_EQ("time_return_" + std::to_string(i),
+              header[index_stopwatch + i]);
+  }
+
+  // the stopwatch row has a return time for every wave, and the stopwatch
+  // time matches the span wave number
+  std::vector<std::string> fields = SplitCsv(lines[6]);
+  ASSERT_EQ("stopwatch", fields[2]);
+  const double time_wave = std::stod(fields[index_stopwatch + 1]);
+  EXPECT_LT(0, time_wave);
+  for (int i = 1; i <= SpanSaggerResult::kNumWavesReturn; i++) {
+    EXPECT_NEAR(time_wave * i, std::stod(fields[index_stopwatch + i]),
+                0.001 * i);
+  }
+  EXPECT_NEAR(std::stod(fields[index_stopwatch + 3]),
+              std::stod(fields[index_stopwatch]), 0.0011);
+
+  // the return time columns are empty for the other methods
+  fields = SplitCsv(lines[1]);
+  ASSERT_EQ("dynamometer", fields[2]);
+  for (int i = 0; i <= SpanSaggerResult::kNumWavesReturn; i++) {
+    EXPECT_TRUE(fields[index_stopwatch + i].empty());
+  }
+
+  // checks the JSON return time table, which is null for the other methods
+  std::ostringstream stream_json;
+  runner_.WriteResults(BatchRunner::FormatType::kJson, stream_json);
+  const std::string str = stream_json.str();
+
+  std::size_t position = str.find("\"method\": \"stopwatch\"");
+  ASSERT_NE(std::string::npos, position);
+  position = str.find("\"times_return\": [", position);
+  ASSERT_NE(std::string::npos, position);
+  const std::size_t position_end = str.find(']', position);
+  const std::string times = str.substr(position, position_end - position);
+  EXPECT_EQ(SpanSaggerResult::kNumWavesReturn - 1,
+            std::count(times.cbegin(), times.cend(), ','));
+
+  position = str.find("\"method\": \"dynamometer\"");
+  ASSERT_NE(std::string::npos, position);
+  position = str.find("\"times_return\": ", position);
+  EXPECT_EQ(position, str.find("\"times_return\": null", position));
+}
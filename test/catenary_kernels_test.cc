@@ -0,0 +1,158 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#include "onsag/catenary_kernels.h"
+
+#include <cmath>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "models/transmissionline/catenary.h"
+
+namespace {
+
+/// \brief Builds a catenary with vertical unit weight.
+/// \param[in] constant
+///   The catenary constant.
+/// \param[in] spacing_x
+///   The horizontal spacing between end points.
+/// \param[in] spacing_z
+///   The vertical spacing between end points.
+/// \return A catenary.
+Catenary3d BuildCatenary(const double& constant, const double& spacing_x,
+                         const double& spacing_z) {
+  Vector3d spacing;
+  spacing.set_x(spacing_x);
+  spacing.set_y(0);
+  spacing.set_z(spacing_z);
+
+  Vector3d weight_unit;
+  weight_unit.set_x(0);
+  weight_unit.set_y(0);
+  weight_unit.set_z(1);
+
+  Catenary3d catenary;
+  catenary.set_direction_transverse(AxisDirectionType::kPositive);
+  catenary.set_spacing_endpoints(spacing);
+  catenary.set_tension_horizontal(constant);
+  catenary.set_weight_unit(weight_unit);
+  return catenary;
+}
+
+}  // namespace
+
+class CatenaryKernelsTest : public ::testing::Test {
+ protected:
+  /// \brief Compares the kernel coordinates to the catenary.
+  /// \param[in] catenary
+  ///   The catenary.
+  /// \param[in] num_points
+  ///   The number of points, which are evenly spaced along the catenary.
+  void CompareCoordinates(const Catenary3d& catenary, const int& num_points) {
+    SCOPED_TRACE(catenary_kernels::InstructionSet());
+    SCOPED_TRACE(num_points);
+
+    // gets the reference coordinates, and the horizontal position of each
+    std::vector<Point3d<double>> points;
+    std::vector<double> positions;
+    const Vector3d spacing = catenary.spacing_endpoints();
+    for (int i = 0; i < num_points; i++) {
+      double position_fraction = 0;
+      if (1 < num_points) {
+        position_fraction = static_cast<double>(i) / (num_points - 1);
+      }
+
+      const Point3d<double> point = catenary.Coordinate(position_fraction);
+      points.push_back(point);
+      positions.push_back(point.x / spacing.x());
+    }
+
+    std::vector<double> xs(num_points);
+    std::vector<double> zs(num_points);
+    catenary_kernels::Coordinates(catenary.Constant(), spacing.x(),
+                                  spacing.z(), num_points, positions.data(),
+                                  xs.data(), zs.data());
+
+    // the vertical tolerance covers the cancellation against the low point
+    // offset, which is about the size of the constant
+    for (int i = 0; i < num_points; i++) {
+      const Point3d<double>& point = points[i];
+      EXPECT_NEAR(point.x, xs[i], 1e-12 * spacing.x()) << i;
+      EXPECT_NEAR(point.z, zs[i],
+                  1e-12 * (std::abs(point.z) + catenary.Constant())) << i;
+    }
+  }
+};
+
+TEST_F(CatenaryKernelsTest, Coordinates) {
+  // covers every pack remainder, and a plot sized array
+  const Catenary3d catenary = BuildCatenary(3500, 1200, 50);
+  for (int num_points = 0; num_points <= 9; num_points++) {
+    CompareCoordinates(catenary, num_points);
+  }
+  CompareCoordinates(catenary, 101);
+}
+
+TEST_F(CatenaryKernelsTest, CoordinatesPacks) {
+  // the values from full packs match the values from the scalar remainder,
+  // which are calculated one at a time
+  const Catenary3d catenary = BuildCatenary(3500, 1200, 50);
+  const Vector3d spacing = catenary.spacing_endpoints();
+
+  const int kNumPoints = 9;
+  std::vector<double> positions(kNumPoints);
+  for (int i = 0; i < kNumPoints; i++) {
+    positions[i] = static_cast<double>(i) / (kNumPoints - 1);
+  }
+
+  std::vector<double> xs(kNumPoints);
+  std::vector<double> zs(kNumPoints);
+  catenary_kernels::Coordinates(catenary.Constant(), spacing.x(), spacing.z(),
+                                kNumPoints, positions.data(), xs.data(),
+                                zs.data());
+
+  for (int i = 0; i < kNumPoints; i++) {
+    double x = -999999;
+    double z = -999999;
+    catenary_kernels::Coordinates(catenary.Constant(), spacing.x(),
+                                  spacing.z(), 1, &positions[i], &x, &z);
+    EXPECT_DOUBLE_EQ(x, xs[i]) << i;
+    EXPECT_NEAR(z, zs[i], 1e-12 * catenary.Constant()) << i;
+  }
+}
+
+TEST_F(CatenaryKernelsTest, CoordinatesSteep) {
+  // the low point is outside of the span for steep slopes in either
+  // direction, and the curve is deep for small constants
+  const double spacings_z[4] = {-800, -300, 300, 800};
+  const double constants[3] = {200, 1000, 10000};
+  for (int i = 0; i < 4; i++) {
+    for (int j = 0; j < 3; j++) {
+      CompareCoordinates(BuildCatenary(constants[j], 1000, spacings_z[i]), 11);
+    }
+  }
+}
+
+TEST_F(CatenaryKernelsTest, CoordinatesExpClamp) {
+  // the hyperbolic arguments reach +/-700, which is just inside of the exp
+  // clamp
+  CompareCoordinates(BuildCatenary(1, 1400, 0), 7);
+
+  // the arguments reach +/-750, which are clamped so the coordinates stay
+  // finite instead of overflowing
+  const int kNumPoints = 7;
+  std::vector<double> positions(kNumPoints);
+  for (int i = 0; i < kNumPoints; i++) {
+    positions[i] = static_cast<double>(i) / (kNumPoints - 1);
+  }
+
+  std::vector<double> xs(kNumPoints);
+  std::vector<double> zs(kNumPoints);
+  catenary_kernels::Coordinates(1, 1500, 0, kNumPoints, positions.data(),
+                                xs.data(), zs.data());
+  for (int i = 0; i < kNumPoints; i++) {
+    EXPECT_TRUE(std::isfinite(xs[i])) << i;
+    EXPECT_TRUE(std::isfinite(zs[i])) << i;
+  }
+  EXPECT_LT(zs[kNumPoints / 2], zs[0]);
+}
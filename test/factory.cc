@@ -0,0 +1,55 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#include "test/factory.h"
+
+namespace factory {
+
+SagCable BuildSagCable() {
+  SagCable cable;
+  cable.correction_creep = 0;
+  cable.correction_sag = 0;
+  cable.name = "ACSR Drake";
+  cable.scale = 1;
+  cable.weight_unit = 1.094;
+
+  // adds tension points in ascending temperature order
+  const double temperatures[5] = {0, 30, 60, 90, 120};
+  const double tensions[5] = {5000, 4400, 3900, 3500, 3200};
+  for (int i = 0; i < 5; i++) {
+    SagCable::TensionPoint point;
+    point.temperature = temperatures[i];
+    point.tension_horizontal = tensions[i];
+    cable.tensions.push_back(point);
+  }
+
+  return cable;
+}
+
+SagSpan BuildSagSpan(const SagMethod::Type& type) {
+  SagSpan span;
+  span.cable = BuildSagCable();
+  span.description = "Test";
+  span.temperature_base = 60;
+  span.temperature_interval = 5;
+
+  span.structure_back.name = "1/1";
+  span.structure_back.attachment = "Center";
+  span.structure_back.point_attachment.x = 0;
+  span.structure_back.point_attachment.y = 100;
+
+  span.structure_ahead.name = "1/2";
+  span.structure_ahead.attachment = "Center";
+  span.structure_ahead.point_attachment.x = 1200;
+  span.structure_ahead.point_attachment.y = 150;
+
+  span.method.end = SagMethod::SpanEndType::kAheadOnLine;
+  span.method.point_transit.x = 0;
+  span.method.point_transit.y = 50;
+  span.method.type = type;
+  span.method.wave_return = 3;
+
+  return span;
+}
+
+}  // namespace factory
@@ -0,0 +1,31 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#ifndef ONSAG_TEST_FACTORY_H_
+#define ONSAG_TEST_FACTORY_H_
+
+#include "onsag/sag_cable.h"
+#include "onsag/sag_method.h"
+#include "onsag/sag_span.h"
+
+/// \par OVERVIEW
+///
+/// This namespace builds the objects that are shared by the tests. All of the
+/// objects use imperial units, in the consistent unit style.
+namespace factory {
+
+/// \brief Builds a sag cable.
+/// \return A sag cable with tension points from 0 to 120 degrees, and no
+///   creep or sag corrections.
+SagCable BuildSagCable();
+
+/// \brief Builds a sag span.
+/// \param[in] type
+///   The sagging method type.
+/// \return A 1200 ft inclined span. The transit is located on the back
+///   structure, near the sag at the base temperature.
+SagSpan BuildSagSpan(const SagMethod::Type& type);
+
+}  // namespace factory
+
+#endif  // ONSAG_TEST_FACTORY_H_
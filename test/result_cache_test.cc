@@ -0,0 +1,175 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#include "onsag/result_cache.h"
+
+#include <string>
+
+#include "gtest/gtest.h"
+
+#include "test/factory.h"
+
+namespace {
+
+/// \brief Builds a key from raw bytes.
+/// \param[in] bytes
+///   The bytes, which are not null terminated.
+/// \return A key that contains the 8 bytes.
+std::string KeyBytes(const unsigned char bytes[8]) {
+  return std::string(reinterpret_cast<const char*>(bytes), 8);
+}
+
+/// \brief Builds a result that can be identified by the transit angle.
+/// \param[in] angle_transit
+///   The transit angle.
+/// \return A result.
+SaggingAnalysisResult Result(const double& angle_transit) {
+  SaggingAnalysisResult result;
+  result.angle_transit = angle_transit;
+  result.times_return.assign(10, 1);
+  return result;
+}
+
+}  // namespace
+
+class ResultCacheTest : public ::testing::Test {
+ protected:
+  ResultCacheTest() {
+    span_ = factory::BuildSagSpan(SagMethod::Type::kStopWatch);
+  }
+
+  SagSpan span_;
+};
+
+TEST_F(ResultCacheTest, Find) {
+  ResultCache cache;
+  const std::string key = ResultCache::Key(span_, 60,
+                                           units::UnitSystem::kImperial, 0);
+
+  SaggingAnalysisResult result;
+  EXPECT_FALSE(cache.Find(key, result));
+  EXPECT_EQ(0, cache.num_hits());
+  EXPECT_EQ(1, cache.num_misses());
+
+  cache.Insert(key, Result(1));
+  EXPECT_EQ(1, cache.count());
+  EXPECT_TRUE(cache.Find(key, result));
+  EXPECT_EQ(1, result.angle_transit);
+  EXPECT_EQ(nullptr, result.temperature_cable);
+  EXPECT_EQ(1, cache.num_hits());
+  EXPECT_EQ(1, cache.num_misses());
+
+  // replaces the entry with the same key
+  cache.Insert(key, Result(2));
+  EXPECT_EQ(1, cache.count());
+  EXPECT_TRUE(cache.Find(key, result));
+  EXPECT_EQ(2, result.angle_transit);
+  EXPECT_EQ(2, cache.num_hits());
+
+  cache.Clear();
+  EXPECT_EQ(0, cache.count());
+  EXPECT_EQ(0u, cache.size());
+  EXPECT_FALSE(cache.Find(key, result));
+  EXPECT_EQ(2, cache.num_misses());
+}
+
+TEST_F(ResultCacheTest, FindCollision) {
+  // these keys have the same 64-bit FNV-1a hash (0x8153c251a3829557)
+  const unsigned char bytes_a[8] = {0xc1, 0xdb, 0x7e, 0x98,
+                                    0xcf, 0x0f, 0xd5, 0xc9};
+  const unsigned char bytes_b[8] = {0x28, 0x7b, 0x80, 0xc0,
+                                    0xea, 0xf0, 0x49, 0x68};
+  const std::string key_a = KeyBytes(bytes_a);
+  const std::string key_b = KeyBytes(bytes_b);
+  ASSERT_NE(key_a, key_b);
+
+  ResultCache cache;
+  SaggingAnalysisResult result = Result(-999999);
+  cache.Insert(key_a, Result(1));
+
+  // the full key is compared, so the colliding key is not found
+  EXPECT_FALSE(cache.Find(key_b, result));
+  EXPECT_EQ(-999999, result.angle_transit);
+  EXPECT_TRUE(cache.Find(key_a, result));
+  EXPECT_EQ(1, result.angle_transit);
+
+  // the colliding key replaces the entry
+  cache.Insert(key_b, Result(2));
+  EXPECT_EQ(1, cache.count());
+  EXPECT_FALSE(cache.Find(key_a, result));
+  EXPECT_TRUE(cache.Find(key_b, result));
+  EXPECT_EQ(2, result.angle_transit);
+}
+
+TEST_F(ResultCacheTest, Evict) {
+  const std::string key_1 = ResultCache::Key(span_, 50,
+                                             units::UnitSystem::kImperial, 0);
+  const std::string key_2 = ResultCache::Key(span_, 60,
+                                             units::UnitSystem::kImperial, 0);
+  const std::string key_3 = ResultCache::Key(span_, 70,
+                                             units::UnitSystem::kImperial, 0);
+
+  // gets the size of an entry, and sets a budget for two entries
+  std::size_t size_entry = 0;
+  {
+    ResultCache cache;
+    cache.Insert(key_1, Result(1));
+    size_entry = cache.size();
+  }
+  ASSERT_LT(0u, size_entry);
+
+  ResultCache cache(2 * size_entry + size_entry / 2);
+  SaggingAnalysisResult result;
+  cache.Insert(key_1, Result(1));
+  cache.Insert(key_2, Result(2));
+  EXPECT_EQ(2, cache.count());
+
+  // uses the first entry, so the second is the least recently used
+  EXPECT_TRUE(cache.Find(key_1, result));
+  cache.Insert(key_3, Result(3));
+  EXPECT_EQ(2, cache.count());
+  EXPECT_LE(cache.size(), cache.size_max());
+
+  EXPECT_TRUE(cache.Find(key_1, result));
+  EXPECT_FALSE(cache.Find(key_2, result));
+  EXPECT_TRUE(cache.Find(key_3, result));
+  EXPECT_EQ(3, result.angle_transit);
+}
+
+TEST_F(ResultCacheTest, Key) {
+  const std::string key = ResultCache::Key(span_, 60,
+                                           units::UnitSystem::kImperial, 0);
+
+  // descriptive text is not part of the key
+  SagSpan span = span_;
+  span.description = "Renamed";
+  span.cable.name = "Renamed";
+  EXPECT_EQ(key, ResultCache::Key(span, 60, units::UnitSystem::kImperial, 0));
+
+  // solution inputs are part of the key
+  EXPECT_NE(key, ResultCache::Key(span_, 61, units::UnitSystem::kImperial, 0));
+  EXPECT_NE(key, ResultCache::Key(span_, 60, units::UnitSystem::kMetric, 0));
+
+  span = span_;
+  span.cable.tensions.back().tension_horizontal += 1;
+  EXPECT_NE(key, ResultCache::Key(span, 60, units::UnitSystem::kImperial, 0));
+
+  span = span_;
+  span.structure_ahead.point_attachment.y += 1;
+  EXPECT_NE(key, ResultCache::Key(span, 60, units::UnitSystem::kImperial, 0));
+
+  // the wave number is only part of the key if it is beyond the return time
+  // table
+  span = span_;
+  span.method.wave_return = SpanSaggerResult::kNumWavesReturn;
+  EXPECT_EQ(key, ResultCache::Key(span, 60, units::UnitSystem::kImperial, 0));
+  span.method.wave_return = SpanSaggerResult::kNumWavesReturn + 1;
+  EXPECT_NE(key, ResultCache::Key(span, 60, units::UnitSystem::kImperial, 0));
+
+  // the parabola tolerance is part of the key, and every tolerance that
+  // isn't positive is solved exactly
+  EXPECT_NE(key,
+            ResultCache::Key(span_, 60, units::UnitSystem::kImperial, 0.01));
+  EXPECT_EQ(key,
+            ResultCache::Key(span_, 60, units::UnitSystem::kImperial, -1));
+}
@@ -0,0 +1,205 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#include "onsag/span_analyzer.h"
+
+#include <limits>
+
+#include "gtest/gtest.h"
+
+#include "test/factory.h"
+
+class SpanAnalyzerTest : public ::testing::Test {
+ protected:
+  SpanAnalyzerTest() {
+    span_ = factory::BuildSagSpan(SagMethod::Type::kStopWatch);
+
+    analyzer_.set_span(&span_);
+    analyzer_.set_units(units::UnitSystem::kImperial);
+  }
+
+  SpanAnalyzer analyzer_;
+  SagSpan span_;
+};
+
+TEST_F(SpanAnalyzerTest, Analyze) {
+  const double temperature = 60;
+  SaggingAnalysisResult result;
+  EXPECT_TRUE(analyzer_.Analyze(&temperature, result));
+  EXPECT_EQ(&temperature, result.temperature_cable);
+  EXPECT_LT(0, result.time_stopwatch);
+  EXPECT_EQ(10, static_cast<int>(result.times_return.size()));
+}
+
+TEST_F(SpanAnalyzerTest, AnalyzeCache) {
+  ResultCache cache;
+  analyzer_.set_cache(&cache);
+
+  const double temperature = 60;
+  SaggingAnalysisResult result_solved;
+  SaggingAnalysisResult result_cached;
+  EXPECT_TRUE(analyzer_.Analyze(&temperature, result_solved));
+  const int iterations = analyzer_.iterations_correction();
+  EXPECT_TRUE(analyzer_.Analyze(&temperature, result_cached));
+
+  // the cached result does not solve the span again
+  EXPECT_EQ(1, cache.num_hits());
+  EXPECT_EQ(1, cache.num_misses());
+  EXPECT_EQ(iterations, analyzer_.iterations_correction());
+
+  EXPECT_EQ(&temperature, result_cached.temperature_cable);
+  EXPECT_EQ(result_solved.catenary.tension_horizontal(),
+            result_cached.catenary.tension_horizontal());
+  EXPECT_EQ(result_solved.time_stopwatch, result_cached.time_stopwatch);
+  EXPECT_EQ(result_solved.times_return, result_cached.times_return);
+
+  // a different wave number uses the cached result, and selects the
+  // stopwatch time from the return time table
+  span_.method.wave_return = 7;
+  analyzer_.set_span(&span_);
+  EXPECT_TRUE(analyzer_.Analyze(&temperature, result_cached));
+  EXPECT_EQ(2, cache.num_hits());
+  EXPECT_EQ(result_solved.times_return[6], result_cached.time_stopwatch);
+
+  SpanAnalyzer analyzer;
+  analyzer.set_span(&span_);
+  analyzer.set_units(units::UnitSystem::kImperial);
+  EXPECT_TRUE(analyzer.Analyze(&temperature, result_solved));
+  EXPECT_NEAR(result_solved.time_stopwatch, result_cached.time_stopwatch,
+              result_solved.time_stopwatch * 1e-12);
+}
+
+TEST_F(SpanAnalyzerTest, AnalyzeParabola) {
+  ResultCache cache;
+  analyzer_.set_cache(&cache);
+
+  const double temperature = 60;
+  SaggingAnalysisResult result_exact;
+  SaggingAnalysisResult result_parabola;
+  EXPECT_TRUE(analyzer_.Analyze(&temperature, result_exact));
+  EXPECT_EQ(result_exact.catenary.Sag(), result_exact.sag);
+
+  // the parabola tolerance is part of the cache key, so the exact result is
+  // not reused
+  analyzer_.set_tolerance_parabola(0.5);
+  EXPECT_TRUE(analyzer_.Analyze(&temperature, result_parabola));
+  EXPECT_EQ(0, cache.num_hits());
+  EXPECT_EQ(2, cache.num_misses());
+  EXPECT_EQ(1, analyzer_.num_solves_parabola());
+  EXPECT_NE(result_exact.sag, result_parabola.sag);
+  EXPECT_NEAR(result_exact.sag, result_parabola.sag, 0.5);
+  EXPECT_NEAR(result_exact.length, result_parabola.length, 0.5);
+}
+
+TEST_F(SpanAnalyzerTest, AnalyzeInvalid) {
+  const double temperature = 60;
+  SaggingAnalysisResult result;
+  std::list<ErrorMessage> messages;
+
+  // checks a missing temperature
+  EXPECT_FALSE(analyzer_.Analyze(nullptr, result, &messages));
+  EXPECT_EQ(-999999, result.time_stopwatch);
+  EXPECT_EQ(1, static_cast<int>(messages.size()));
+
+  // checks a missing span
+  messages.clear();
+  SpanAnalyzer analyzer;
+  analyzer.set_units(units::UnitSystem::kImperial);
+  EXPECT_FALSE(analyzer.Analyze(&temperature, result, &messages));
+  EXPECT_EQ(-999999, result.time_stopwatch);
+  EXPECT_EQ(1, static_cast<int>(messages.size()));
+}
+
+TEST_F(SpanAnalyzerTest, TemperaturesCable) {
+  TemperatureSweep sweep;
+  sweep.type = TemperatureSweep::Type::kCable;
+  sweep.step = 10;
+
+  // both ends of the range are shifted by the creep correction
+  span_.cable.correction_creep = 15;
+  std::vector<double> temperatures = SpanAnalyzer::Temperatures(span_, sweep);
+  ASSERT_EQ(13, static_cast<int>(temperatures.size()));
+  EXPECT_DOUBLE_EQ(15, temperatures.front());
+  EXPECT_DOUBLE_EQ(135, temperatures.back());
+
+  // every temperature in the sweep can be solved
+  analyzer_.set_span(&span_);
+  std::vector<SaggingAnalysisResult> results;
+  EXPECT_TRUE(analyzer_.Analyze(temperatures, results));
+}
+
+TEST_F(SpanAnalyzerTest, TemperaturesMax) {
+  TemperatureSweep sweep;
+  sweep.type = TemperatureSweep::Type::kCable;
+  sweep.step = 0.001;
+
+  // fails instead of truncating the sweep
+  std::list<ErrorMessage> messages;
+  EXPECT_TRUE(SpanAnalyzer::Temperatures(span_, sweep, &messages).empty());
+  EXPECT_EQ(1, static_cast<int>(messages.size()));
+
+  // the maximum number of temperatures is allowed
+  sweep.step = 120.0 / (SpanAnalyzer::kNumTemperaturesMax - 1);
+  messages.clear();
+  EXPECT_EQ(SpanAnalyzer::kNumTemperaturesMax,
+            static_cast<int>(
+                SpanAnalyzer::Temperatures(span_, sweep, &messages).size()));
+  EXPECT_TRUE(messages.empty());
+}
+
+TEST_F(SpanAnalyzerTest, TemperaturesMaxIntervals) {
+  TemperatureSweep sweep;
+  sweep.type = TemperatureSweep::Type::kSpan;
+
+  // fails for intervals that would overflow the count
+  const int nums_intervals[3] = {SpanAnalyzer::kNumTemperaturesMax / 2,
+                                 std::numeric_limits<int>::max() / 2,
+                                 std::numeric_limits<int>::max()};
+  for (int i = 0; i < 3; i++) {
+    sweep.num_intervals = nums_intervals[i];
+    std::list<ErrorMessage> messages;
+    EXPECT_TRUE(SpanAnalyzer::Temperatures(span_, sweep, &messages).empty());
+    EXPECT_EQ(1, static_cast<int>(messages.size()));
+  }
+
+  // the most intervals that fit are allowed
+  sweep.num_intervals = (SpanAnalyzer::kNumTemperaturesMax - 1) / 2;
+  EXPECT_EQ((2 * sweep.num_intervals) + 1,
+            static_cast<int>(SpanAnalyzer::Temperatures(span_, sweep).size()));
+}
+
+TEST_F(SpanAnalyzerTest, AnalyzeWarmStart) {
+  span_.cable.correction_sag = 2;
+  analyzer_.set_span(&span_);
+
+  TemperatureSweep sweep;
+  sweep.type = TemperatureSweep::Type::kCable;
+  sweep.step = 1;
+  const std::vector<double> temperatures =
+      SpanAnalyzer::Temperatures(span_, sweep);
+
+  // solves the sweep with and without warm starting
+  std::vector<SaggingAnalysisResult> results_warm;
+  analyzer_.set_is_warm_started(true);
+  ASSERT_TRUE(analyzer_.Analyze(temperatures, results_warm));
+  const int iterations_warm = analyzer_.iterations_correction();
+
+  std::vector<SaggingAnalysisResult> results_cold;
+  analyzer_.set_span(&span_);
+  analyzer_.set_is_warm_started(false);
+  ASSERT_TRUE(analyzer_.Analyze(temperatures, results_cold));
+  const int iterations_cold = analyzer_.iterations_correction();
+
+  // the warm start only changes the seed, so the solutions match within the
+  // solver precision
+  for (std::size_t i = 0; i < temperatures.size(); i++) {
+    const double tension_cold = results_cold[i].catenary.tension_horizontal();
+    EXPECT_NEAR(tension_cold, results_warm[i].catenary.tension_horizontal(),
+                tension_cold * 1e-8);
+    EXPECT_NEAR(results_cold[i].time_stopwatch,
+                results_warm[i].time_stopwatch,
+                results_cold[i].time_stopwatch * 1e-8);
+  }
+
+  EXPECT_LT(iterations_warm, iterations_cold);
+}
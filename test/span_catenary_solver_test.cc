@@ -0,0 +1,145 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#include "onsag/span_catenary_solver.h"
+
+#include "gtest/gtest.h"
+
+#include "test/factory.h"
+
+class SpanCatenarySolverTest : public ::testing::Test {
+ protected:
+  SpanCatenarySolverTest() {
+    span_ = factory::BuildSagSpan(SagMethod::Type::kDynamometer);
+    SetSpan(solver_);
+    SetSpan(solver_exact_);
+  }
+
+  /// \brief Sets the span inputs of a solver.
+  /// \param[in,out] solver
+  ///   The solver.
+  void SetSpan(SpanCatenarySolver& solver) {
+    solver.set_cable(&span_.cable);
+    solver.set_structure_ahead(&span_.structure_ahead);
+    solver.set_structure_back(&span_.structure_back);
+  }
+
+  SpanCatenarySolver solver_;
+  SpanCatenarySolver solver_exact_;
+  SagSpan span_;
+};
+
+TEST_F(SpanCatenarySolverTest, Parabola) {
+  // the exact solver matches the catenary
+  const double temperature = 60;
+  solver_.set_temperature(&temperature);
+  solver_exact_.set_temperature(&temperature);
+  ASSERT_NE(nullptr, solver_exact_.Catenary());
+  EXPECT_EQ(solver_exact_.Catenary()->Sag(), solver_exact_.Sag());
+  EXPECT_EQ(solver_exact_.Catenary()->Length(), solver_exact_.Length());
+  EXPECT_EQ(0, solver_exact_.num_solves_parabola());
+  EXPECT_EQ(0, solver_exact_.num_solves_parabola_fallback());
+
+  // the 1200 ft span is within a loose tolerance, and differs from the exact
+  // sag by less than the tolerance
+  solver_.set_tolerance_parabola(0.5);
+  ASSERT_NE(nullptr, solver_.Catenary());
+  EXPECT_EQ(1, solver_.num_solves_parabola());
+  EXPECT_EQ(0, solver_.num_solves_parabola_fallback());
+  EXPECT_NE(solver_exact_.Sag(), solver_.Sag());
+  EXPECT_NEAR(solver_exact_.Sag(), solver_.Sag(), 0.5);
+  EXPECT_NEAR(solver_exact_.Length(), solver_.Length(), 0.5);
+  EXPECT_EQ(solver_exact_.Catenary()->tension_horizontal(),
+            solver_.Catenary()->tension_horizontal());
+
+  // the bound exceeds a tight tolerance, so the exact catenary is used
+  solver_.set_tolerance_parabola(0.001);
+  ASSERT_NE(nullptr, solver_.Catenary());
+  EXPECT_EQ(1, solver_.num_solves_parabola());
+  EXPECT_EQ(1, solver_.num_solves_parabola_fallback());
+  EXPECT_EQ(solver_exact_.Sag(), solver_.Sag());
+  EXPECT_EQ(solver_exact_.Length(), solver_.Length());
+
+  // a short span is within the tight tolerance
+  span_.structure_ahead.point_attachment.x = 200;
+  span_.structure_ahead.point_attachment.y = 110;
+  SetSpan(solver_);
+  SetSpan(solver_exact_);
+  ASSERT_NE(nullptr, solver_.Catenary());
+  EXPECT_EQ(2, solver_.num_solves_parabola());
+  EXPECT_NEAR(solver_exact_.Sag(), solver_.Sag(), 0.001);
+  EXPECT_NEAR(solver_exact_.Length(), solver_.Length(), 0.001);
+}
+
+TEST_F(SpanCatenarySolverTest, ParabolaBound) {
+  // sweeps spans, elevations, temperatures, and sag corrections, and checks
+  // that every parabola solve is within the tolerance of the exact catenary
+  const double tolerances[4] = {0.001, 0.01, 0.1, 1};
+  const double spacings_x[5] = {100, 400, 1200, 2400, 5000};
+  const double spacings_y[4] = {-400, 0, 50, 800};
+  const double corrections_sag[3] = {-1, 0, 3};
+  const double temperatures[3] = {0, 60, 120};
+
+  int num_solves_parabola = 0;
+  int num_solves_parabola_fallback = 0;
+  int num_unsolved = 0;
+  for (int i = 0; i < 4; i++) {
+    const double& tolerance = tolerances[i];
+    for (int j = 0; j < 5; j++) {
+      const double& spacing_x = spacings_x[j];
+      for (int k = 0; k < 4; k++) {
+        const double& spacing_y = spacings_y[k];
+        for (int m = 0; m < 3; m++) {
+          const double& correction_sag = corrections_sag[m];
+          span_.cable.correction_sag = correction_sag;
+          span_.structure_ahead.point_attachment.x = spacing_x;
+          span_.structure_ahead.point_attachment.y = 100 + spacing_y;
+
+          SpanCatenarySolver solver;
+          SetSpan(solver);
+          solver.set_tolerance_parabola(tolerance);
+          SetSpan(solver_exact_);
+
+          for (int n = 0; n < 3; n++) {
+            const double& temperature = temperatures[n];
+            solver.set_temperature(&temperature);
+            solver_exact_.set_temperature(&temperature);
+            const int num_solves = solver.num_solves_parabola();
+
+            // the sag correction can't be applied to a span that is too short
+            if (solver_exact_.Catenary() == nullptr) {
+              EXPECT_EQ(nullptr, solver.Catenary());
+              num_unsolved++;
+              continue;
+            }
+            ASSERT_NE(nullptr, solver.Catenary());
+            if (solver.num_solves_parabola() == num_solves) {
+              EXPECT_NEAR(solver_exact_.Sag(), solver.Sag(), 1e-6);
+              continue;
+            }
+
+            // the corrected tension is within the tolerance of the target
+            // sag, and the parabolic values are within the tolerance of the
+            // catenary at the corrected tension
+            const Catenary3d& catenary = *solver.Catenary();
+            EXPECT_NEAR(solver_exact_.Sag(), catenary.Sag(), tolerance);
+            EXPECT_NEAR(catenary.Sag(), solver.Sag(), tolerance);
+            EXPECT_NEAR(catenary.Length(), solver.Length(), tolerance);
+            EXPECT_EQ(0, solver.IterationsCorrection());
+          }
+
+          num_solves_parabola += solver.num_solves_parabola();
+          num_solves_parabola_fallback +=
+              solver.num_solves_parabola_fallback();
+        }
+      }
+    }
+  }
+
+  // both paths are covered
+  EXPECT_LT(0, num_solves_parabola);
+  EXPECT_LT(0, num_solves_parabola_fallback);
+  EXPECT_EQ(4 * 5 * 4 * 3 * 3, num_solves_parabola
+                                 + num_solves_parabola_fallback
+                                 + num_unsolved);
+}
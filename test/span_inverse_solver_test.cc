@@ -0,0 +1,100 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#include "onsag/span_inverse_solver.h"
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "onsag/span_analyzer.h"
+#include "test/factory.h"
+
+class SpanInverseSolverTest : public ::testing::Test {
+ protected:
+  SpanInverseSolverTest() {
+    spans_.push_back(factory::BuildSagSpan(SagMethod::Type::kDynamometer));
+    spans_.push_back(factory::BuildSagSpan(SagMethod::Type::kStopWatch));
+    spans_.push_back(factory::BuildSagSpan(SagMethod::Type::kTransit));
+  }
+
+  /// \brief Gets the measurement for the span method.
+  /// \param[in] type
+  ///   The method type.
+  /// \param[in] result
+  ///   The analysis result.
+  /// \return The measurement.
+  static double Measurement(const SagMethod::Type& type,
+                            const SaggingAnalysisResult& result) {
+    if (type == SagMethod::Type::kDynamometer) {
+      return result.tension_dyno;
+    } else if (type == SagMethod::Type::kStopWatch) {
+      return result.time_stopwatch;
+    } else {
+      return result.angle_transit;
+    }
+  }
+
+  std::vector<SagSpan> spans_;
+};
+
+TEST_F(SpanInverseSolverTest, Solve) {
+  const std::vector<double> temperatures = {0, 12.3, 47.5, 60, 101.7, 120};
+
+  SpanAnalyzer analyzer;
+  analyzer.set_units(units::UnitSystem::kImperial);
+
+  // solves the measurement at each temperature, and inverts it back to the
+  // temperature
+  for (auto iter = spans_.cbegin(); iter != spans_.cend(); iter++) {
+    const SagSpan& span = *iter;
+    analyzer.set_span(&span);
+
+    SpanInverseSolver solver;
+    solver.set_span(&span);
+    solver.set_units(units::UnitSystem::kImperial);
+    ASSERT_TRUE(solver.Validate(false, nullptr));
+
+    std::vector<SaggingAnalysisResult> results;
+    ASSERT_TRUE(analyzer.Analyze(temperatures, results));
+
+    std::vector<double> measurements;
+    for (auto it = results.cbegin(); it != results.cend(); it++) {
+      measurements.push_back(Measurement(span.method.type, *it));
+    }
+
+    std::vector<SpanInverseResult> results_inverse;
+    EXPECT_EQ(0, solver.Solve(measurements, results_inverse));
+    ASSERT_EQ(temperatures.size(), results_inverse.size());
+    for (std::size_t i = 0; i < temperatures.size(); i++) {
+      const SpanInverseResult& result = results_inverse[i];
+      const double tension = results[i].catenary.tension_horizontal();
+      EXPECT_TRUE(result.is_solved);
+      EXPECT_NEAR(temperatures[i], result.temperature, 1e-6);
+      EXPECT_NEAR(tension, result.tension_horizontal, tension * 1e-8);
+    }
+
+    // the table brackets the full cable temperature range
+    EXPECT_EQ(0, solver.table().TemperatureSample(0));
+    EXPECT_EQ(120, solver.table().TemperatureSample(
+        solver.table().num_samples() - 1));
+  }
+}
+
+TEST_F(SpanInverseSolverTest, SolveInvalid) {
+  SpanInverseSolver solver;
+  SpanInverseResult result;
+
+  // fails without a span
+  solver.set_units(units::UnitSystem::kImperial);
+  EXPECT_FALSE(solver.Validate(false, nullptr));
+  EXPECT_FALSE(solver.Solve(5000, result));
+  EXPECT_FALSE(result.is_solved);
+
+  // fails for a measurement that no cable temperature matches
+  solver.set_span(&spans_[0]);
+  EXPECT_TRUE(solver.Solve(4000, result));
+  EXPECT_FALSE(solver.Solve(-1, result));
+  EXPECT_FALSE(solver.Solve(1e9, result));
+  EXPECT_EQ(-999999, result.temperature);
+}
@@ -0,0 +1,78 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#include "onsag/span_lookup_table.h"
+
+#include <sstream>
+#include <string>
+
+#include "gtest/gtest.h"
+
+#include "onsag/span_analyzer.h"
+#include "test/factory.h"
+
+class SpanLookupTableTest : public ::testing::Test {
+ protected:
+  SpanLookupTableTest() {
+    // uses a 1000 ft span
+    span_ = factory::BuildSagSpan(SagMethod::Type::kDynamometer);
+    span_.structure_ahead.point_attachment.x = 1000;
+
+    table_.set_span(&span_);
+    table_.set_units(units::UnitSystem::kImperial);
+  }
+
+  SagSpan span_;
+  SpanLookupTable table_;
+};
+
+TEST_F(SpanLookupTableTest, Value) {
+  ASSERT_TRUE(table_.Validate(false, nullptr));
+
+  SpanAnalyzer analyzer;
+  analyzer.set_span(&span_);
+  analyzer.set_units(units::UnitSystem::kImperial);
+
+  // compares the table to the exact solution at every sample, and halfway
+  // between samples where the interpolation error is largest
+  const int num_samples = table_.num_samples();
+  for (int i = 0; i < (2 * num_samples) - 1; i++) {
+    const int index = i / 2;
+    double temperature = table_.TemperatureSample(index);
+    if (i % 2 == 1) {
+      temperature = (temperature + table_.TemperatureSample(index + 1)) / 2;
+    }
+
+    SaggingAnalysisResult result;
+    ASSERT_TRUE(analyzer.Analyze(&temperature, result));
+    EXPECT_NEAR(result.sag,
+                table_.Value(SpanLookupTable::ValueType::kSag, temperature),
+                5e-5) << temperature;
+    EXPECT_NEAR(result.tension_dyno,
+                table_.Value(SpanLookupTable::ValueType::kTensionDyno,
+                             temperature),
+                result.tension_dyno * 1e-6) << temperature;
+  }
+
+  // the table doesn't extrapolate, or apply other method values
+  EXPECT_EQ(-999999, table_.Value(SpanLookupTable::ValueType::kSag,
+                                  table_.TemperatureMax() + 1));
+  EXPECT_EQ(-999999, table_.Value(SpanLookupTable::ValueType::kTimeStopwatch,
+                                  60));
+}
+
+TEST_F(SpanLookupTableTest, Write) {
+  std::stringstream stream;
+  table_.Write(stream);
+
+  // checks the header, and one row for each sample
+  std::string line;
+  ASSERT_TRUE(static_cast<bool>(std::getline(stream, line)));
+  EXPECT_EQ(0u, line.find("temperature,angle_transit,"));
+
+  int num_rows = 0;
+  while (std::getline(stream, line)) {
+    num_rows++;
+  }
+  EXPECT_EQ(table_.num_samples(), num_rows);
+}
@@ -0,0 +1,135 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#include "onsag/span_monte_carlo.h"
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "test/factory.h"
+
+namespace {
+
+/// \brief Checks that two distributions are identical.
+/// \param[in] a
+///   The first distribution.
+/// \param[in] b
+///   The second distribution.
+void ExpectEqual(const SampleDistribution& a, const SampleDistribution& b) {
+  EXPECT_EQ(a.counts, b.counts);
+  EXPECT_EQ(a.deviation, b.deviation);
+  EXPECT_EQ(a.max, b.max);
+  EXPECT_EQ(a.mean, b.mean);
+  EXPECT_EQ(a.min, b.min);
+  EXPECT_EQ(a.num_above, b.num_above);
+  EXPECT_EQ(a.num_below, b.num_below);
+  EXPECT_EQ(a.num_samples, b.num_samples);
+  EXPECT_EQ(a.value_begin, b.value_begin);
+  EXPECT_EQ(a.width_bin, b.width_bin);
+}
+
+}  // namespace
+
+class SpanMonteCarloTest : public ::testing::Test {
+ protected:
+  SpanMonteCarloTest() {
+    span_ = factory::BuildSagSpan(SagMethod::Type::kStopWatch);
+    span_.cable.correction_creep = 10;
+
+    uncertainty_.deviation_coordinates = 0.5;
+    uncertainty_.deviation_creep = 2;
+    uncertainty_.deviation_tension = 0.02;
+    uncertainty_.deviation_weight = 0.01;
+
+    // uses several blocks, with a partial block at the end
+    monte_carlo_.set_num_samples(1000);
+    monte_carlo_.set_seed(42);
+    monte_carlo_.set_span(&span_);
+    monte_carlo_.set_uncertainty(uncertainty_);
+    monte_carlo_.set_units(units::UnitSystem::kImperial);
+  }
+
+  SpanMonteCarlo monte_carlo_;
+  SagSpan span_;
+  SpanUncertainty uncertainty_;
+};
+
+TEST_F(SpanMonteCarloTest, Run) {
+  ASSERT_TRUE(monte_carlo_.Run(1));
+  const std::vector<SpanMonteCarloResult> results_single =
+      monte_carlo_.results();
+
+  ASSERT_TRUE(monte_carlo_.Run(4));
+  const std::vector<SpanMonteCarloResult>& results = monte_carlo_.results();
+
+  // the blocks are merged in order, so the results do not depend on the
+  // number of threads
+  ASSERT_EQ(5, static_cast<int>(results.size()));
+  ASSERT_EQ(results_single.size(), results.size());
+  for (std::size_t i = 0; i < results.size(); i++) {
+    EXPECT_EQ(results_single[i].num_failures, results[i].num_failures);
+    ExpectEqual(results_single[i].sag, results[i].sag);
+    ExpectEqual(results_single[i].time_stopwatch, results[i].time_stopwatch);
+  }
+
+  // every sample is either accumulated or counted as a failure
+  for (auto iter = results.cbegin(); iter != results.cend(); iter++) {
+    const SpanMonteCarloResult& result = *iter;
+    const SampleDistribution& sag = result.sag;
+    EXPECT_EQ(1000, sag.num_samples + result.num_failures);
+    EXPECT_EQ(0, result.angle_transit.num_samples);
+
+    int num_binned = sag.num_above + sag.num_below;
+    for (auto it = sag.counts.cbegin(); it != sag.counts.cend(); it++) {
+      num_binned += *it;
+    }
+    EXPECT_EQ(sag.num_samples, num_binned);
+    EXPECT_LE(sag.min, sag.mean);
+    EXPECT_LE(sag.mean, sag.max);
+    EXPECT_LT(0, sag.deviation);
+  }
+}
+
+TEST_F(SpanMonteCarloTest, RunCertain) {
+  // the merged moments match the nominal span if the inputs are certain
+  monte_carlo_.set_uncertainty(SpanUncertainty());
+  ASSERT_TRUE(monte_carlo_.Run(3));
+
+  SpanAnalyzer analyzer;
+  analyzer.set_span(&span_);
+  analyzer.set_units(units::UnitSystem::kImperial);
+  const std::vector<SpanMonteCarloResult>& results = monte_carlo_.results();
+  for (auto iter = results.cbegin(); iter != results.cend(); iter++) {
+    const SpanMonteCarloResult& result = *iter;
+    SaggingAnalysisResult result_nominal;
+    ASSERT_TRUE(analyzer.Analyze(&result.temperature, result_nominal));
+
+    const double sag = result_nominal.catenary.Sag();
+    EXPECT_EQ(0, result.num_failures);
+    EXPECT_EQ(1000, result.sag.num_samples);
+    EXPECT_NEAR(sag, result.sag.mean, sag * 1e-12);
+    EXPECT_NEAR(0, result.sag.deviation, sag * 1e-6);
+    EXPECT_EQ(sag, result.sag.min);
+    EXPECT_EQ(sag, result.sag.max);
+  }
+}
+
+TEST_F(SpanMonteCarloTest, RunRejected) {
+  // samples with a creep correction or scale factor that is not valid for
+  // the cable are rejected
+  span_.cable.correction_creep = 0;
+  uncertainty_ = SpanUncertainty();
+  uncertainty_.deviation_creep = 5;
+  uncertainty_.deviation_scale = 0.5;
+  monte_carlo_.set_uncertainty(uncertainty_);
+  ASSERT_TRUE(monte_carlo_.Run(2));
+
+  const std::vector<SpanMonteCarloResult>& results = monte_carlo_.results();
+  for (auto iter = results.cbegin(); iter != results.cend(); iter++) {
+    const SpanMonteCarloResult& result = *iter;
+    EXPECT_LT(400, result.num_failures);
+    EXPECT_LT(0, result.sag.num_samples);
+    EXPECT_EQ(1000, result.sag.num_samples + result.num_failures);
+  }
+}
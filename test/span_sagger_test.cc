@@ -0,0 +1,320 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#include "onsag/span_sagger.h"
+
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "test/factory.h"
+
+namespace {
+
+/// \brief Gets the minimum control factor with a linear scan of the table
+///   points, which is how the table was searched before it was indexed.
+/// \param[in] factor_elevation
+///   The elevation factor.
+/// \return The minimum control factor, or -999999 if the elevation factor is
+///   outside of the table.
+double FactorControlMinScan(const double& factor_elevation) {
+  const std::vector<Point2d<double>> points = {
+      Point2d<double>(0.00, 0.750), Point2d<double>(0.05, 0.750),
+      Point2d<double>(0.10, 0.850), Point2d<double>(0.15, 0.910),
+      Point2d<double>(0.20, 0.940), Point2d<double>(0.25, 0.960),
+      Point2d<double>(0.30, 0.970), Point2d<double>(0.35, 0.980),
+      Point2d<double>(0.40, 0.985), Point2d<double>(0.45, 0.990),
+      Point2d<double>(0.50, 0.992), Point2d<double>(0.55, 0.994),
+      Point2d<double>(0.60, 0.996), Point2d<double>(0.65, 0.997),
+      Point2d<double>(0.70, 0.998), Point2d<double>(0.75, 0.999)};
+
+  // searches for the first point that exceeds the elevation factor
+  const double factor = std::abs(factor_elevation);
+  unsigned int i = 0;
+  while ((i < points.size()) && (points[i].x <= factor)) {
+    i++;
+  }
+
+  if ((i == 0) || (i == points.size())) {
+    return -999999;
+  }
+
+  const Point2d<double>& point_start = points[i - 1];
+  const Point2d<double>& point_end = points[i];
+  return point_start.y + ((factor - point_start.x)
+                          * (point_end.y - point_start.y)
+                          / (point_end.x - point_start.x));
+}
+
+/// \brief Solves a span.
+/// \param[in] span
+///   The span.
+/// \param[in] temperature
+///   The cable temperature.
+/// \return The result, with the sensitivities solved.
+SpanSaggerResult Solve(const SagSpan& span, const double& temperature) {
+  SpanSagger sagger;
+  sagger.set_cable(&span.cable);
+  sagger.set_is_sensitivity_solved(true);
+  sagger.set_method(&span.method);
+  sagger.set_structure_ahead(&span.structure_ahead);
+  sagger.set_structure_back(&span.structure_back);
+  sagger.set_temperature(&temperature);
+  sagger.set_units(units::UnitSystem::kImperial);
+  return sagger.Result();
+}
+
+/// \brief Gets the result values that have sensitivities.
+/// \param[in] result
+///   The result.
+/// \return The transit angle, sag, dynamometer tension, horizontal tension
+///   and stopwatch time.
+std::vector<double> Values(const SpanSaggerResult& result) {
+  return {result.angle_transit, result.sag, result.tension_dyno,
+          result.catenary.tension_horizontal(), result.time_stopwatch};
+}
+
+/// \brief Gets the sensitivity values.
+/// \param[in] sensitivity
+///   The sensitivity.
+/// \return The values in the same order as the result values.
+std::vector<double> Values(const SpanSaggerSensitivity& sensitivity) {
+  return {sensitivity.angle_transit, sensitivity.sag,
+          sensitivity.tension_dyno, sensitivity.tension_horizontal,
+          sensitivity.time_stopwatch};
+}
+
+/// \brief Compares sensitivities to central differences.
+/// \param[in] sensitivity
+///   The solved sensitivity.
+/// \param[in] result_low
+///   The result with the input decreased by the step.
+/// \param[in] result_high
+///   The result with the input increased by the step.
+/// \param[in] step
+///   The input step.
+void CompareSensitivity(const SpanSaggerSensitivity& sensitivity,
+                        const SpanSaggerResult& result_low,
+                        const SpanSaggerResult& result_high,
+                        const double& step) {
+  ASSERT_EQ(SpanSaggerResult::StatusType::kSuccess, result_low.status);
+  ASSERT_EQ(SpanSaggerResult::StatusType::kSuccess, result_high.status);
+
+  const char* names[5] = {"angle_transit", "sag", "tension_dyno",
+                          "tension_horizontal", "time_stopwatch"};
+  const std::vector<double> slopes = Values(sensitivity);
+  const std::vector<double> values_low = Values(result_low);
+  const std::vector<double> values_high = Values(result_high);
+  for (int i = 0; i < 5; i++) {
+    SCOPED_TRACE(names[i]);
+
+    // values that don't apply to the method don't have a sensitivity
+    if (values_low[i] == -999999) {
+      EXPECT_EQ(-999999, slopes[i]);
+      continue;
+    }
+
+    // the tolerance covers the difference truncation and the solver
+    // precision
+    const double slope = (values_high[i] - values_low[i]) / (2 * step);
+    EXPECT_NEAR(slope, slopes[i], 1e-3 * std::abs(slope) + 1e-9);
+  }
+}
+
+}  // namespace
+
+class SpanSaggerTest : public ::testing::Test {
+};
+
+TEST_F(SpanSaggerTest, FactorControlMin) {
+  // compares the indexed table to the linear scan
+  std::vector<double> factors_elevation;
+  for (int i = -800; i <= 800; i++) {
+    factors_elevation.push_back(i * 0.001);
+  }
+
+  for (auto iter = factors_elevation.cbegin();
+       iter != factors_elevation.cend(); iter++) {
+    const double& factor_elevation = *iter;
+    const double factor_scan = FactorControlMinScan(factor_elevation);
+    const double factor = SpanSagger::FactorControlMin(factor_elevation);
+    if (factor_scan == -999999) {
+      EXPECT_EQ(-999999, factor) << factor_elevation;
+    } else {
+      EXPECT_NEAR(factor_scan, factor, 1e-12) << factor_elevation;
+    }
+  }
+
+  // checks the table points and ends
+  EXPECT_DOUBLE_EQ(0.750, SpanSagger::FactorControlMin(0));
+  EXPECT_DOUBLE_EQ(0.850, SpanSagger::FactorControlMin(0.10));
+  EXPECT_DOUBLE_EQ(0.998, SpanSagger::FactorControlMin(-0.70));
+  EXPECT_EQ(-999999, SpanSagger::FactorControlMin(0.75));
+  EXPECT_EQ(-999999, SpanSagger::FactorControlMin(
+      std::numeric_limits<double>::quiet_NaN()));
+  EXPECT_EQ(-999999, SpanSagger::FactorControlMin(
+      std::numeric_limits<double>::infinity()));
+
+  // checks the array lookup
+  std::vector<double> factors_control_min(factors_elevation.size());
+  SpanSagger::FactorsControlMin(factors_elevation.size(),
+                                factors_elevation.data(),
+                                factors_control_min.data());
+  for (std::size_t i = 0; i < factors_elevation.size(); i++) {
+    EXPECT_EQ(SpanSagger::FactorControlMin(factors_elevation[i]),
+              factors_control_min[i]);
+  }
+}
+
+TEST_F(SpanSaggerTest, SagTable) {
+  // builds a table with a span for each method, with a sag correction so
+  // the warm start is used
+  std::vector<SagSpan> spans;
+  spans.push_back(factory::BuildSagSpan(SagMethod::Type::kDynamometer));
+  spans.push_back(factory::BuildSagSpan(SagMethod::Type::kStopWatch));
+  spans.push_back(factory::BuildSagSpan(SagMethod::Type::kTransit));
+  spans[0].method.end = SagMethod::SpanEndType::kBackOnLine;
+  spans[1].cable.correction_sag = 2;
+
+  SpanSaggerInputTable inputs;
+  for (auto iter = spans.cbegin(); iter != spans.cend(); iter++) {
+    const SagSpan& span = *iter;
+    inputs.cables.push_back(&span.cable);
+    inputs.methods.push_back(&span.method);
+    inputs.structures_ahead.push_back(&span.structure_ahead);
+    inputs.structures_back.push_back(&span.structure_back);
+  }
+
+  // includes a temperature that can't be solved
+  const std::vector<double> temperatures = {0, 30, 45, 60, 90, 120, 130};
+  SpanSaggerResultTable results;
+  EXPECT_EQ(3, SpanSagger::SagTable(inputs, temperatures,
+                                    units::UnitSystem::kImperial, true, 0,
+                                    results));
+  ASSERT_EQ(3, results.num_spans);
+  ASSERT_EQ(7, results.num_temperatures);
+
+  // compares every entry to a single span solve
+  SpanSagger sagger;
+  sagger.set_is_sensitivity_solved(true);
+  sagger.set_units(units::UnitSystem::kImperial);
+  for (int i = 0; i < 3; i++) {
+    const SagSpan& span = spans[i];
+    sagger.set_cable(&span.cable);
+    sagger.set_method(&span.method);
+    sagger.set_structure_ahead(&span.structure_ahead);
+    sagger.set_structure_back(&span.structure_back);
+
+    for (int j = 0; j < 7; j++) {
+      sagger.set_temperature(&temperatures[j]);
+      const SpanSaggerResult result = sagger.Result();
+      const int index = results.Index(i, j);
+      if (result.status != SpanSaggerResult::StatusType::kSuccess) {
+        EXPECT_FALSE(results.is_solved[index]);
+        continue;
+      }
+
+      ASSERT_TRUE(results.is_solved[index]);
+      const double tension = result.catenary.tension_horizontal();
+      EXPECT_NEAR(tension, results.tensions_horizontal[index],
+                  tension * 1e-8);
+      EXPECT_NEAR(result.sag, results.sags[index], 1e-6);
+      EXPECT_NEAR(result.length, results.lengths[index], 1e-6);
+      EXPECT_NEAR(result.catenary.Sag(), result.sag, 1e-9);
+      EXPECT_NEAR(result.catenary.Length(), result.length, 1e-9);
+      EXPECT_NEAR(result.angle_transit, results.angles_transit[index], 1e-6);
+      EXPECT_NEAR(result.distance_target, results.distances_target[index],
+                  1e-6);
+      EXPECT_NEAR(result.factor_control, results.factors_control[index],
+                  1e-6);
+      EXPECT_NEAR(result.tension_dyno, results.tensions_dyno[index],
+                  tension * 1e-8);
+      EXPECT_NEAR(result.tension_dyno_back,
+                  results.tensions_dyno_back[index], tension * 1e-8);
+      EXPECT_NEAR(result.tension_dyno_ahead,
+                  results.tensions_dyno_ahead[index], tension * 1e-8);
+      EXPECT_NEAR(result.time_stopwatch, results.times_stopwatch[index],
+                  1e-6);
+      EXPECT_NEAR(result.sensitivity_temperature.sag,
+                  results.sensitivities_temperature[index].sag, 1e-6);
+
+      const int kSizeTimesReturn = result.times_return.size();
+      for (int k = 0; k < kSizeTimesReturn; k++) {
+        EXPECT_NEAR(result.times_return[k],
+                    results.times_return[
+                        (index * SpanSaggerResult::kNumWavesReturn) + k],
+                    1e-6);
+      }
+    }
+  }
+
+  // checks that the method values are only filled for the span method
+  EXPECT_NE(-999999, results.tensions_dyno[results.Index(0, 3)]);
+  EXPECT_EQ(-999999, results.tensions_dyno[results.Index(1, 3)]);
+  EXPECT_NE(-999999, results.times_stopwatch[results.Index(1, 3)]);
+  EXPECT_NE(-999999, results.angles_transit[results.Index(2, 3)]);
+  EXPECT_FALSE(results.is_solved[results.Index(0, 6)]);
+}
+
+TEST_F(SpanSaggerTest, Sensitivities) {
+  // covers each method, with and without a sag correction, at temperatures
+  // inside of the tension curve segments
+  const SagMethod::Type types[3] = {SagMethod::Type::kDynamometer,
+                                    SagMethod::Type::kStopWatch,
+                                    SagMethod::Type::kTransit};
+  const double corrections_sag[2] = {0, 2};
+  const double temperatures[3] = {15, 45, 75};
+
+  const double kStepTemperature = 0.01;
+  const double kStepCreep = 0.01;
+  for (int i = 0; i < 3; i++) {
+    for (int j = 0; j < 2; j++) {
+      SagSpan span = factory::BuildSagSpan(types[i]);
+      span.cable.correction_creep = 5;
+      span.cable.correction_sag = corrections_sag[j];
+      const double step_weight = span.cable.weight_unit * 1e-4;
+
+      for (int k = 0; k < 3; k++) {
+        const double& temperature = temperatures[k];
+        SCOPED_TRACE(testing::Message() << "method: " << i
+                     << ", correction: " << corrections_sag[j]
+                     << ", temperature: " << temperature);
+
+        const SpanSaggerResult result = Solve(span, temperature);
+        ASSERT_EQ(SpanSaggerResult::StatusType::kSuccess, result.status);
+
+        {
+          SCOPED_TRACE("temperature");
+          CompareSensitivity(result.sensitivity_temperature,
+                             Solve(span, temperature - kStepTemperature),
+                             Solve(span, temperature + kStepTemperature),
+                             kStepTemperature);
+        }
+
+        {
+          SCOPED_TRACE("creep");
+          SagSpan span_low = span;
+          SagSpan span_high = span;
+          span_low.cable.correction_creep -= kStepCreep;
+          span_high.cable.correction_creep += kStepCreep;
+          CompareSensitivity(result.sensitivity_creep,
+                             Solve(span_low, temperature),
+                             Solve(span_high, temperature), kStepCreep);
+        }
+
+        {
+          SCOPED_TRACE("weight");
+          SagSpan span_low = span;
+          SagSpan span_high = span;
+          span_low.cable.weight_unit -= step_weight;
+          span_high.cable.weight_unit += step_weight;
+          CompareSensitivity(result.sensitivity_weight,
+                             Solve(span_low, temperature),
+                             Solve(span_high, temperature), step_weight);
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,64 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#include "onsag/tension_curve.h"
+
+#include "gtest/gtest.h"
+
+#include "test/factory.h"
+
+class TensionCurveTest : public ::testing::Test {
+ protected:
+  TensionCurveTest() {
+    cable_ = factory::BuildSagCable();
+    curve_.set_cable(&cable_);
+  }
+
+  SagCable cable_;
+  TensionCurve curve_;
+};
+
+TEST_F(TensionCurveTest, SlopeTensionHorizontal) {
+  // checks the analytic slope against a central difference
+  const double kStep = 1e-4;
+  for (double temperature = 1; temperature < 120; temperature += 7) {
+    const double slope = (curve_.TensionHorizontal(temperature + kStep)
+                          - curve_.TensionHorizontal(temperature - kStep))
+                         / (2 * kStep);
+    EXPECT_NEAR(slope, curve_.SlopeTensionHorizontal(temperature), 1e-4);
+  }
+
+  EXPECT_EQ(-999999, curve_.SlopeTensionHorizontal(-1));
+  EXPECT_EQ(-999999, curve_.SlopeTensionHorizontal(121));
+}
+
+TEST_F(TensionCurveTest, TensionHorizontal) {
+  // the spline passes through every tension point
+  for (auto iter = cable_.tensions.cbegin(); iter != cable_.tensions.cend();
+       iter++) {
+    const SagCable::TensionPoint& point = *iter;
+    EXPECT_NEAR(point.tension_horizontal,
+                curve_.TensionHorizontal(point.temperature), 1e-9);
+  }
+
+  // the tension never increases with temperature
+  double tension_prev = curve_.TensionHorizontal(0);
+  for (double temperature = 0.5; temperature <= 120; temperature += 0.5) {
+    const double tension = curve_.TensionHorizontal(temperature);
+    EXPECT_LE(tension, tension_prev) << temperature;
+    tension_prev = tension;
+  }
+
+  // temperatures outside of the tension points are not extrapolated
+  EXPECT_EQ(-999999, curve_.TensionHorizontal(-1));
+  EXPECT_EQ(-999999, curve_.TensionHorizontal(121));
+}
+
+TEST_F(TensionCurveTest, Validate) {
+  EXPECT_TRUE(curve_.Validate(false, nullptr));
+
+  // a cable with a single tension point can't be fitted
+  cable_.tensions.resize(1);
+  curve_.set_cable(&cable_);
+  EXPECT_FALSE(curve_.Validate(false, nullptr));
+}
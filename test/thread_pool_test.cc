@@ -0,0 +1,69 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#include "onsag/thread_pool.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+class ThreadPoolTest : public ::testing::Test {
+ protected:
+  ThreadPoolTest() : pool_(2) {
+  }
+
+  ThreadPool pool_;
+};
+
+TEST_F(ThreadPoolTest, AddTask) {
+  ASSERT_EQ(2, pool_.size());
+
+  // runs tasks and checks the worker indexes
+  std::atomic<int> num_run(0);
+  std::atomic<int> num_index_invalid(0);
+  for (int i = 0; i < 100; i++) {
+    pool_.AddTask([&](const int& index_worker) {
+      if ((index_worker < 0) || (pool_.size() <= index_worker)) {
+        num_index_invalid++;
+      }
+      num_run++;
+    });
+  }
+  pool_.Wait();
+
+  EXPECT_EQ(100, num_run);
+  EXPECT_EQ(0, num_index_invalid);
+}
+
+TEST_F(ThreadPoolTest, StealTask) {
+  // a task adds tasks to its own worker queue, and then blocks until they
+  // are completed, so the tasks can only run if the other worker steals them
+  const int kNumTasks = 10;
+  std::atomic<int> num_run(0);
+  std::atomic<bool> is_stolen(false);
+  pool_.AddTask([&](const int& index_worker) {
+    for (int i = 0; i < kNumTasks; i++) {
+      pool_.AddTask([&, index_worker](const int& index_worker_task) {
+        if (index_worker_task != index_worker) {
+          num_run++;
+        }
+      });
+    }
+
+    // waits with a deadline so a failure doesn't hang the test
+    const auto deadline = std::chrono::steady_clock::now()
+                          + std::chrono::seconds(10);
+    while ((num_run < kNumTasks)
+           && (std::chrono::steady_clock::now() < deadline)) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    is_stolen = num_run == kNumTasks;
+  });
+  pool_.Wait();
+
+  EXPECT_TRUE(is_stolen);
+  EXPECT_EQ(kNumTasks, num_run);
+}
@@ -0,0 +1,90 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#include "onsag/transit_optimizer.h"
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "test/factory.h"
+
+class TransitOptimizerTest : public ::testing::Test {
+ protected:
+  TransitOptimizerTest() {
+    span_ = factory::BuildSagSpan(SagMethod::Type::kTransit);
+
+    // gets the sag at the highest sweep temperature
+    const double temperature = 70;
+    SpanAnalyzer analyzer;
+    analyzer.set_span(&span_);
+    analyzer.set_units(units::UnitSystem::kImperial);
+    SaggingAnalysisResult result;
+    analyzer.Analyze(&temperature, result);
+    sag_ = result.catenary.Sag();
+
+    optimizer_.set_span(&span_);
+    optimizer_.set_sweep(TemperatureSweep());
+  }
+
+  TransitOptimizer optimizer_;
+  double sag_;
+  SagSpan span_;
+};
+
+TEST_F(TransitOptimizerTest, Optimize) {
+  // searches a vertical line below the back attachment point
+  const Point2d<double>& point_back = span_.structure_back.point_attachment;
+  optimizer_.set_num_points_x(1);
+  optimizer_.set_num_points_y(21);
+  optimizer_.set_point_min(
+      Point2d<double>(point_back.x, point_back.y - (2 * sag_)));
+  optimizer_.set_point_max(point_back);
+  ASSERT_TRUE(optimizer_.Optimize(2));
+  ASSERT_EQ(21, static_cast<int>(optimizer_.candidates().size()));
+
+  // the best location is roughly one sag below the attachment point, where
+  // the line of sight is close to tangent at midspan
+  const TransitCandidate* candidate = optimizer_.CandidateBest();
+  ASSERT_NE(nullptr, candidate);
+  EXPECT_TRUE(candidate->is_feasible);
+  EXPECT_LT(0, candidate->margin_control);
+  EXPECT_NEAR(point_back.y - sag_, candidate->point_transit.y, sag_ / 5);
+  EXPECT_LE(candidate->angle_min, candidate->angle_max);
+
+  // the best candidate has the largest margin of the feasible candidates
+  const std::vector<TransitCandidate>& candidates = optimizer_.candidates();
+  for (auto iter = candidates.cbegin(); iter != candidates.cend(); iter++) {
+    if (iter->is_feasible == true) {
+      EXPECT_LE(iter->margin_control, candidate->margin_control);
+    }
+  }
+
+  // locations near the attachment point are flagged as infeasible
+  const TransitCandidate& candidate_high = candidates[19];
+  EXPECT_FALSE(candidate_high.is_feasible);
+  EXPECT_LT(candidate_high.margin_control, 0);
+  EXPECT_FALSE(candidates.back().is_feasible);
+}
+
+TEST_F(TransitOptimizerTest, OptimizeInfeasible) {
+  // searches a region close to the attachment point, where the control
+  // factor is never acceptable
+  const Point2d<double>& point_back = span_.structure_back.point_attachment;
+  optimizer_.set_num_points_x(3);
+  optimizer_.set_num_points_y(3);
+  optimizer_.set_point_min(
+      Point2d<double>(point_back.x - 10, point_back.y - (sag_ / 10)));
+  optimizer_.set_point_max(point_back);
+  ASSERT_TRUE(optimizer_.Optimize(1));
+  EXPECT_EQ(nullptr, optimizer_.CandidateBest());
+  for (auto iter = optimizer_.candidates().cbegin();
+       iter != optimizer_.candidates().cend(); iter++) {
+    EXPECT_FALSE(iter->is_feasible);
+  }
+
+  // fails for an invalid region
+  optimizer_.set_point_min(Point2d<double>(point_back.x + 1, point_back.y));
+  EXPECT_FALSE(optimizer_.Optimize(1));
+  EXPECT_TRUE(optimizer_.candidates().empty());
+}